@@ -1,6 +1,6 @@
 #include "AssimpRoadModel.h"
 
-#include <assimp/cimport.h>
+#include <assimp/Importer.hpp>
 #include <assimp/scene.h>
 #include <assimp/postprocess.h>
 #include <assimp/material.h>
@@ -10,13 +10,23 @@
 namespace sess
 {
 
-std::shared_ptr<AssimpRoadModel> AssimpRoadModel::LoadFromFile(const char * fName, ComPtr<ID3D11Device> d3dDevice, const Transform & transform)
+std::shared_ptr<AssimpRoadModel> AssimpRoadModel::LoadFromFile(const AssetPack& assets, const char* fName, ComPtr<ID3D11Device> d3dDevice, const Transform& transform, const ImportProfile& profile)
 {
-	const aiScene* scene = aiImportFile(fName, aiProcessPreset_TargetRealtime_MaxQuality);
+	// Straight out of the asset pack (or the loose file, if there's no pack) - Assimp only
+	//  ever sees the bytes
+	AssetData source;
+	if (!assets.Load(fName, source))
+	{
+		std::cerr << "Could not load file " << fName << std::endl;
+		return nullptr;
+	}
+
+	Assimp::Importer importer;
+	const aiScene* scene = profile.Import(importer, source, fName);
 
 	if (!scene)
 	{
-		std::cerr << "Could not load file " << fName << std::endl;
+		std::cerr << "Could not load file " << fName << ": " << importer.GetErrorString() << std::endl;
 		return nullptr;
 	}
 
@@ -87,7 +97,7 @@ bool AssimpRoadModel::Update(float dt)
 
 bool AssimpRoadModel::Render(ComPtr<ID3D11DeviceContext> context, MaterialOnlyShader* shader) const
 {
-	shader->SetModelTransform(transform_.GetTransformMatrix());
+	shader->SetModelTransform(transform_.GetAffineMatrix());
 
 	for (auto&& mesh : meshes_)
 	{
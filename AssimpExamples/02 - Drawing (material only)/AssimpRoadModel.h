@@ -1,5 +1,7 @@
 #pragma once
 
+#include <AssetPack.h>
+#include <ImportProfile.h>
 #include <Transform.h>
 #include <vector>
 #include <memory>
@@ -22,7 +24,8 @@ public:
 	
 	AssimpRoadModel(const std::vector<Mesh>& meshes, const Transform& transform);
 
-	static std::shared_ptr<AssimpRoadModel> LoadFromFile(const char* fName, ComPtr<ID3D11Device> d3dDevice, const Transform& transform);
+	static std::shared_ptr<AssimpRoadModel> LoadFromFile(const AssetPack& assets, const char* fName, ComPtr<ID3D11Device> d3dDevice, const Transform& transform,
+		const ImportProfile& profile = ImportProfile::OfflineMax);
 	bool Update(float dt);
 	bool Render(ComPtr<ID3D11DeviceContext> context, MaterialOnlyShader* shader) const;
 
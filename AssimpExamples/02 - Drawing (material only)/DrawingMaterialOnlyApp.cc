@@ -8,6 +8,7 @@ namespace sess
 
 DrawingMaterialOnlyApp::DrawingMaterialOnlyApp(HINSTANCE appHandle)
 	: DemoApp(appHandle, L"Demo - Drawing with Materials Only")
+	, assets_()
 	, shader_()
 	, camera_(Vec3(0.f, 2.f, 0.f), Vec3(0.f, 2.f, 1.f), Vec3::UnitY)
 	, projMatrix_(PerspectiveLH(Radians(85.f), (windowSize_.right - windowSize_.left) / (float)(windowSize_.bottom - windowSize_.top), 0.1f, 100.f))
@@ -24,7 +25,14 @@ DrawingMaterialOnlyApp::~DrawingMaterialOnlyApp()
 //
 bool DrawingMaterialOnlyApp::InitializeApp()
 {
-	std::future<bool> shaderLoaded = shader_.Initialize(device_);
+	// One open and one map for everything. Missing is fine - the loose files still work,
+	//  it's just slower (run "make pack" in the packer folder to build it).
+	if (!assets_.Open("../assets.pack"))
+	{
+		std::cout << "No asset pack, loading loose files" << std::endl;
+	}
+
+	std::future<bool> shaderLoaded = shader_.Initialize(device_, assets_);
 
 	debugIcosphere_ = std::make_shared<DebugMaterialIcosphere>
 	(
@@ -36,7 +44,7 @@ bool DrawingMaterialOnlyApp::InitializeApp()
 	);
 
 	Transform roadTransform(Vec3::Zero, Quaternion(Vec3::UnitY, Radians(-90.f)) * Quaternion(Vec3::UnitX, Radians(-90.f)), Vec3::Ones);
-	roadModel_ = AssimpRoadModel::LoadFromFile("../assets/road.fbx", device_, roadTransform);
+	roadModel_ = AssimpRoadModel::LoadFromFile(assets_, "../assets/road.fbx", device_, roadTransform);
 	if (!roadModel_)
 	{
 		std::cerr << "Failed to load road model, failing initialization" << std::endl;
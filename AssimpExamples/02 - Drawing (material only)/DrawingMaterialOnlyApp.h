@@ -25,6 +25,9 @@ protected:
 	virtual LRESULT CALLBACK HandleWin32Message(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam);
 
 private:
+	// Models, textures and shaders all come out of here (see AssetPack.h)
+	AssetPack assets_;
+
 	MaterialOnlyShader shader_;
 	FreeCamera camera_;
 
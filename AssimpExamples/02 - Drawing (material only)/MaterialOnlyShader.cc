@@ -1,7 +1,6 @@
 #include "MaterialOnlyShader.h"
 
 #include <iostream>
-#include <fstream>
 
 namespace sess
 {
@@ -9,6 +8,7 @@ namespace sess
 MaterialOnlyShader::RenderCall::RenderCall(ComPtr<ID3D11Device> device, const std::vector<MaterialOnlyShader::Vertex>& vertices, const std::vector<std::uint32_t>& indices)
 	: VertexBuffer(nullptr)
 	, IndexBuffer(nullptr)
+	, IndexFormat(DXGI_FORMAT_R32_UINT)
 	, NumberOfIndices(0u)
 {
 	HRESULT hr = {};
@@ -34,16 +34,29 @@ MaterialOnlyShader::RenderCall::RenderCall(ComPtr<ID3D11Device> device, const st
 		return;
 	}
 
+	// Half the size if every vertex can be reached with 16 bits. The narrowed copy only has
+	//  to live until CreateBuffer is done with it.
+	std::vector<std::uint16_t> shortIndices;
+	std::size_t indexSize = sizeof(std::uint32_t);
+	const void* indexSource = &indices[0];
+	if (FitsShortIndices(vertices.size()))
+	{
+		NarrowIndices(indices, shortIndices);
+		IndexFormat = DXGI_FORMAT_R16_UINT;
+		indexSize = sizeof(std::uint16_t);
+		indexSource = &shortIndices[0];
+	}
+
 	D3D11_BUFFER_DESC ibDesc = {};
 	ibDesc.BindFlags = D3D11_BIND_INDEX_BUFFER;
 	ibDesc.CPUAccessFlags = 0x00;
 	ibDesc.MiscFlags = 0x00;
-	ibDesc.ByteWidth = sizeof(std::uint32_t) * (UINT)indices.size();
+	ibDesc.ByteWidth = (UINT)(indexSize * indices.size());
 	ibDesc.Usage = D3D11_USAGE_IMMUTABLE;
 	ibDesc.StructureByteStride = 0x00;
 
 	D3D11_SUBRESOURCE_DATA indexData = {};
-	indexData.pSysMem = &indices[0];
+	indexData.pSysMem = indexSource;
 
 	hr = device->CreateBuffer(&ibDesc, &indexData, &IndexBuffer);
 
@@ -59,7 +72,7 @@ MaterialOnlyShader::MaterialOnlyShader()
 	, psc_object_(nullptr)
 	, psc_frame_(nullptr)
 	, psc_scene_(nullptr)
-	, DVSC_PerObject({ { Matrix::Identity }, true })
+	, DVSC_PerObject({ { Affine3x4::Identity }, true })
 	, DVSC_PerFrame({ { Matrix::Identity, Matrix::Identity }, true })
 	, DPSC_PerFrame({ { Vec3::Zero }, true })
 	, DPSC_PerObject({ { { Color::Palette::Black, Color::Palette::Black, Color::Palette::Black } }, true })
@@ -72,7 +85,7 @@ MaterialOnlyShader::MaterialOnlyShader()
 // Truthfully, I don't care that much, but I'm pulling a lot of this code from demo code, and this
 //  is how I wrote the demo code. Again, this isn't the subject of this tutorial ;-)
 // Also, I'm using std::cerr, which by itself is not thread safe. Message interleaving is possible.
-std::future<bool> MaterialOnlyShader::Initialize(ComPtr<ID3D11Device> device)
+std::future<bool> MaterialOnlyShader::Initialize(ComPtr<ID3D11Device> device, const AssetPack& assets)
 {
 	// Async/await pattern in C++. I love it. Pass a function as the second parameter and specify
 	//  async (as opposed to deferred) for the first, and it returns a std::future.
@@ -80,7 +93,7 @@ std::future<bool> MaterialOnlyShader::Initialize(ComPtr<ID3D11Device> device)
 	// When the .get() method is called on the future returned, the calling thread will
 	//  block until the function provided finishes, and return the result.
 	// Fantastic pattern, totally unnecessary here.
-	return std::async(std::launch::async, [this, device] () -> bool {
+	return std::async(std::launch::async, [this, device, &assets] () -> bool {
 		const char* vsFname = "../cso/MaterialOnlyShader.vs.cso";
 		const char* psFname = "../cso/MaterialOnlyShader.ps.cso";
 
@@ -98,39 +111,33 @@ std::future<bool> MaterialOnlyShader::Initialize(ComPtr<ID3D11Device> device)
 
 		// Using asynchronous programming to get the vertex and pixel bytecode from the file.
 		//  Other things can happen while this is happening, so don't join until the data is needed
-		std::future<std::vector<char>> vsData = std::async(std::launch::async, [this, &vsDataLength, vsFname] {
+		std::future<std::vector<char>> vsData = std::async(std::launch::async, [&assets, &vsDataLength, vsFname] {
 			std::vector<char> vsBytecode(0u);
-			std::ifstream vin(vsFname, std::ios::binary);
-			if (!vin)
+			AssetData vsFile;
+			if (!assets.Load(vsFname, vsFile))
 			{
 				std::cerr << "Failed to open vertex shader file for reading." << std::endl;
 				return vsBytecode;
 			}
 
-			vin.seekg(0, std::ios::end);
-			vsDataLength = (std::uint32_t)vin.tellg();
-			vin.seekg(0, std::ios::beg);
-			vsBytecode.resize(vsDataLength);
-			vin.read(&vsBytecode[0], vsDataLength);
+			vsDataLength = (std::uint32_t)vsFile.GetSize();
+			vsBytecode.assign(vsFile.GetData(), vsFile.GetData() + vsDataLength);
 
 			return vsBytecode;
 		});
 
-		std::future<std::vector<char>> psData = std::async(std::launch::async, [this, &psDataLength, psFname] {
+		std::future<std::vector<char>> psData = std::async(std::launch::async, [&assets, &psDataLength, psFname] {
 			std::vector<char> psBytecode(0u);
 
-			std::ifstream pin(psFname, std::ios::binary);
-			if (!pin)
+			AssetData psFile;
+			if (!assets.Load(psFname, psFile))
 			{
 				std::cerr << "Failed to open pixel shader file for reading." << std::endl;
 				return psBytecode;
 			}
 
-			pin.seekg(0, std::ios::end);
-			psDataLength = (std::uint32_t)pin.tellg();
-			pin.seekg(0, std::ios::beg);
-			psBytecode.resize(psDataLength);
-			pin.read(&psBytecode[0], psDataLength);
+			psDataLength = (std::uint32_t)psFile.GetSize();
+			psBytecode.assign(psFile.GetData(), psFile.GetData() + psDataLength);
 
 			return psBytecode;
 		});
@@ -338,7 +345,7 @@ bool MaterialOnlyShader::Render(ComPtr<ID3D11DeviceContext> context, const Rende
 	// Set the index buffer as input to the graphics pipeline. Specify that we're using 32 bit unsigned integers
 	//  DXGI is weird about formats, R32 means "one component, having 32 bits". The "R" stands for "red"
 	//  A set of three values, 32 bit uints each, would be DXGI_FORMAT_R32G32B32_UINT, for example.
-	context->IASetIndexBuffer(call.IndexBuffer.Get(), DXGI_FORMAT_R32_UINT, 0u);
+	context->IASetIndexBuffer(call.IndexBuffer.Get(), call.IndexFormat, 0u);
 
 	// We're drawing triangles...
 	context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
@@ -349,7 +356,7 @@ bool MaterialOnlyShader::Render(ComPtr<ID3D11DeviceContext> context, const Rende
 	return true;
 }
 
-void MaterialOnlyShader::SetModelTransform(const Matrix& modelTransformation)
+void MaterialOnlyShader::SetModelTransform(const Affine3x4& modelTransformation)
 {
 	DVSC_PerObject.VSC_PerObject.Model = modelTransformation;
 	DVSC_PerObject.isDirty = true;
@@ -22,6 +22,9 @@
 #include <wrl.h>
 #include <future>
 #include <vector>
+#include <Affine3x4.h>
+#include <AssetPack.h>
+#include <IndexFormat.h>
 #include <MathExtras.h>
 
 using Microsoft::WRL::ComPtr;
@@ -85,7 +88,7 @@ public:
 	//  must be called. The render call itself has no notion of any of these things.
 	// That also helps in optimizations - DX11/GL/VK all have optimizations that can be
 	//  applied by using this sort of pattern. Different optimizations, but optimizations.
-	void SetModelTransform(const Matrix& modelTransform);
+	void SetModelTransform(const Affine3x4& modelTransform);
 	void SetViewTransform(const Matrix& viewTransform);
 	void SetProjectionTransform(const Matrix& projTransform);
 	void SetObjectMaterial(const Material& objectMaterial);
@@ -108,6 +111,7 @@ public:
 		//  too darn good to forego
 		ComPtr<ID3D11Buffer> VertexBuffer;
 		ComPtr<ID3D11Buffer> IndexBuffer;
+		DXGI_FORMAT IndexFormat; // 16-bit whenever the vertex count allows it (see IndexFormat.h)
 		std::uint32_t NumberOfIndices;
 	};
 
@@ -117,7 +121,8 @@ public:
 	MaterialOnlyShader(const MaterialOnlyShader&) = delete;
 	~MaterialOnlyShader() = default;
 
-	std::future<bool> Initialize(ComPtr<ID3D11Device> device);
+	// Compiled shaders come out of assets - the pack, or the loose files in cso/
+	std::future<bool> Initialize(ComPtr<ID3D11Device> device, const AssetPack& assets);
 
 	bool Render(ComPtr<ID3D11DeviceContext> context, const RenderCall& call);
 
@@ -151,7 +156,7 @@ protected:
 	{
 		struct VSC_PerObject_Type
 		{
-			Matrix Model;
+			Affine3x4 Model; // 48 bytes, not 64 - the 0 0 0 1 row is added back in the shader
 		} VSC_PerObject;
 		bool isDirty;
 	} DVSC_PerObject;
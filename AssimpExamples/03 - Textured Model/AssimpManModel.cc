@@ -2,34 +2,104 @@
 
 #include <lodepng.h>
 
-#include <assimp/cimport.h>
-#include <assimp/scene.h>
-#include <assimp/postprocess.h>
-#include <assimp/material.h>
+#include <ModelLoader.h>
+#include <VertexQuantization.h>
 
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 
 namespace sess
 {
 
-std::shared_ptr<AssimpManModel> AssimpManModel::LoadFromFile(const char* fName, const char* textureFilename, ComPtr<ID3D11Device> d3dDevice, ComPtr<ID3D11DeviceContext> d3dDeviceContext, const Transform& transform)
+std::future<AssimpManModel::CpuData> AssimpManModel::LoadAsync(const AssetPack& assets, const char* fName, const char* textureFilename, const ImportProfile& profile)
 {
-	const aiScene* scene = aiImportFile(fName, aiProcessPreset_TargetRealtime_MaxQuality);
+	// The names and profile are copied - the caller's might be gone by the time this runs
+	return std::async(std::launch::async, [&assets, name = std::string(fName), textureName = std::string(textureFilename), profile] {
+		return LoadCpuData(assets, name.c_str(), textureName.c_str(), profile);
+	});
+}
 
-	if (!scene)
+std::shared_ptr<AssimpManModel> AssimpManModel::Upload(const CpuData& data, ComPtr<ID3D11Device> d3dDevice, ComPtr<ID3D11DeviceContext> d3dDeviceContext, const Transform& transform)
+{
+	if (!data.Loaded)
 	{
-		std::cerr << "Could not load file " << fName << std::endl;
 		return nullptr;
 	}
 
+	TexturedShader::Texture manTexture(d3dDevice, d3dDeviceContext, data.TexturePixels, data.TextureWidth, data.TextureHeight);
+
+	std::vector<Mesh> meshes;
+	meshes.reserve(data.Meshes.size());
+	for (auto&& cooked : data.Meshes)
+	{
+		TexturedShader::RenderCall call(d3dDevice, cooked.Vertices, cooked.Indices);
+		TexturedShader::Material meshMaterial(cooked.Material.Specular, cooked.Material.Diffuse, cooked.Material.Ambient);
+		// Same cube ModelLoader quantized the positions in - it comes straight from the bounds
+		Affine3x4 dequantize = PositionQuantization::FromBox(cooked.LocalBounds.Box).ToAffine();
+		meshes.push_back({ call, meshMaterial, cooked.LocalBounds, cooked.Lods, dequantize });
+	}
+
+	return std::make_shared<AssimpManModel>(meshes, transform, manTexture);
+}
+
+std::shared_ptr<AssimpManModel> AssimpManModel::LoadFromFile(const AssetPack& assets, const char* fName, const char* textureFilename, ComPtr<ID3D11Device> d3dDevice, ComPtr<ID3D11DeviceContext> d3dDeviceContext, const Transform& transform, const ImportProfile& profile)
+{
+	return Upload(LoadCpuData(assets, fName, textureFilename, profile), d3dDevice, d3dDeviceContext, transform);
+}
+
+AssimpManModel::CpuData AssimpManModel::LoadCpuData(const AssetPack& assets, const char* fName, const char* textureFilename, const ImportProfile& profile)
+{
+	CpuData data = { false };
+
+	// The PNG has nothing to do with the mesh, so it gets decoded on a thread of its own
+	//  while the mesh is being imported. Its pixels are moved over once both are done.
+	std::future<CpuData> texture = std::async(std::launch::async, [&assets, textureFilename] {
+		CpuData textureData = { false };
+		textureData.Loaded = DecodeTexture(assets, textureFilename, textureData);
+		return textureData;
+	});
+
+	// 16 byte vertices instead of 40 - the man is the model with the most vertices by far
+	bool meshesLoaded = ModelLoader<TexturedShader::CompactVertex>::Load(assets, fName, profile, data.Meshes);
+
+	// Waited on either way - textureFilename has to outlive the texture thread
+	CpuData textureData = texture.get();
+	if (!meshesLoaded || !textureData.Loaded)
+	{
+		return data;
+	}
+
+	data.TexturePixels = std::move(textureData.TexturePixels);
+	data.TextureWidth = textureData.TextureWidth;
+	data.TextureHeight = textureData.TextureHeight;
+	data.Loaded = true;
+	return data;
+}
+
+bool AssimpManModel::DecodeTexture(const AssetPack& assets, const char* textureFilename, CpuData& data)
+{
 	//
 	// Load image with LodePNG
 	//
-	std::vector<unsigned char> textureData; // Raw pixel data
-	std::uint32_t imageWidth, imageHeight; // Image metadata
+	std::vector<unsigned char>& textureData = data.TexturePixels; // Raw pixel data
+	std::uint32_t& imageWidth = data.TextureWidth; // Image metadata
+	std::uint32_t& imageHeight = data.TextureHeight;
 
-	// Decode image with LodePNG
-	std::uint32_t decodeError = lodepng::decode(textureData, imageWidth, imageHeight, textureFilename);
+	AssetData textureFile;
+	if (!assets.Load(textureFilename, textureFile))
+	{
+		std::cerr << "Could not load texture " << textureFilename << std::endl;
+		return false;
+	}
+
+	// Decode image with LodePNG - from memory, it's already been pulled out of the pack
+	std::uint32_t decodeError = lodepng::decode(textureData, imageWidth, imageHeight, textureFile.GetData(), textureFile.GetSize());
+	if (decodeError != 0u)
+	{
+		std::cerr << "Could not decode texture " << textureFilename << ": " << lodepng_error_text(decodeError) << std::endl;
+		return false;
+	}
 
 	// Flip all values on Y
 	for (int row = 0; row < imageHeight / 2u; row++)
@@ -51,84 +121,53 @@ std::shared_ptr<AssimpManModel> AssimpManModel::LoadFromFile(const char* fName,
 	// ... Done loading image. Lode Vandevenne, you're AWESOME dude
 	//
 
-	TexturedShader::Texture manTexture(d3dDevice, d3dDeviceContext, textureData, imageWidth, imageHeight);
-
-	// Load all meshes and whatnot
-	std::vector<Mesh> meshes;
-	meshes.reserve(scene->mNumMeshes);
-	for (std::uint32_t meshIdx = 0u; meshIdx < scene->mNumMeshes; meshIdx++)
-	{
-		aiMesh* mesh = scene->mMeshes[meshIdx];
-
-		std::vector<TexturedShader::Vertex> verts;
-		verts.reserve(mesh->mNumVertices);
-
-		aiMaterial* material = scene->mMaterials[mesh->mMaterialIndex];
-		aiColor4D specularColor;
-		aiColor4D diffuseColor;
-		aiColor4D ambientColor;
-		float shininess;
-
-		aiGetMaterialColor(material, AI_MATKEY_COLOR_SPECULAR, &specularColor);
-		aiGetMaterialColor(material, AI_MATKEY_COLOR_DIFFUSE, &diffuseColor);
-		aiGetMaterialColor(material, AI_MATKEY_COLOR_AMBIENT, &ambientColor);
-		aiGetMaterialFloat(material, AI_MATKEY_SHININESS, &shininess);
-
-		TexturedShader::Material meshMaterial
-		(
-			Color(specularColor.r, specularColor.g, specularColor.b, shininess), // Specular
-			Color(diffuseColor.r, diffuseColor.g, diffuseColor.b, diffuseColor.a), // Diffuse
-			Color(ambientColor.r, ambientColor.g, ambientColor.b, ambientColor.a) // Ambient
-		);
-
-		for (std::uint32_t vertIdx = 0u; vertIdx < mesh->mNumVertices; vertIdx++)
-		{
-			aiVector3D vert = mesh->mVertices[vertIdx];
-			aiVector3D norm = mesh->mNormals[vertIdx];
-			aiVector3D uv = mesh->mTextureCoords[0][vertIdx];
-
-			verts.push_back
-			(
-				TexturedShader::Vertex
-				(
-					Vec3(vert.x, vert.y, vert.z),
-					Vec3(norm.x, norm.y, norm.z),
-					uv.x, uv.y
-				)
-			);
-		}
-
-		std::vector<std::uint32_t> indices;
-		indices.reserve(mesh->mNumFaces * 3u);
-		for (std::uint32_t faceIdx = 0u; faceIdx < mesh->mNumFaces; faceIdx++)
-		{
-			indices.push_back(mesh->mFaces[faceIdx].mIndices[0u]);
-			indices.push_back(mesh->mFaces[faceIdx].mIndices[1u]);
-			indices.push_back(mesh->mFaces[faceIdx].mIndices[2u]);
-		}
+	return true;
+}
 
-		TexturedShader::RenderCall call(d3dDevice, verts, indices);
+bool AssimpManModel::Update(float dt)
+{
+	return true;
+}
 
-		meshes.push_back({ call, meshMaterial });
-	}
+void AssimpManModel::SetTransform(const Transform& transform)
+{
+	transform_ = transform;
+	worldBounds_ = localBounds_.Transformed(transform_.GetTransformMatrix());
+}
 
-	return std::make_shared<AssimpManModel>(meshes, transform, manTexture);
+const Bounds& AssimpManModel::GetWorldBounds() const
+{
+	return worldBounds_;
 }
 
-bool AssimpManModel::Update(float dt)
+void AssimpManModel::UpdateLod(const Vec3& cameraPosition, float pixelsPerUnit)
 {
-	return true;
+	const Vec3& scale = transform_.Scale;
+	float worldScale = std::max(fabsf(scale.x), std::max(fabsf(scale.y), fabsf(scale.z)));
+	lod_.Select(worldBounds_.Sphere, worldScale, cameraPosition, pixelsPerUnit);
 }
 
 bool AssimpManModel::Render(ComPtr<ID3D11DeviceContext> context, TexturedShader* shader) const
 {
-	shader->SetModelTransform(transform_.GetTransformMatrix());
 	shader->SetTexture(texture_);
 
+	const Affine3x4 model = transform_.GetAffineMatrix();
 	for (auto&& mesh : meshes_)
 	{
+		// Every mesh is quantized in its own cube, so each one gets its own model matrix
+		shader->SetModelTransform(model * mesh.Dequantize);
+
+		// Meshes that ran out of LODs early just stay at their coarsest one
+		TexturedShader::RenderCall call = mesh.Call;
+		if (!mesh.Lods.empty())
+		{
+			const CookedLod& lod = mesh.Lods[std::min<std::size_t>(lod_.GetLevel(), mesh.Lods.size() - 1u)];
+			call.StartIndex = lod.FirstIndex;
+			call.NumberOfIndices = lod.IndexCount;
+		}
+
 		shader->SetObjectMaterial(mesh.Material);
-		shader->Render(context, mesh.Call);
+		shader->Render(context, call);
 	}
 
 	return true;
@@ -138,6 +177,26 @@ AssimpManModel::AssimpManModel(const std::vector<Mesh>& meshes, const Transform&
 	: meshes_(meshes)
 	, transform_(transform)
 	, texture_(texture)
-{}
+	, localBounds_()
+	, worldBounds_()
+	, lod_()
+{
+	// The model's error at each level is its worst mesh's
+	std::vector<float> lodErrors(1u, 0.f);
+	for (auto&& mesh : meshes_)
+	{
+		localBounds_ = Bounds::Merge(localBounds_, mesh.LocalBounds);
+		lodErrors.resize(std::max(lodErrors.size(), mesh.Lods.size()), 0.f);
+	}
+	for (auto&& mesh : meshes_)
+	{
+		for (std::size_t lodIdx = 0u; lodIdx < lodErrors.size() && !mesh.Lods.empty(); lodIdx++)
+		{
+			lodErrors[lodIdx] = std::max(lodErrors[lodIdx], mesh.Lods[std::min(lodIdx, mesh.Lods.size() - 1u)].Error);
+		}
+	}
+	lod_.SetLevelErrors(lodErrors);
+	worldBounds_ = localBounds_.Transformed(transform_.GetTransformMatrix());
+}
 
 };
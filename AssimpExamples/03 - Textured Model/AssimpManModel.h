@@ -1,6 +1,12 @@
 #pragma once
 
+#include <AssetPack.h>
+#include <Bounds.h>
+#include <ImportProfile.h>
+#include <LodSelector.h>
+#include <MeshCache.h>
 #include <Transform.h>
+#include <future>
 #include <vector>
 #include <memory>
 
@@ -16,22 +22,61 @@ public:
 	{
 		TexturedShader::RenderCall Call;
 		TexturedShader::Material Material;
+		Bounds LocalBounds; // Model space - before the model transform
+		std::vector<CookedLod> Lods; // Parts of Call's index buffer, full detail first
+		Affine3x4 Dequantize; // Call's compact positions back to model space
+	};
+
+	// Everything loading takes that doesn't need the device - which is almost all of it
+	struct CpuData
+	{
+		bool Loaded;
+		std::vector<CookedMesh<TexturedShader::CompactVertex>> Meshes;
+		std::vector<unsigned char> TexturePixels; // RGBA8, already flipped for D3D
+		std::uint32_t TextureWidth;
+		std::uint32_t TextureHeight;
 	};
 
 public:
 	AssimpManModel(const std::vector<Mesh>& meshes, const Transform& transform, TexturedShader::Texture texture);
 
-	static std::shared_ptr<AssimpManModel> LoadFromFile(const char* fName, const char* textureFilename, ComPtr<ID3D11Device> d3dDevice, ComPtr<ID3D11DeviceContext> d3dDeviceContext, const Transform& transform);
+	// Loading happens in two steps, so several models can load at the same time:
+	//  LoadAsync reads, imports and converts the model and decodes its texture on other
+	//  threads (assets has to stay alive until the future is ready), and Upload then makes
+	//  the GPU buffers and texture. Upload uses the device context, so it's main thread only.
+	static std::future<CpuData> LoadAsync(const AssetPack& assets, const char* fName, const char* textureFilename, const ImportProfile& profile = ImportProfile::OfflineMax);
+	static std::shared_ptr<AssimpManModel> Upload(const CpuData& data, ComPtr<ID3D11Device> d3dDevice, ComPtr<ID3D11DeviceContext> d3dDeviceContext, const Transform& transform);
+
+	// Both steps in one go, on this thread
+	static std::shared_ptr<AssimpManModel> LoadFromFile(const AssetPack& assets, const char* fName, const char* textureFilename, ComPtr<ID3D11Device> d3dDevice, ComPtr<ID3D11DeviceContext> d3dDeviceContext, const Transform& transform,
+		const ImportProfile& profile = ImportProfile::OfflineMax);
 	bool Update(float dt);
+
+	void SetTransform(const Transform& transform);
+
+	// Bounds of all meshes together, in world space. Kept up to date by SetTransform.
+	const Bounds& GetWorldBounds() const;
+
+	// Picks the LOD Render draws, from how far away the camera is (see LodSelector.h).
+	//  Every mesh switches together, so there are no cracks between them.
+	void UpdateLod(const Vec3& cameraPosition, float pixelsPerUnit);
+
 	bool Render(ComPtr<ID3D11DeviceContext> context, TexturedShader* shader) const;
 
 	AssimpManModel(const AssimpManModel&) = delete;
 	~AssimpManModel() = default;
 
+protected:
+	static CpuData LoadCpuData(const AssetPack& assets, const char* fName, const char* textureFilename, const ImportProfile& profile);
+	static bool DecodeTexture(const AssetPack& assets, const char* textureFilename, CpuData& data);
+
 protected:
 	std::vector<Mesh> meshes_;
 	TexturedShader::Texture texture_;
 	Transform transform_;
+	Bounds localBounds_;
+	Bounds worldBounds_;
+	LodSelector lod_;
 };
 
 };
\ No newline at end of file
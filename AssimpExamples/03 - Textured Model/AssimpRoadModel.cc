@@ -1,83 +1,66 @@
 #include "AssimpRoadModel.h"
 
-#include <assimp/cimport.h>
-#include <assimp/scene.h>
-#include <assimp/postprocess.h>
-#include <assimp/material.h>
-
-#include <iostream>
+#include <MeshOptimizer.h>
+#include <ModelLoader.h>
 
 namespace sess
 {
 
-std::shared_ptr<AssimpRoadModel> AssimpRoadModel::LoadFromFile(const char * fName, ComPtr<ID3D11Device> d3dDevice, const Transform & transform)
+std::future<AssimpRoadModel::CpuData> AssimpRoadModel::LoadAsync(const AssetPack& assets, const char* fName, const ImportProfile& profile)
 {
-	const aiScene* scene = aiImportFile(fName, aiProcessPreset_TargetRealtime_MaxQuality);
+	// fName and profile are copied - the caller's might be gone by the time this runs
+	return std::async(std::launch::async, [&assets, name = std::string(fName), profile] {
+		return LoadCpuData(assets, name.c_str(), profile);
+	});
+}
 
-	if (!scene)
+std::shared_ptr<AssimpRoadModel> AssimpRoadModel::Upload(const CpuData& data, ComPtr<ID3D11Device> d3dDevice, const Transform& transform)
+{
+	if (!data.Loaded)
 	{
-		std::cerr << "Could not load file " << fName << std::endl;
 		return nullptr;
 	}
 
-	// Load all meshes and whatnot
 	std::vector<Mesh> meshes;
-	meshes.reserve(scene->mNumMeshes);
-	for (std::uint32_t meshIdx = 0u; meshIdx < scene->mNumMeshes; meshIdx++)
+	meshes.reserve(data.Meshes.size());
+	for (std::size_t meshIdx = 0u; meshIdx < data.Meshes.size(); meshIdx++)
 	{
-		aiMesh* mesh = scene->mMeshes[meshIdx];
-
-		std::vector<MaterialOnlyShader::Vertex> verts;
-		verts.reserve(mesh->mNumVertices);
-		
-		aiMaterial* material = scene->mMaterials[mesh->mMaterialIndex];
-		aiColor4D specularColor;
-		aiColor4D diffuseColor;
-		aiColor4D ambientColor;
-		float shininess;
-
-		aiGetMaterialColor(material, AI_MATKEY_COLOR_SPECULAR, &specularColor);
-		aiGetMaterialColor(material, AI_MATKEY_COLOR_DIFFUSE, &diffuseColor);
-		aiGetMaterialColor(material, AI_MATKEY_COLOR_AMBIENT, &ambientColor);
-		aiGetMaterialFloat(material, AI_MATKEY_SHININESS, &shininess);
-
-		MaterialOnlyShader::Material meshMaterial
-		(
-			Color(specularColor.r, specularColor.g, specularColor.b, shininess), // Specular
-			Color(diffuseColor.r, diffuseColor.g, diffuseColor.b, diffuseColor.a), // Diffuse
-			Color(ambientColor.r, ambientColor.g, ambientColor.b, ambientColor.a) // Ambient
-		);
-
-		for (std::uint32_t vertIdx = 0u; vertIdx < mesh->mNumVertices; vertIdx++)
-		{
-			aiVector3D vert = mesh->mVertices[vertIdx];
-			aiVector3D norm = mesh->mNormals[vertIdx];
-
-			verts.push_back
-			(
-				MaterialOnlyShader::Vertex
-				(
-					Vec3(vert.x, vert.y, vert.z),
-					Vec3(norm.x, norm.y, norm.z)
-				)
-			);
-		}
+		const auto& cooked = data.Meshes[meshIdx];
+		MaterialOnlyShader::RenderCall call(d3dDevice, cooked.Vertices, cooked.Indices);
+		MaterialOnlyShader::Material meshMaterial(cooked.Material.Specular, cooked.Material.Diffuse, cooked.Material.Ambient);
+		meshes.push_back({ call, meshMaterial, cooked.LocalBounds, data.Meshes.size() == data.Meshlets.size() ? data.Meshlets[meshIdx] : std::vector<Meshlet>() });
+	}
 
-		std::vector<std::uint32_t> indices;
-		indices.reserve(mesh->mNumFaces * 3u);
-		for (std::uint32_t faceIdx = 0u; faceIdx < mesh->mNumFaces; faceIdx++)
-		{
-			indices.push_back(mesh->mFaces[faceIdx].mIndices[0u]);
-			indices.push_back(mesh->mFaces[faceIdx].mIndices[1u]);
-			indices.push_back(mesh->mFaces[faceIdx].mIndices[2u]);
-		}
+	return std::make_shared<AssimpRoadModel>(meshes, transform);
+}
 
-		MaterialOnlyShader::RenderCall call(d3dDevice, verts, indices);
+std::shared_ptr<AssimpRoadModel> AssimpRoadModel::LoadFromFile(const AssetPack& assets, const char* fName, ComPtr<ID3D11Device> d3dDevice, const Transform& transform, const ImportProfile& profile)
+{
+	return Upload(LoadCpuData(assets, fName, profile), d3dDevice, transform);
+}
 
-		meshes.push_back({ call, meshMaterial });
+AssimpRoadModel::CpuData AssimpRoadModel::LoadCpuData(const AssetPack& assets, const char* fName, const ImportProfile& profile)
+{
+	CpuData data = { false };
+	data.Loaded = ModelLoader<MaterialOnlyShader::Vertex>::Load(assets, fName, profile, data.Meshes);
+	if (!data.Loaded)
+	{
+		return data;
 	}
 
-	return std::make_shared<AssimpRoadModel>(meshes, transform);
+	// Meshlets aren't in the mesh cache - they're quick to make, and only the road uses them.
+	//  Only the full detail triangles get cut up, any LODs after them are left alone.
+	data.Meshlets.resize(data.Meshes.size());
+	for (std::size_t meshIdx = 0u; meshIdx < data.Meshes.size(); meshIdx++)
+	{
+		auto& cooked = data.Meshes[meshIdx];
+		std::uint32_t indexCount = cooked.Lods.empty() ? static_cast<std::uint32_t>(cooked.Indices.size()) : cooked.Lods[0u].IndexCount;
+		data.Meshlets[meshIdx] = BuildMeshlets(cooked.Indices.data(), indexCount, &cooked.Vertices[0u].Position.x, sizeof(MaterialOnlyShader::Vertex), cooked.Vertices.size());
+
+		// The triangles moved around, so the vertices get put back in the order they're used
+		cooked.Vertices.resize(OptimizeVertexFetch(cooked.Vertices.data(), sizeof(MaterialOnlyShader::Vertex), cooked.Vertices.size(), cooked.Indices.data(), cooked.Indices.size()));
+	}
+	return data;
 }
 
 bool AssimpRoadModel::Update(float dt)
@@ -85,14 +68,70 @@ bool AssimpRoadModel::Update(float dt)
 	return true;
 }
 
+void AssimpRoadModel::SetTransform(const Transform& transform)
+{
+	transform_ = transform;
+	worldBounds_ = localBounds_.Transformed(transform_.GetTransformMatrix());
+}
+
+const Bounds& AssimpRoadModel::GetWorldBounds() const
+{
+	return worldBounds_;
+}
+
+std::size_t AssimpRoadModel::Cull(const Matrix& viewProj, const Vec3& cameraPosition)
+{
+	// Meshlet bounds are in model space, so the camera goes there instead of every meshlet
+	//  coming out to world space. Frustum takes row vector matrices, the transform matrix
+	//  is column vector - hence the transpose.
+	Matrix model = transform_.GetTransformMatrix();
+	Frustum modelFrustum(model.Transpose() * viewProj);
+	Vec3 modelCamera = model.InverseAffine().TransformPoint(cameraPosition);
+
+	// A mirroring transform flips which side of every triangle is the front
+	const Vec3* coneCamera = (model.Determinant() > 0.f) ? &modelCamera : nullptr;
+
+	std::size_t visibleCount = 0u;
+	for (auto&& mesh : meshes_)
+	{
+		visibleCount += CullMeshlets(mesh.Meshlets.data(), mesh.Meshlets.size(), modelFrustum, coneCamera, meshletVisibility_);
+		GatherVisibleRanges(mesh.Meshlets.data(), mesh.Meshlets.size(), meshletVisibility_, mesh.VisibleRanges);
+	}
+	return visibleCount;
+}
+
+std::size_t AssimpRoadModel::GetMeshletCount() const
+{
+	std::size_t count = 0u;
+	for (auto&& mesh : meshes_)
+	{
+		count += mesh.Meshlets.size();
+	}
+	return count;
+}
+
 bool AssimpRoadModel::Render(ComPtr<ID3D11DeviceContext> context, MaterialOnlyShader* shader) const
 {
-	shader->SetModelTransform(transform_.GetTransformMatrix());
+	shader->SetModelTransform(transform_.GetAffineMatrix());
 
 	for (auto&& mesh : meshes_)
 	{
 		shader->SetObjectMaterial(mesh.Material);
-		shader->Render(context, mesh.Call);
+
+		// No meshlets to cull with - all of it, same as always
+		if (mesh.Meshlets.empty())
+		{
+			shader->Render(context, mesh.Call);
+			continue;
+		}
+
+		MaterialOnlyShader::RenderCall call = mesh.Call;
+		for (auto&& range : mesh.VisibleRanges)
+		{
+			call.StartIndex = range.FirstIndex;
+			call.NumberOfIndices = range.IndexCount;
+			shader->Render(context, call);
+		}
 	}
 
 	return true;
@@ -101,7 +140,24 @@ bool AssimpRoadModel::Render(ComPtr<ID3D11DeviceContext> context, MaterialOnlySh
 AssimpRoadModel::AssimpRoadModel(const std::vector<Mesh>& meshes, const Transform& transform)
 	: meshes_(meshes)
 	, transform_(transform)
-{}
+	, localBounds_()
+	, worldBounds_()
+{
+	for (auto&& mesh : meshes_)
+	{
+		localBounds_ = Bounds::Merge(localBounds_, mesh.LocalBounds);
+
+		// Everything is visible until the first Cull says otherwise
+		VisibilitySet allVisible;
+		allVisible.Reset(mesh.Meshlets.size());
+		for (std::size_t meshletIdx = 0u; meshletIdx < mesh.Meshlets.size(); meshletIdx++)
+		{
+			allVisible.SetVisible(meshletIdx, true);
+		}
+		GatherVisibleRanges(mesh.Meshlets.data(), mesh.Meshlets.size(), allVisible, mesh.VisibleRanges);
+	}
+	worldBounds_ = localBounds_.Transformed(transform_.GetTransformMatrix());
+}
 
 
 };
\ No newline at end of file
@@ -1,6 +1,12 @@
 #pragma once
 
+#include <AssetPack.h>
+#include <Bounds.h>
+#include <ImportProfile.h>
+#include <MeshCache.h>
+#include <Meshlets.h>
 #include <Transform.h>
+#include <future>
 #include <vector>
 #include <memory>
 
@@ -16,22 +22,59 @@ public:
 	{
 		MaterialOnlyShader::RenderCall Call;
 		MaterialOnlyShader::Material Material;
+		Bounds LocalBounds; // Model space - before the model transform
+		std::vector<Meshlet> Meshlets;
+		std::vector<IndexRange> VisibleRanges; // What Render draws, filled in by Cull
+	};
+
+	// Everything loading takes that doesn't need the device - which is almost all of it
+	struct CpuData
+	{
+		bool Loaded;
+		std::vector<CookedMesh<MaterialOnlyShader::Vertex>> Meshes;
+		std::vector<std::vector<Meshlet>> Meshlets; // One list per mesh
 	};
 
 public:
 	
 	AssimpRoadModel(const std::vector<Mesh>& meshes, const Transform& transform);
 
-	static std::shared_ptr<AssimpRoadModel> LoadFromFile(const char* fName, ComPtr<ID3D11Device> d3dDevice, const Transform& transform);
+	// Loading happens in two steps, so several models can load at the same time:
+	//  LoadAsync reads, imports and converts the model on another thread (assets has to
+	//  stay alive until the future is ready), and Upload then makes the GPU buffers.
+	static std::future<CpuData> LoadAsync(const AssetPack& assets, const char* fName, const ImportProfile& profile = ImportProfile::OfflineMax);
+	static std::shared_ptr<AssimpRoadModel> Upload(const CpuData& data, ComPtr<ID3D11Device> d3dDevice, const Transform& transform);
+
+	// Both steps in one go, on this thread
+	static std::shared_ptr<AssimpRoadModel> LoadFromFile(const AssetPack& assets, const char* fName, ComPtr<ID3D11Device> d3dDevice, const Transform& transform,
+		const ImportProfile& profile = ImportProfile::OfflineMax);
 	bool Update(float dt);
+
+	void SetTransform(const Transform& transform);
+
+	// Bounds of all meshes together, in world space. Kept up to date by SetTransform.
+	const Bounds& GetWorldBounds() const;
+
+	// Works out which meshlets (see Meshlets.h) Render draws - the ones in the frustum and
+	//  facing the camera. viewProj is view * projection, same as Frustum takes.
+	//  Returns how many meshlets are visible, out of all of the model's.
+	std::size_t Cull(const Matrix& viewProj, const Vec3& cameraPosition);
+	std::size_t GetMeshletCount() const;
+
 	bool Render(ComPtr<ID3D11DeviceContext> context, MaterialOnlyShader* shader) const;
 
 	AssimpRoadModel(const AssimpRoadModel&) = delete;
 	~AssimpRoadModel() = default;
 
+protected:
+	static CpuData LoadCpuData(const AssetPack& assets, const char* fName, const ImportProfile& profile);
+
 protected:
 	std::vector<Mesh> meshes_;
 	Transform transform_;
+	Bounds localBounds_;
+	Bounds worldBounds_;
+	VisibilitySet meshletVisibility_; // Scratch space for Cull, kept around so it doesn't allocate every frame
 };
 
 };
\ No newline at end of file
@@ -96,6 +96,8 @@ DebugMaterialIcosphere::DebugMaterialIcosphere
 	, rotationSpeed_(rotationSpeed)
 	, rotationAngle_(0.f)
 	, modelTransform_(position, Quaternion::Identity, scale)
+	, localBounds_(Bounds::FromPoints(verts, _countof(verts) / 3u))
+	, worldBounds_(localBounds_.Transformed(modelTransform_.GetTransformMatrix()))
 {
 	std::vector<MaterialOnlyShader::Vertex> vertices;
 	vertices.reserve(_countof(verts));
@@ -130,14 +132,20 @@ bool DebugMaterialIcosphere::Update(float dt)
 	}
 
 	modelTransform_.Rotation = Quaternion(Vec3::UnitY, rotationAngle_);
+	worldBounds_ = localBounds_.Transformed(modelTransform_.GetTransformMatrix());
 
 	return true;
 }
 
+const Bounds& DebugMaterialIcosphere::GetWorldBounds() const
+{
+	return worldBounds_;
+}
+
 bool DebugMaterialIcosphere::Render(ComPtr<ID3D11DeviceContext> context, MaterialOnlyShader* shader) const
 {
 	shader->SetObjectMaterial(material_);
-	shader->SetModelTransform(modelTransform_.GetTransformMatrix());
+	shader->SetModelTransform(modelTransform_.GetAffineMatrix());
 	shader->Render(context, *call_);
 
 	return true;
@@ -3,6 +3,7 @@
 // Debug icosphere. Does not load froma file, simply shows how to render stuff.
 #include "MaterialOnlyShader.h"
 
+#include <Bounds.h>
 #include <Transform.h>
 
 #include <d3d11.h>
@@ -21,6 +22,7 @@ public:
 	~DebugMaterialIcosphere() = default;
 
 	bool Update(float dt);
+	const Bounds& GetWorldBounds() const;
 	bool Render(ComPtr<ID3D11DeviceContext> context, MaterialOnlyShader* shader) const;
 
 protected:
@@ -31,6 +33,8 @@ protected:
 	float rotationAngle_;
 
 	Transform modelTransform_;
+	Bounds localBounds_;
+	Bounds worldBounds_;
 };
 
 };
\ No newline at end of file
@@ -22,7 +22,11 @@
 #include <wrl.h>
 #include <future>
 #include <vector>
+#include <Affine3x4.h>
+#include <AssetPack.h>
+#include <IndexFormat.h>
 #include <MathExtras.h>
+#include <VertexTraits.h>
 
 using Microsoft::WRL::ComPtr;
 
@@ -42,6 +46,7 @@ public:
 		float __zero;
 
 	public:
+		Vertex() = default; // Zeroed by std::vector::resize, then filled in by ModelLoader
 		Vertex(const Vec3& pos, const Vec3& norm)
 			: Position(pos), __one(1.f), Normal(norm), __zero(0.f)
 		{}
@@ -85,7 +90,7 @@ public:
 	//  must be called. The render call itself has no notion of any of these things.
 	// That also helps in optimizations - DX11/GL/VK all have optimizations that can be
 	//  applied by using this sort of pattern. Different optimizations, but optimizations.
-	void SetModelTransform(const Matrix& modelTransform);
+	void SetModelTransform(const Affine3x4& modelTransform);
 	void SetViewTransform(const Matrix& viewTransform);
 	void SetProjectionTransform(const Matrix& projTransform);
 	void SetObjectMaterial(const Material& objectMaterial);
@@ -108,6 +113,10 @@ public:
 		//  too darn good to forego
 		ComPtr<ID3D11Buffer> VertexBuffer;
 		ComPtr<ID3D11Buffer> IndexBuffer;
+		DXGI_FORMAT IndexFormat; // 16-bit whenever the vertex count allows it (see IndexFormat.h)
+		// Which part of the index buffer gets drawn - all of it, unless this is one of
+		//  several calls sharing the same buffers (like the meshlets that survived culling)
+		std::uint32_t StartIndex;
 		std::uint32_t NumberOfIndices;
 	};
 
@@ -117,7 +126,8 @@ public:
 	MaterialOnlyShader(const MaterialOnlyShader&) = delete;
 	~MaterialOnlyShader() = default;
 
-	std::future<bool> Initialize(ComPtr<ID3D11Device> device);
+	// Compiled shaders come out of assets - the pack, or the loose files in cso/
+	std::future<bool> Initialize(ComPtr<ID3D11Device> device, const AssetPack& assets);
 
 	bool Render(ComPtr<ID3D11DeviceContext> context, const RenderCall& call);
 
@@ -151,7 +161,7 @@ protected:
 	{
 		struct VSC_PerObject_Type
 		{
-			Matrix Model;
+			Affine3x4 Model; // 48 bytes, not 64 - the 0 0 0 1 row is added back in the shader
 		} VSC_PerObject;
 		bool isDirty;
 	} DVSC_PerObject;
@@ -195,4 +205,16 @@ protected:
 	} DPSC_PerScene;
 };
 
+// So ModelLoader knows how to fill in a MaterialOnlyShader::Vertex
+template <>
+struct VertexTraits<MaterialOnlyShader::Vertex>
+{
+	static constexpr const char* Name = "MaterialOnlyShader::Vertex";
+	using Layout = VertexLayout<
+		VertexAttribute<VertexStream::Position, offsetof(MaterialOnlyShader::Vertex, Position)>,
+		VertexAttribute<VertexStream::One, offsetof(MaterialOnlyShader::Vertex, __one)>,
+		VertexAttribute<VertexStream::Normal, offsetof(MaterialOnlyShader::Vertex, Normal)>,
+		VertexAttribute<VertexStream::Zero, offsetof(MaterialOnlyShader::Vertex, __zero)>>;
+};
+
 };
\ No newline at end of file
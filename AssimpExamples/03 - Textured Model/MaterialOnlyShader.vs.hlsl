@@ -25,7 +25,10 @@ struct PixelIn
 //
 cbuffer PerObject : register(b0)
 {
-	matrix mModel;
+	// The top three rows of the model matrix (Affine3x4 on the C++ side). The bottom
+	//  row would always be 0 0 0 1, so it isn't sent - mul() with a float4x3 gives back
+	//  a float3, and w gets put back by hand below.
+	float4x3 mModel;
 };
 
 cbuffer PerFrame : register(b1)
@@ -39,15 +42,15 @@ PixelIn main(VertexIn vin)
 	PixelIn vout;
 
 	// Screen space coordinate: model coord -> world coord -> view coord -> screen cord
-	vout.Position = mul(vin.Position, mModel);
+	vout.Position = float4(mul(vin.Position, mModel), 1.f);
 	vout.Position = mul(vout.Position, mView);
 	vout.Position = mul(vout.Position, mProj);
 
 	// World space coordinate: model coord -> world coord
-	vout.WorldPosition = mul(vin.Position, mModel);
+	vout.WorldPosition = float4(mul(vin.Position, mModel), 1.f);
 
 	// World space normal: model normal -> world normal
-	vout.Normal = mul(vin.Normal, mModel);
+	vout.Normal = float4(mul(vin.Normal, mModel), 0.f);
 
 	return vout;
 }
\ No newline at end of file
@@ -1,7 +1,6 @@
 #include "TexturedShader.h"
 
 #include <iostream>
-#include <fstream>
 
 namespace sess
 {
@@ -9,14 +8,35 @@ namespace sess
 TexturedShader::RenderCall::RenderCall(ComPtr<ID3D11Device> device, const std::vector<TexturedShader::Vertex>& vertices, const std::vector<std::uint32_t>& indices)
 	: VertexBuffer(nullptr)
 	, IndexBuffer(nullptr)
+	, IndexFormat(DXGI_FORMAT_R32_UINT)
+	, StartIndex(0u)
 	, NumberOfIndices(0u)
+	, VertexStride(sizeof(TexturedShader::Vertex))
+	, Compact(false)
+{
+	CreateBuffers(device, &vertices[0], vertices.size(), indices);
+}
+
+TexturedShader::RenderCall::RenderCall(ComPtr<ID3D11Device> device, const std::vector<TexturedShader::CompactVertex>& vertices, const std::vector<std::uint32_t>& indices)
+	: VertexBuffer(nullptr)
+	, IndexBuffer(nullptr)
+	, IndexFormat(DXGI_FORMAT_R32_UINT)
+	, StartIndex(0u)
+	, NumberOfIndices(0u)
+	, VertexStride(sizeof(TexturedShader::CompactVertex))
+	, Compact(true)
+{
+	CreateBuffers(device, &vertices[0], vertices.size(), indices);
+}
+
+void TexturedShader::RenderCall::CreateBuffers(ComPtr<ID3D11Device> device, const void* vertices, std::size_t vertexCount, const std::vector<std::uint32_t>& indices)
 {
 	HRESULT hr = {};
 	D3D11_BUFFER_DESC vbDesc = {};
 	vbDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
 	vbDesc.CPUAccessFlags = 0x00;
 	vbDesc.MiscFlags = 0x00;
-	vbDesc.ByteWidth = sizeof(TexturedShader::Vertex) * (UINT)vertices.size();
+	vbDesc.ByteWidth = VertexStride * (UINT)vertexCount;
 	vbDesc.Usage = D3D11_USAGE_IMMUTABLE;
 	vbDesc.StructureByteStride = 0x00;
 
@@ -25,7 +45,7 @@ TexturedShader::RenderCall::RenderCall(ComPtr<ID3D11Device> device, const std::v
 	//  &v[n] = &v[0] + n for all 0 <= n < v.size() must hold true.
 	// http://www.open-std.org/jtc1/sc22/wg21/docs/lwg-defects.html#69
 	D3D11_SUBRESOURCE_DATA vertexData = {};
-	vertexData.pSysMem = &vertices[0];
+	vertexData.pSysMem = vertices;
 
 	hr = device->CreateBuffer(&vbDesc, &vertexData, &VertexBuffer);
 	if (FAILED(hr))
@@ -34,16 +54,29 @@ TexturedShader::RenderCall::RenderCall(ComPtr<ID3D11Device> device, const std::v
 		return;
 	}
 
+	// Half the size if every vertex can be reached with 16 bits. The narrowed copy only has
+	//  to live until CreateBuffer is done with it.
+	std::vector<std::uint16_t> shortIndices;
+	std::size_t indexSize = sizeof(std::uint32_t);
+	const void* indexSource = &indices[0];
+	if (FitsShortIndices(vertexCount))
+	{
+		NarrowIndices(indices, shortIndices);
+		IndexFormat = DXGI_FORMAT_R16_UINT;
+		indexSize = sizeof(std::uint16_t);
+		indexSource = &shortIndices[0];
+	}
+
 	D3D11_BUFFER_DESC ibDesc = {};
 	ibDesc.BindFlags = D3D11_BIND_INDEX_BUFFER;
 	ibDesc.CPUAccessFlags = 0x00;
 	ibDesc.MiscFlags = 0x00;
-	ibDesc.ByteWidth = sizeof(std::uint32_t) * (UINT)indices.size();
+	ibDesc.ByteWidth = (UINT)(indexSize * indices.size());
 	ibDesc.Usage = D3D11_USAGE_IMMUTABLE;
 	ibDesc.StructureByteStride = 0x00;
 
 	D3D11_SUBRESOURCE_DATA indexData = {};
-	indexData.pSysMem = &indices[0];
+	indexData.pSysMem = indexSource;
 
 	hr = device->CreateBuffer(&ibDesc, &indexData, &IndexBuffer);
 
@@ -100,12 +133,14 @@ TexturedShader::TexturedShader()
 	: vertexShader_(nullptr)
 	, pixelShader_(nullptr)
 	, inputLayout_(nullptr)
+	, compactVertexShader_(nullptr)
+	, compactInputLayout_(nullptr)
 	, vsc_object_(nullptr)
 	, vsc_frame_(nullptr)
 	, psc_object_(nullptr)
 	, psc_frame_(nullptr)
 	, psc_scene_(nullptr)
-	, DVSC_PerObject({ { Matrix::Identity }, true })
+	, DVSC_PerObject({ { Affine3x4::Identity }, true })
 	, DVSC_PerFrame({ { Matrix::Identity, Matrix::Identity }, true })
 	, DPSC_PerFrame({ { Vec3::Zero }, true })
 	, DPSC_PerObject({ { { Color::Palette::Black, Color::Palette::Black, Color::Palette::Black } }, true })
@@ -113,7 +148,7 @@ TexturedShader::TexturedShader()
 	, boundSRV(nullptr)
 {}
 
-std::future<bool> TexturedShader::Initialize(ComPtr<ID3D11Device> device)
+std::future<bool> TexturedShader::Initialize(ComPtr<ID3D11Device> device, const AssetPack& assets)
 {
 	// Async/await pattern in C++. I love it. Pass a function as the second parameter and specify
 	//  async (as opposed to deferred) for the first, and it returns a std::future.
@@ -121,11 +156,13 @@ std::future<bool> TexturedShader::Initialize(ComPtr<ID3D11Device> device)
 	// When the .get() method is called on the future returned, the calling thread will
 	//  block until the function provided finishes, and return the result.
 	// Fantastic pattern, totally unnecessary here.
-	return std::async(std::launch::async, [this, device]() -> bool {
+	return std::async(std::launch::async, [this, device, &assets]() -> bool {
 		const char* vsFname = "../cso/TexturedShader.vs.cso";
+		const char* compactVsFname = "../cso/TexturedShader.compact.vs.cso";
 		const char* psFname = "../cso/TexturedShader.ps.cso";
 
 		std::uint32_t vsDataLength;
+		std::uint32_t compactVsDataLength;
 		std::uint32_t psDataLength;
 
 		HRESULT hr = {};
@@ -138,41 +175,61 @@ std::future<bool> TexturedShader::Initialize(ComPtr<ID3D11Device> device)
 		};
 		std::uint32_t numElements = _countof(inputLayout);
 
+		// Same attributes for CompactVertex - the input assembler turns them back into floats
+		//  (UNORM/SNORM/half) before the vertex shader ever sees them, so the only thing the
+		//  compact vertex shader does differently is unfold the normal
+		D3D11_INPUT_ELEMENT_DESC compactInputLayout[] =
+		{
+			{ "POSITION", 0, DXGI_FORMAT_R16G16B16A16_UNORM, 0, 0, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+			{ "NORMAL", 0, DXGI_FORMAT_R16G16_SNORM, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+			{ "TEXCOORD", 0, DXGI_FORMAT_R16G16_FLOAT, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0 }
+		};
+		std::uint32_t numCompactElements = _countof(compactInputLayout);
+
 		// Using asynchronous programming to get the vertex and pixel bytecode from the file.
 		//  Other things can happen while this is happening, so don't join until the data is needed
-		std::future<std::vector<char>> vsData = std::async(std::launch::async, [this, &vsDataLength, vsFname] {
+		std::future<std::vector<char>> vsData = std::async(std::launch::async, [&assets, &vsDataLength, vsFname] {
 			std::vector<char> vsBytecode(0u);
-			std::ifstream vin(vsFname, std::ios::binary);
-			if (!vin)
+			AssetData vsFile;
+			if (!assets.Load(vsFname, vsFile))
 			{
 				std::cerr << "Failed to open vertex shader file for reading." << std::endl;
 				return vsBytecode;
 			}
 
-			vin.seekg(0, std::ios::end);
-			vsDataLength = (std::uint32_t)vin.tellg();
-			vin.seekg(0, std::ios::beg);
-			vsBytecode.resize(vsDataLength);
-			vin.read(&vsBytecode[0], vsDataLength);
+			vsDataLength = (std::uint32_t)vsFile.GetSize();
+			vsBytecode.assign(vsFile.GetData(), vsFile.GetData() + vsDataLength);
+
+			return vsBytecode;
+		});
+
+		std::future<std::vector<char>> compactVsData = std::async(std::launch::async, [&assets, &compactVsDataLength, compactVsFname] {
+			std::vector<char> vsBytecode(0u);
+			AssetData vsFile;
+			if (!assets.Load(compactVsFname, vsFile))
+			{
+				std::cerr << "Failed to open compact vertex shader file for reading." << std::endl;
+				return vsBytecode;
+			}
+
+			compactVsDataLength = (std::uint32_t)vsFile.GetSize();
+			vsBytecode.assign(vsFile.GetData(), vsFile.GetData() + compactVsDataLength);
 
 			return vsBytecode;
 		});
 
-		std::future<std::vector<char>> psData = std::async(std::launch::async, [this, &psDataLength, psFname] {
+		std::future<std::vector<char>> psData = std::async(std::launch::async, [&assets, &psDataLength, psFname] {
 			std::vector<char> psBytecode(0u);
 
-			std::ifstream pin(psFname, std::ios::binary);
-			if (!pin)
+			AssetData psFile;
+			if (!assets.Load(psFname, psFile))
 			{
 				std::cerr << "Failed to open pixel shader file for reading." << std::endl;
 				return psBytecode;
 			}
 
-			pin.seekg(0, std::ios::end);
-			psDataLength = (std::uint32_t)pin.tellg();
-			pin.seekg(0, std::ios::beg);
-			psBytecode.resize(psDataLength);
-			pin.read(&psBytecode[0], psDataLength);
+			psDataLength = (std::uint32_t)psFile.GetSize();
+			psBytecode.assign(psFile.GetData(), psFile.GetData() + psDataLength);
 
 			return psBytecode;
 		});
@@ -246,6 +303,26 @@ std::future<bool> TexturedShader::Initialize(ComPtr<ID3D11Device> device)
 			return false;
 		}
 
+		std::vector<char> compactVsBytecode = compactVsData.get();
+		if (compactVsBytecode.size() == 0u)
+		{
+			return false;
+		}
+
+		hr = device->CreateVertexShader(&compactVsBytecode[0], compactVsDataLength, nullptr, &compactVertexShader_);
+		if (FAILED(hr))
+		{
+			std::cerr << "Failed to create compact vertex shader: " << hr << std::endl;
+			return false;
+		}
+
+		hr = device->CreateInputLayout(compactInputLayout, numCompactElements, &compactVsBytecode[0], compactVsDataLength, &compactInputLayout_);
+		if (FAILED(hr))
+		{
+			std::cerr << "Failed to create input layout for compact vertex shader: " << hr << std::endl;
+			return false;
+		}
+
 		std::vector<char> psBytecode = psData.get();
 		if (psBytecode.size() == 0u)
 		{
@@ -272,8 +349,9 @@ bool TexturedShader::Render(ComPtr<ID3D11DeviceContext> context, const RenderCal
 {
 	HRESULT hr = {};
 
-	context->IASetInputLayout(inputLayout_.Get());
-	context->VSSetShader(vertexShader_.Get(), nullptr, 0);
+	// Which vertex format the call's buffer is in decides the input layout and vertex shader
+	context->IASetInputLayout(call.Compact ? compactInputLayout_.Get() : inputLayout_.Get());
+	context->VSSetShader(call.Compact ? compactVertexShader_.Get() : vertexShader_.Get(), nullptr, 0);
 	context->PSSetShader(pixelShader_.Get(), nullptr, 0);
 
 	// Update constant buffers. This involves mapping a chunk of host-side (CPU) memory
@@ -372,7 +450,7 @@ bool TexturedShader::Render(ComPtr<ID3D11DeviceContext> context, const RenderCal
 	context->PSSetConstantBuffers(0, _countof(psCBuffers), psCBuffers);
 
 	// Set the input vertex buffer
-	std::uint32_t stride = sizeof(TexturedShader::Vertex);
+	std::uint32_t stride = call.VertexStride;
 	std::uint32_t offset = 0u;
 	// Set the vertex buffer as input to the graphics pipeline. Only using one.
 	context->IASetVertexBuffers(0, 1, call.VertexBuffer.GetAddressOf(), &stride, &offset);
@@ -380,7 +458,7 @@ bool TexturedShader::Render(ComPtr<ID3D11DeviceContext> context, const RenderCal
 	// Set the index buffer as input to the graphics pipeline. Specify that we're using 32 bit unsigned integers
 	//  DXGI is weird about formats, R32 means "one component, having 32 bits". The "R" stands for "red"
 	//  A set of three values, 32 bit uints each, would be DXGI_FORMAT_R32G32B32_UINT, for example.
-	context->IASetIndexBuffer(call.IndexBuffer.Get(), DXGI_FORMAT_R32_UINT, 0u);
+	context->IASetIndexBuffer(call.IndexBuffer.Get(), call.IndexFormat, 0u);
 
 	// We're drawing triangles...
 	context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
@@ -389,12 +467,12 @@ bool TexturedShader::Render(ComPtr<ID3D11DeviceContext> context, const RenderCal
 	context->PSSetShaderResources(0, 1, boundSRV.GetAddressOf());
 
 	// Draw! Draw! Draw!
-	context->DrawIndexed(call.NumberOfIndices, 0u, 0u);
+	context->DrawIndexed(call.NumberOfIndices, call.StartIndex, 0u);
 
 	return true;
 }
 
-void TexturedShader::SetModelTransform(const Matrix& modelTransform)
+void TexturedShader::SetModelTransform(const Affine3x4& modelTransform)
 {
 	DVSC_PerObject.VSC_PerObject.Model = modelTransform;
 	DVSC_PerObject.isDirty = true;
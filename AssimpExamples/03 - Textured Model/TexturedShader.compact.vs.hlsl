@@ -0,0 +1,71 @@
+// Same as TexturedShader.vs.hlsl, but for TexturedShader::CompactVertex (see
+//  VertexQuantization.h). The input assembler already turned the 16-bit numbers back
+//  into floats, so all that's left to do here is unfold the normal.
+
+//
+// STRUCT DEFS
+//  Here I define the input and output formats of this shader
+//
+struct VertexIn
+{
+	float4 Position : POSITION; // 0..1 inside the mesh's quantization cube, w is 1
+	float2 Normal : NORMAL; // Octahedral, -1..1
+	float2 UV : TEXCOORD0;
+};
+
+struct PixelIn
+{
+	float4 Position : SV_POSITION;
+	float4 WorldPosition : POSITION;
+	float4 Normal : NORMAL;
+	float2 UV : TEXCOORD0;
+};
+
+//
+// CBUFFERS
+//  Here I set up the buffers that will hold the (vertex) shader globals
+//  Transformation matrices, for example
+//
+cbuffer PerObject : register(b0)
+{
+	// The model matrix with the mesh's dequantization already folded in - it takes the
+	//  0..1 positions straight to world space. The scale it adds is the same on every
+	//  axis, so it only changes the normals' length, and the pixel shader normalizes those.
+	float4x3 mModel;
+};
+
+cbuffer PerFrame : register(b1)
+{
+	matrix mView;
+	matrix mProj;
+};
+
+// Octahedron square back to a direction: the middle of the square is the top half of the
+//  octahedron as-is, and the corners get folded back under to make the bottom half
+float3 DecodeOctahedral(float2 e)
+{
+	float3 n = float3(e, 1.f - abs(e.x) - abs(e.y));
+	float t = saturate(-n.z);
+	n.xy += (n.xy >= 0.f) ? -t : t;
+	return normalize(n);
+}
+
+PixelIn main(VertexIn vin)
+{
+	PixelIn vout;
+
+	// Screen space coordinate: model coord -> world coord -> view coord -> screen cord
+	vout.Position = float4(mul(vin.Position, mModel), 1.f);
+	vout.Position = mul(vout.Position, mView);
+	vout.Position = mul(vout.Position, mProj);
+
+	// World space coordinate: model coord -> world coord
+	vout.WorldPosition = float4(mul(vin.Position, mModel), 1.f);
+
+	// World space normal: model normal -> world normal
+	vout.Normal = float4(mul(float4(DecodeOctahedral(vin.Normal), 0.f), mModel), 0.f);
+
+	vout.UV = vin.UV;
+
+	return vout;
+}
\ No newline at end of file
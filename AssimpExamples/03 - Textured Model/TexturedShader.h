@@ -4,7 +4,11 @@
 #include <wrl.h>
 #include <future>
 #include <vector>
+#include <Affine3x4.h>
+#include <AssetPack.h>
+#include <IndexFormat.h>
 #include <MathExtras.h>
+#include <VertexTraits.h>
 
 using Microsoft::WRL::ComPtr;
 
@@ -34,11 +38,23 @@ public:
 		float V; //  only be for grouping. I'll just leave them separate like this.
 
 	public:
+		Vertex() = default; // Zeroed by std::vector::resize, then filled in by ModelLoader
 		Vertex(const Vec3& pos, const Vec3& norm, float u, float v)
 			: Position(pos), __one(1.f), Normal(norm), __zero(0.f), U(u), V(v)
 		{}
 	};
 
+	// The same vertex in 16 bytes instead of 40 (see VertexQuantization.h for how, and how
+	//  much precision it costs). Positions are in the mesh's quantization cube, so the
+	//  cube's ToAffine() has to go into the model transform when drawing these.
+	struct CompactVertex
+	{
+		std::uint16_t Position[4]; // UNORM, w is always 65535 (so 1 in the shader)
+		std::int16_t Normal[2]; // SNORM, octahedral
+		std::uint16_t UV[2]; // Half floats
+	};
+	static_assert(sizeof(CompactVertex) == 16u, "CompactVertex should pack down to 16 bytes");
+
 	// Material color will be multiplied with texture color for ambient and diffuse color, specular
 	//  color will be applied as is. There are other approaches that could be taken, but I think this
 	//  one finds a good balance between accurate and cheap.
@@ -69,7 +85,7 @@ public:
 	// Calls used by this shader to set shader variables (would be the same in OGL/VK)
 	//  These are not included in the render call itself, because they could change less frequently
 	//  than render calls are made. The render call itself only stores geometry information.
-	void SetModelTransform(const Matrix& modelTransform);
+	void SetModelTransform(const Affine3x4& modelTransform);
 	void SetViewTransform(const Matrix& viewTransform);
 	void SetProjectionTransform(const Matrix& projTransform);
 	void SetObjectMaterial(const Material& objectMaterial);
@@ -86,11 +102,21 @@ public:
 	{
 	public:
 		RenderCall(ComPtr<ID3D11Device> device, const std::vector<Vertex>& vertices, const std::vector<std::uint32_t>& indices);
+		RenderCall(ComPtr<ID3D11Device> device, const std::vector<CompactVertex>& vertices, const std::vector<std::uint32_t>& indices);
 
 	public:
 		ComPtr<ID3D11Buffer> VertexBuffer;
 		ComPtr<ID3D11Buffer> IndexBuffer;
+		DXGI_FORMAT IndexFormat; // 16-bit whenever the vertex count allows it (see IndexFormat.h)
+		// Which part of the index buffer gets drawn - all of it, unless this is one of
+		//  several calls sharing the same buffers (like a model's LODs)
+		std::uint32_t StartIndex;
 		std::uint32_t NumberOfIndices;
+		std::uint32_t VertexStride;
+		bool Compact; // CompactVertex instead of Vertex
+
+	private:
+		void CreateBuffers(ComPtr<ID3D11Device> device, const void* vertices, std::size_t vertexCount, const std::vector<std::uint32_t>& indices);
 	};
 
 	// Wrapper around D3D11 texture
@@ -111,7 +137,8 @@ public:
 	TexturedShader(const TexturedShader&) = delete;
 	~TexturedShader() = default;
 
-	std::future<bool> Initialize(ComPtr<ID3D11Device> device);
+	// Compiled shaders come out of assets - the pack, or the loose files in cso/
+	std::future<bool> Initialize(ComPtr<ID3D11Device> device, const AssetPack& assets);
 
 	bool Render(ComPtr<ID3D11DeviceContext> context, const RenderCall& call);
 
@@ -120,6 +147,8 @@ protected:
 	ComPtr<ID3D11VertexShader> vertexShader_;
 	ComPtr<ID3D11PixelShader> pixelShader_;
 	ComPtr<ID3D11InputLayout> inputLayout_;
+	ComPtr<ID3D11VertexShader> compactVertexShader_;
+	ComPtr<ID3D11InputLayout> compactInputLayout_;
 
 	// D3D11 constant buffers
 	ComPtr<ID3D11Buffer> vsc_object_;
@@ -135,7 +164,7 @@ protected:
 	{
 		struct VSC_PerObject_Type
 		{
-			Matrix Model;
+			Affine3x4 Model;
 		} VSC_PerObject;
 		bool isDirty;
 	} DVSC_PerObject;
@@ -181,4 +210,28 @@ protected:
 	ComPtr<ID3D11ShaderResourceView> boundSRV;
 };
 
+// So ModelLoader knows how to fill in a TexturedShader::Vertex
+template <>
+struct VertexTraits<TexturedShader::Vertex>
+{
+	static constexpr const char* Name = "TexturedShader::Vertex";
+	using Layout = VertexLayout<
+		VertexAttribute<VertexStream::Position, offsetof(TexturedShader::Vertex, Position)>,
+		VertexAttribute<VertexStream::One, offsetof(TexturedShader::Vertex, __one)>,
+		VertexAttribute<VertexStream::Normal, offsetof(TexturedShader::Vertex, Normal)>,
+		VertexAttribute<VertexStream::Zero, offsetof(TexturedShader::Vertex, __zero)>,
+		VertexAttribute<VertexStream::TexCoord0, offsetof(TexturedShader::Vertex, U)>>;
+};
+
+// And a TexturedShader::CompactVertex
+template <>
+struct VertexTraits<TexturedShader::CompactVertex>
+{
+	static constexpr const char* Name = "TexturedShader::CompactVertex";
+	using Layout = VertexLayout<
+		VertexAttribute<VertexStream::PositionUnorm16, offsetof(TexturedShader::CompactVertex, Position)>,
+		VertexAttribute<VertexStream::NormalOct16, offsetof(TexturedShader::CompactVertex, Normal)>,
+		VertexAttribute<VertexStream::TexCoord0Half, offsetof(TexturedShader::CompactVertex, UV)>>;
+};
+
 };
\ No newline at end of file
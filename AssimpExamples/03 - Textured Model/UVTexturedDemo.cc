@@ -1,6 +1,7 @@
 #include "UVTexturedDemo.h"
 #include <Color.h>
 
+#include <chrono>
 #include <iostream>
 
 namespace sess
@@ -8,13 +9,15 @@ namespace sess
 
 UVTexturedDemo::UVTexturedDemo(HINSTANCE appHandle)
 	: DemoApp(appHandle, L"Demo - Drawing with Materials Only")
+	, assets_()
 	, materialOnlyShader_()
 	, texturedShader_()
 	, camera_(Vec3(0.f, 2.2f, 0.f), Vec3(0.f, 2.2f, 1.f), Vec3::UnitY)
-	, projMatrix_(PerspectiveLH(Radians(80.f), (windowSize_.right - windowSize_.left) / (float)(windowSize_.bottom - windowSize_.top), 0.1f, 100.f))
+	, projMatrix_(PerspectiveLH(Radians(FIELD_OF_VIEW), (windowSize_.right - windowSize_.left) / (float)(windowSize_.bottom - windowSize_.top), 0.1f, 100.f))
 	, debugIcosphere_(nullptr)
 	, roadModel_(nullptr)
 	, manModel_(nullptr)
+	, visibility_()
 	, inputState_({ /* Initialize to all false */ })
 {}
 
@@ -26,8 +29,25 @@ UVTexturedDemo::~UVTexturedDemo()
 //
 bool UVTexturedDemo::InitializeApp()
 {
-	std::future<bool> shaderLoaded = materialOnlyShader_.Initialize(device_);
-	std::future<bool> textureShaderLoaded = texturedShader_.Initialize(device_);
+	auto startTime = std::chrono::high_resolution_clock::now();
+
+	// One open and one map for everything. Missing is fine - the loose files still work,
+	//  it's just slower (run "make pack" in the packer folder to build it).
+	if (!assets_.Open("../assets.pack"))
+	{
+		std::cout << "No asset pack, loading loose files" << std::endl;
+	}
+
+	// Everything slow gets started at once - both shaders, both models and the man's texture
+	//  all load at the same time, so startup takes about as long as the slowest of them
+	//  instead of all of them added up. Only the GPU uploads happen on this thread.
+	std::future<bool> shaderLoaded = materialOnlyShader_.Initialize(device_, assets_);
+	std::future<bool> textureShaderLoaded = texturedShader_.Initialize(device_, assets_);
+	std::future<AssimpRoadModel::CpuData> roadLoaded = AssimpRoadModel::LoadAsync(assets_, "../assets/road.fbx");
+	// The man gets simplified LODs at half, a quarter and a tenth of his triangles, for when
+	//  he's far enough away that nobody could tell
+	std::future<AssimpManModel::CpuData> manLoaded = AssimpManModel::LoadAsync(assets_, "../assets/simpleMan2.6.fbx", "../assets/man-skin.png",
+		ImportProfile::OfflineMax.WithLods({ 0.5f, 0.25f, 0.1f }));
 
 	debugIcosphere_ = std::make_shared<DebugMaterialIcosphere>
 		(
@@ -39,7 +59,7 @@ bool UVTexturedDemo::InitializeApp()
 			);
 
 	Transform roadTransform(Vec3::Zero, Quaternion(Vec3::UnitY, Radians(-90.f)) * Quaternion(Vec3::UnitX, Radians(-90.f)), Vec3::Ones);
-	roadModel_ = AssimpRoadModel::LoadFromFile("../assets/road.fbx", device_, roadTransform);
+	roadModel_ = AssimpRoadModel::Upload(roadLoaded.get(), device_, roadTransform);
 	if (!roadModel_)
 	{
 		std::cerr << "Failed to load road model, failing initialization" << std::endl;
@@ -52,7 +72,7 @@ bool UVTexturedDemo::InitializeApp()
 		Quaternion(Vec3::UnitY, Radians(180.f)) * Quaternion(Vec3::UnitX, Radians(-90.f)),
 		Vec3(0.55, 0.55, 0.55)
 	);
-	manModel_ = AssimpManModel::LoadFromFile("../assets/simpleMan2.6.fbx", "../assets/man-skin.png", device_, context_, manTransform);
+	manModel_ = AssimpManModel::Upload(manLoaded.get(), device_, context_, manTransform);
 	if (!manModel_)
 	{
 		std::cerr << "Failed to load man model, failing initialization" << std::endl;
@@ -71,6 +91,9 @@ bool UVTexturedDemo::InitializeApp()
 		return false;
 	}
 
+	float msElapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now() - startTime).count() / 1000.f;
+	std::cout << "All assets ready in " << msElapsed << "ms" << std::endl;
+
 	MaterialOnlyShader::DirectionalLight sun
 	(
 		Vec3(2.f, -1.6f, 3.f).Normal(),
@@ -116,6 +139,10 @@ bool UVTexturedDemo::Update(float dt)
 
 	debugIcosphere_->Update(dt);
 	roadModel_->Update(dt);
+	manModel_->Update(dt);
+
+	// Same field of view as projMatrix_
+	manModel_->UpdateLod(camera_.GetPosition(), LodSelector::PixelsPerUnit(Radians(FIELD_OF_VIEW), (float)(windowSize_.bottom - windowSize_.top)));
 
 	return true;
 }
@@ -129,17 +156,41 @@ bool UVTexturedDemo::Render()
 	context_->ClearDepthStencilView(depthStencilView_.Get(), D3D11_CLEAR_DEPTH | D3D11_CLEAR_STENCIL, 1.f, 0x00);
 	context_->RSSetViewports(1, &viewport_);
 
+	Matrix viewMatrix = camera_.GetViewMatrix();
+
 	materialOnlyShader_.SetCameraPosition(camera_.GetPosition());
-	materialOnlyShader_.SetViewTransform(camera_.GetViewMatrix());
+	materialOnlyShader_.SetViewTransform(viewMatrix);
 	materialOnlyShader_.SetProjectionTransform(projMatrix_);
 
 	texturedShader_.SetCameraPosition(camera_.GetPosition());
-	texturedShader_.SetViewTransform(camera_.GetViewMatrix());
+	texturedShader_.SetViewTransform(viewMatrix);
 	texturedShader_.SetProjectionTransform(projMatrix_);
 
-	debugIcosphere_->Render(context_, &materialOnlyShader_);
-	roadModel_->Render(context_, &materialOnlyShader_);
-	manModel_->Render(context_, &texturedShader_);
+	// Skip drawing anything the camera can't see. Only three things in this scene, but the
+	//  same call handles thousands just as well.
+	BoundingSphere worldBounds[] =
+	{
+		debugIcosphere_->GetWorldBounds().Sphere,
+		roadModel_->GetWorldBounds().Sphere,
+		manModel_->GetWorldBounds().Sphere
+	};
+	Frustum(viewMatrix * projMatrix_).CullSpheres(worldBounds, _countof(worldBounds), visibility_);
+
+	if (visibility_.IsVisible(0u))
+	{
+		debugIcosphere_->Render(context_, &materialOnlyShader_);
+	}
+	if (visibility_.IsVisible(1u))
+	{
+		// The road is big enough that most of it is off screen or facing away even when
+		//  some of it is visible, so it gets culled a meshlet at a time too
+		roadModel_->Cull(viewMatrix * projMatrix_, camera_.GetPosition());
+		roadModel_->Render(context_, &materialOnlyShader_);
+	}
+	if (visibility_.IsVisible(2u))
+	{
+		manModel_->Render(context_, &texturedShader_);
+	}
 
 	swapChain_->Present(1, 0x00);
 
@@ -2,6 +2,7 @@
 
 #include <DemoApp.h>
 #include <FreeCamera.h>
+#include <Frustum.h>
 
 #include "AssimpManModel.h"
 #include "AssimpRoadModel.h"
@@ -25,6 +26,9 @@ protected:
 	virtual LRESULT CALLBACK HandleWin32Message(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam) override;
 
 private:
+	// Models, textures and shaders all come out of here (see AssetPack.h)
+	AssetPack assets_;
+
 	MaterialOnlyShader materialOnlyShader_;
 	TexturedShader texturedShader_;
 	FreeCamera camera_;
@@ -33,8 +37,13 @@ private:
 	std::shared_ptr<AssimpRoadModel> roadModel_;
 	std::shared_ptr<AssimpManModel> manModel_;
 
+	// Vertical, in degrees. Both the projection and the LOD pick use it, so change it here
+	static constexpr float FIELD_OF_VIEW = 80.f;
 	Matrix projMatrix_;
 
+	// Which of the icosphere, road and man (in that order) are on screen this frame
+	VisibilitySet visibility_;
+
 	struct
 	{
 	public:
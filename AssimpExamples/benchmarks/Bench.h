@@ -0,0 +1,156 @@
+#pragma once
+
+// Bare-bones benchmark harness. Not trying to compete with Google Benchmark, just
+//  enough to get trustworthy numbers without pulling in another dependency:
+//  - warm-up runs that aren't recorded (page faults, caches, branch predictors)
+//  - lots of timed samples, reported as median and 99th percentile
+//  - small workloads get repeated inside each sample so the clock has something to measure
+//  - optional JSON output, for diffing runs before/after a change
+// Command line: [--json out.json] [--filter substring] [--samples N]
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace sess
+{
+namespace bench
+{
+
+// Keeps the compiler from deciding results nobody looks at don't need computing
+inline void DoNotOptimize(const void* p)
+{
+#if defined(_MSC_VER)
+	static volatile const void* sink;
+	sink = p;
+	_ReadWriteBarrier();
+#else
+	asm volatile("" : : "g"(p) : "memory");
+#endif
+}
+
+struct Result
+{
+	std::string Group;
+	std::string Name;
+	std::size_t Elements;
+	std::size_t Samples;
+	double MedianNs; // Nanoseconds per element
+	double P99Ns;
+	double MinNs;
+};
+
+class Harness
+{
+public:
+	Harness(int argc, char** argv)
+	{
+		for (int i = 1; i < argc; i++)
+		{
+			if (!std::strcmp(argv[i], "--json") && i + 1 < argc)
+			{
+				jsonPath_ = argv[++i];
+			}
+			else if (!std::strcmp(argv[i], "--filter") && i + 1 < argc)
+			{
+				filter_ = argv[++i];
+			}
+			else if (!std::strcmp(argv[i], "--samples") && i + 1 < argc)
+			{
+				samplesOverride_ = (std::size_t)std::atoi(argv[++i]);
+			}
+		}
+	}
+
+	// fn does one pass over all `elements` elements
+	template <typename Fn>
+	void Run(const char* group, const char* name, std::size_t elements, Fn&& fn)
+	{
+		std::string fullName = std::string(group) + "::" + name;
+		if (!filter_.empty() && fullName.find(filter_) == std::string::npos)
+		{
+			return;
+		}
+
+		const std::size_t WARMUP_SAMPLES = 3u;
+		const std::size_t MIN_ELEMENTS_PER_SAMPLE = 1024u;
+
+		std::size_t samples = samplesOverride_ ? samplesOverride_ : (elements >= 100000u ? 11u : 101u);
+		std::size_t passes = std::max<std::size_t>(1u, MIN_ELEMENTS_PER_SAMPLE / elements);
+
+		for (std::size_t s = 0u; s < WARMUP_SAMPLES; s++)
+		{
+			fn();
+		}
+
+		std::vector<double> nsPerElement;
+		nsPerElement.reserve(samples);
+		for (std::size_t s = 0u; s < samples; s++)
+		{
+			auto start = std::chrono::steady_clock::now();
+			for (std::size_t p = 0u; p < passes; p++)
+			{
+				fn();
+			}
+			auto end = std::chrono::steady_clock::now();
+
+			double ns = std::chrono::duration<double, std::nano>(end - start).count();
+			nsPerElement.push_back(ns / (double)(passes * elements));
+		}
+
+		std::sort(nsPerElement.begin(), nsPerElement.end());
+		std::size_t p99Idx = (std::size_t)std::ceil(0.99 * samples) - 1u;
+
+		Result r = { group, name, elements, samples, nsPerElement[samples / 2u], nsPerElement[p99Idx], nsPerElement[0] };
+		std::printf("%-14s %-34s %8zu  median %9.3f ns  p99 %9.3f ns\n", group, name, elements, r.MedianNs, r.P99Ns);
+		std::fflush(stdout);
+		results_.push_back(r);
+	}
+
+	bool WriteJson() const
+	{
+		if (jsonPath_.empty())
+		{
+			return true;
+		}
+
+		FILE* f = std::fopen(jsonPath_.c_str(), "w");
+		if (!f)
+		{
+			std::fprintf(stderr, "Could not open %s for writing\n", jsonPath_.c_str());
+			return false;
+		}
+
+		std::fprintf(f, "{\n  \"unit\": \"ns_per_element\",\n  \"benchmarks\": [\n");
+		for (std::size_t i = 0u; i < results_.size(); i++)
+		{
+			const Result& r = results_[i];
+			std::fprintf(f,
+				"    { \"group\": \"%s\", \"name\": \"%s\", \"elements\": %zu, \"samples\": %zu, \"median\": %.4f, \"p99\": %.4f, \"min\": %.4f }%s\n",
+				r.Group.c_str(), r.Name.c_str(), r.Elements, r.Samples, r.MedianNs, r.P99Ns, r.MinNs,
+				i + 1u < results_.size() ? "," : "");
+		}
+		std::fprintf(f, "  ]\n}\n");
+		std::fclose(f);
+
+		return true;
+	}
+
+private:
+	std::string jsonPath_;
+	std::string filter_;
+	std::size_t samplesOverride_ = 0u;
+	std::vector<Result> results_;
+};
+
+};
+};
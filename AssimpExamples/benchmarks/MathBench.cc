@@ -0,0 +1,474 @@
+// Microbenchmarks for every public operation in the sess math library, with the
+//  closest Assimp equivalent (aiMatrix4x4, aiQuaternion, ...) alongside where there is one.
+// Each operation runs at three sizes:
+//  1       - latency of a single call, repeated in a loop (everything sits in L1)
+//  1000    - a typical mesh or skeleton worth, still cache resident
+//  1000000 - big enough to fall out of cache, so this is mostly a memory bandwidth test
+// All numbers are nanoseconds per element. See Bench.h for the command line options.
+// No Win32 or D3D needed - build with the Makefile in this folder.
+
+#include "Bench.h"
+
+#include <Affine3x4.h>
+#include <DualQuaternion.h>
+#include <Frustum.h>
+#include <MathExtras.h>
+#include <Matrix.h>
+#include <Quaternion.h>
+#include <Transform.h>
+#include <TransformSoA.h>
+#include <VectorStream.h>
+
+#include <assimp/types.h>
+#include <assimp/quaternion.inl>
+
+#include <random>
+
+namespace
+{
+
+using namespace sess;
+using sess::bench::DoNotOptimize;
+using sess::bench::Harness;
+
+const std::size_t SCALES[] = { 1u, 1000u, 1000000u };
+
+// Same seed every run, so every run works on the same numbers
+std::mt19937 rng(1337u);
+
+float RandomFloat(float lo, float hi)
+{
+	return std::uniform_real_distribution<float>(lo, hi)(rng);
+}
+
+Vec3 RandomVec3()
+{
+	return Vec3(RandomFloat(-10.f, 10.f), RandomFloat(-10.f, 10.f), RandomFloat(-10.f, 10.f));
+}
+
+Quaternion RandomQuaternion()
+{
+	return Quaternion(RandomFloat(-1.f, 1.f), RandomFloat(-1.f, 1.f), RandomFloat(-1.f, 1.f), RandomFloat(-1.f, 1.f));
+}
+
+Transform RandomTransform()
+{
+	return Transform(RandomVec3(), RandomQuaternion(), Vec3(RandomFloat(0.5f, 2.f), RandomFloat(0.5f, 2.f), RandomFloat(0.5f, 2.f)));
+}
+
+template <typename T, typename Gen>
+std::vector<T> Generate(std::size_t n, Gen gen)
+{
+	std::vector<T> v;
+	v.reserve(n);
+	for (std::size_t i = 0u; i < n; i++)
+	{
+		v.push_back(gen());
+	}
+	return v;
+}
+
+aiVector3D ToAi(const Vec3& v) { return aiVector3D(v.x, v.y, v.z); }
+aiQuaternion ToAi(const Quaternion& q) { return aiQuaternion(q.w, q.x, q.y, q.z); }
+aiMatrix4x4 ToAi(const Matrix& m)
+{
+	return aiMatrix4x4(
+		m._11, m._12, m._13, m._14,
+		m._21, m._22, m._23, m._24,
+		m._31, m._32, m._33, m._34,
+		m._41, m._42, m._43, m._44);
+}
+
+// aiVector3t declares a copy constructor but no copy assignment, which newer compilers warn
+//  about (-Wdeprecated-copy) - so aiVector3Ds get their components set instead
+template <typename T>
+void Store(T& out, const T& value) { out = value; }
+void Store(aiVector3D& out, const aiVector3D& value) { out.Set(value.x, value.y, value.z); }
+
+// The common case - out[i] = fn(i) for every element
+template <typename T, typename Fn>
+void Map(Harness& h, const char* group, const char* name, std::vector<T>& out, Fn fn)
+{
+	h.Run(group, name, out.size(), [&] {
+		for (std::size_t i = 0u; i < out.size(); i++)
+		{
+			Store(out[i], fn(i));
+		}
+		DoNotOptimize(out.data());
+	});
+}
+
+void BenchVec3(Harness& h, std::size_t n)
+{
+	auto a = Generate<Vec3>(n, RandomVec3);
+	auto b = Generate<Vec3>(n, RandomVec3);
+	std::vector<Vec3> out(n);
+	std::vector<float> outF(n);
+
+	Map(h, "Vec3", "operator+", out, [&](std::size_t i) { return a[i] + b[i]; });
+	Map(h, "Vec3", "operator-", out, [&](std::size_t i) { return a[i] - b[i]; });
+	Map(h, "Vec3", "operator-(unary)", out, [&](std::size_t i) { return -a[i]; });
+	Map(h, "Vec3", "operator*(float)", out, [&](std::size_t i) { return a[i] * 1.5f; });
+	Map(h, "Vec3", "operator+=", out, [&](std::size_t i) { Vec3 r = a[i]; r += b[i]; return r; });
+	Map(h, "Vec3", "operator-=", out, [&](std::size_t i) { Vec3 r = a[i]; r -= b[i]; return r; });
+	Map(h, "Vec3", "operator*=", out, [&](std::size_t i) { Vec3 r = a[i]; r *= 1.5f; return r; });
+	Map(h, "Vec3", "Dot", outF, [&](std::size_t i) { return Vec3::Dot(a[i], b[i]); });
+	Map(h, "Vec3", "Cross", out, [&](std::size_t i) { return Vec3::Cross(a[i], b[i]); });
+	Map(h, "Vec3", "ComponentProduct", out, [&](std::size_t i) { return Vec3::ComponentProduct(a[i], b[i]); });
+	Map(h, "Vec3", "Magnitude", outF, [&](std::size_t i) { return a[i].Magnitude(); });
+	Map(h, "Vec3", "Normal", out, [&](std::size_t i) { return a[i].Normal(); });
+}
+
+void BenchMatrix(Harness& h, std::size_t n)
+{
+	auto a = Generate<Matrix>(n, [] { return RandomTransform().GetTransformMatrix(); });
+	auto b = Generate<Matrix>(n, [] { return RandomTransform().GetTransformMatrix(); });
+	auto p = Generate<Vec3>(n, RandomVec3);
+	std::vector<Matrix> out(n);
+	std::vector<Vec3> outV(n);
+	std::vector<float> outF(n);
+
+	Map(h, "Matrix", "Transpose", out, [&](std::size_t i) { return a[i].Transpose(); });
+	Map(h, "Matrix", "Determinant", outF, [&](std::size_t i) { return a[i].Determinant(); });
+	Map(h, "Matrix", "Inverse", out, [&](std::size_t i) { return a[i].Inverse(); });
+	Map(h, "Matrix", "InverseAffine", out, [&](std::size_t i) { return a[i].InverseAffine(); });
+	Map(h, "Matrix", "operator*", out, [&](std::size_t i) { return a[i] * b[i]; });
+	Map(h, "Matrix", "TransformPoint", outV, [&](std::size_t i) { return a[i].TransformPoint(p[i]); });
+	Map(h, "Matrix", "TransformDirection", outV, [&](std::size_t i) { return a[i].TransformDirection(p[i]); });
+
+	h.Run("Matrix", "MultiplyBatch", n, [&] {
+		Matrix::MultiplyBatch(a.data(), b.data(), out.data(), n);
+		DoNotOptimize(out.data());
+	});
+	h.Run("Matrix", "TransformPoints", n, [&] {
+		Matrix::TransformPoints(a[0], p.data(), outV.data(), n);
+		DoNotOptimize(outV.data());
+	});
+}
+
+// Same operations as BenchMatrix, minus the bottom row - compare the two groups
+void BenchAffine3x4(Harness& h, std::size_t n)
+{
+	auto a = Generate<Affine3x4>(n, [] { return RandomTransform().GetAffineMatrix(); });
+	auto b = Generate<Affine3x4>(n, [] { return RandomTransform().GetAffineMatrix(); });
+	auto t = Generate<Transform>(n, RandomTransform);
+	auto p = Generate<Vec3>(n, RandomVec3);
+	std::vector<Affine3x4> out(n);
+	std::vector<Vec3> outV(n);
+
+	Map(h, "Affine3x4", "Inverse", out, [&](std::size_t i) { return a[i].Inverse(); });
+	Map(h, "Affine3x4", "operator*", out, [&](std::size_t i) { return a[i] * b[i]; });
+	Map(h, "Affine3x4", "TransformPoint", outV, [&](std::size_t i) { return a[i].TransformPoint(p[i]); });
+	Map(h, "Affine3x4", "TransformNormal", outV, [&](std::size_t i) { return a[i].TransformNormal(p[i]); });
+	Map(h, "Affine3x4", "Transform::GetAffineMatrix", out, [&](std::size_t i) { return t[i].GetAffineMatrix(); });
+
+	h.Run("Affine3x4", "MultiplyBatch", n, [&] {
+		Affine3x4::MultiplyBatch(a.data(), b.data(), out.data(), n);
+		DoNotOptimize(out.data());
+	});
+}
+
+void BenchQuaternion(Harness& h, std::size_t n)
+{
+	auto a = Generate<Quaternion>(n, RandomQuaternion);
+	auto b = Generate<Quaternion>(n, RandomQuaternion);
+	auto axes = Generate<Vec3>(n, [] { return RandomVec3().Normal(); });
+	auto m = Generate<Matrix>(n, [] { return RandomTransform().GetTransformMatrix(); });
+	std::vector<Quaternion> out(n);
+	std::vector<float> outF(n);
+
+	Map(h, "Quaternion", "Quaternion(axis,angle)", out, [&](std::size_t i) { return Quaternion(axes[i], 0.75f); });
+	Map(h, "Quaternion", "Quaternion(w,x,y,z)", out, [&](std::size_t i) { return Quaternion(a[i].w, a[i].x, a[i].y, a[i].z); });
+	Map(h, "Quaternion", "FromComponents", out, [&](std::size_t i) { return Quaternion::FromComponents(a[i].w, a[i].x, a[i].y, a[i].z); });
+	Map(h, "Quaternion", "Dot", outF, [&](std::size_t i) { return Quaternion::Dot(a[i], b[i]); });
+	Map(h, "Quaternion", "Inverse", out, [&](std::size_t i) { return a[i].Inverse(); });
+	Map(h, "Quaternion", "operator*", out, [&](std::size_t i) { return a[i] * b[i]; });
+	Map(h, "Quaternion", "operator*=", out, [&](std::size_t i) { Quaternion r = a[i]; r *= b[i]; return r; });
+	Map(h, "Quaternion", "FromMatrix", out, [&](std::size_t i) { return Quaternion::FromMatrix(m[i]); });
+	Map(h, "Quaternion", "Nlerp", out, [&](std::size_t i) { return Quaternion::Nlerp(a[i], b[i], 0.3f); });
+	Map(h, "Quaternion", "Slerp", out, [&](std::size_t i) { return Quaternion::Slerp(a[i], b[i], 0.3f); });
+
+	h.Run("Quaternion", "NlerpBatch", n, [&] {
+		Quaternion::NlerpBatch(a.data(), b.data(), 0.3f, out.data(), n);
+		DoNotOptimize(out.data());
+	});
+	h.Run("Quaternion", "NlerpBatch(no normalize)", n, [&] {
+		Quaternion::NlerpBatch(a.data(), b.data(), 0.3f, out.data(), n, false);
+		DoNotOptimize(out.data());
+	});
+	h.Run("Quaternion", "SlerpBatch", n, [&] {
+		Quaternion::SlerpBatch(a.data(), b.data(), 0.3f, out.data(), n);
+		DoNotOptimize(out.data());
+	});
+
+	// Normalizes in place, so start from a copy every time to keep each pass the same work
+	std::vector<Quaternion> scratch(n);
+	h.Run("Quaternion", "NormalizeAll", n, [&] {
+		for (std::size_t i = 0u; i < n; i++)
+		{
+			scratch[i] = Quaternion::FromComponents(a[i].w * 2.f, a[i].x * 2.f, a[i].y * 2.f, a[i].z * 2.f);
+		}
+		Quaternion::NormalizeAll(scratch.data(), n);
+		DoNotOptimize(scratch.data());
+	});
+}
+
+void BenchTransform(Harness& h, std::size_t n)
+{
+	auto a = Generate<Transform>(n, RandomTransform);
+	auto b = Generate<Transform>(n, RandomTransform);
+	std::vector<Matrix> m(n);
+	for (std::size_t i = 0u; i < n; i++)
+	{
+		m[i] = a[i].GetTransformMatrix();
+	}
+	std::vector<Transform> out(n);
+	std::vector<Matrix> outM(n);
+
+	Map(h, "Transform", "operator*", out, [&](std::size_t i) { return a[i] * b[i]; });
+	Map(h, "Transform", "GetTransformMatrix", outM, [&](std::size_t i) { return a[i].GetTransformMatrix(); });
+	Map(h, "Transform", "Inverse", out, [&](std::size_t i) { return a[i].Inverse(); });
+	Map(h, "Transform", "FromTransformMatrix", out, [&](std::size_t i) { return Transform::FromTransformMatrix(m[i]); });
+	Map(h, "Transform", "Lerp", out, [&](std::size_t i) { return Transform::Lerp(a[i], b[i], 0.3f); });
+
+	TransformSoA soa;
+	soa.Reserve(n);
+	for (std::size_t i = 0u; i < n; i++)
+	{
+		soa.Add(a[i]);
+	}
+	h.Run("TransformSoA", "ComputeMatrices", n, [&] {
+		soa.ComputeMatrices(outM.data(), n);
+		DoNotOptimize(outM.data());
+	});
+}
+
+void BenchMathExtras(Harness& h, std::size_t n)
+{
+	auto v = Generate<Vec3>(n, RandomVec3);
+	auto q = Generate<Quaternion>(n, RandomQuaternion);
+	auto f = Generate<float>(n, [] { return RandomFloat(0.5f, 1.5f); });
+	std::vector<Vec3> out(n);
+	std::vector<Matrix> outM(n);
+	std::vector<float> outF(n);
+
+	Map(h, "MathExtras", "Vec3*Quaternion", out, [&](std::size_t i) { return v[i] * q[i]; });
+	Map(h, "MathExtras", "PerspectiveLH", outM, [&](std::size_t i) { return PerspectiveLH(f[i], 16.f / 9.f, 0.1f, 100.f); });
+	Map(h, "MathExtras", "LookAtLH", outM, [&](std::size_t i) { return LookAtLH(v[i], Vec3::Zero, Vec3::UnitY); });
+	Map(h, "MathExtras", "Radians", outF, [&](std::size_t i) { return Radians(f[i]); });
+	Map(h, "MathExtras", "Degrees", outF, [&](std::size_t i) { return Degrees(f[i]); });
+}
+
+void BenchVectorStream(Harness& h, std::size_t n)
+{
+	auto in = Generate<Vec3>(n, RandomVec3);
+	std::vector<Vec3> out(n);
+	Quaternion q = RandomQuaternion();
+	Transform t = RandomTransform();
+
+	h.Run("VectorStream", "RotateStream", n, [&] {
+		RotateStream(q, in.data(), out.data(), n);
+		DoNotOptimize(out.data());
+	});
+	h.Run("VectorStream", "TransformStream", n, [&] {
+		TransformStream(t, in.data(), out.data(), n);
+		DoNotOptimize(out.data());
+	});
+	h.Run("VectorStream", "TransformNormalStream", n, [&] {
+		TransformNormalStream(t, in.data(), out.data(), n);
+		DoNotOptimize(out.data());
+	});
+}
+
+void BenchFrustum(Harness& h, std::size_t n)
+{
+	// Scattered all around the camera, so roughly a quarter of them end up visible -
+	//  no help for the branch predictor in the one-at-a-time versions
+	auto spheres = Generate<BoundingSphere>(n, [] { return BoundingSphere(RandomVec3() * 5.f, RandomFloat(0.1f, 3.f)); });
+	auto boxes = Generate<AABB>(n, [] {
+		Vec3 c = RandomVec3() * 5.f;
+		Vec3 e(RandomFloat(0.1f, 3.f), RandomFloat(0.1f, 3.f), RandomFloat(0.1f, 3.f));
+		return AABB(c - e, c + e);
+	});
+	std::vector<std::uint8_t> outB(n);
+	VisibilitySet visibility;
+
+	Matrix viewProj = LookAtLH(Vec3::Zero, Vec3::UnitZ, Vec3::UnitY) * PerspectiveLH(Radians(80.f), 16.f / 9.f, 0.1f, 100.f);
+	Frustum frustum(viewProj);
+
+	std::vector<Frustum> frustums(n);
+	Map(h, "Frustum", "Frustum(viewProj)", frustums, [&](std::size_t) { return Frustum(viewProj); });
+	Map(h, "Frustum", "Intersects(BoundingSphere)", outB, [&](std::size_t i) { return (std::uint8_t)frustum.Intersects(spheres[i]); });
+	Map(h, "Frustum", "Intersects(AABB)", outB, [&](std::size_t i) { return (std::uint8_t)frustum.Intersects(boxes[i]); });
+
+	h.Run("Frustum", "CullSpheres", n, [&] {
+		frustum.CullSpheres(spheres.data(), n, visibility);
+		DoNotOptimize(&visibility);
+	});
+	h.Run("Frustum", "CullBoxes", n, [&] {
+		frustum.CullBoxes(boxes.data(), n, visibility);
+		DoNotOptimize(&visibility);
+	});
+}
+
+void BenchBounds(Harness& h, std::size_t n)
+{
+	// Per point, for a mesh of n vertices
+	auto points = Generate<Vec3>(n, RandomVec3);
+	std::vector<Bounds> outBounds(1u);
+
+	h.Run("Bounds", "AABB::FromPoints", n, [&] {
+		outBounds[0].Box = AABB::FromPoints(&points[0].x, n);
+		DoNotOptimize(outBounds.data());
+	});
+	h.Run("Bounds", "BoundingSphere::FromPoints", n, [&] {
+		outBounds[0].Sphere = BoundingSphere::FromPoints(&points[0].x, n);
+		DoNotOptimize(outBounds.data());
+	});
+
+	auto localBounds = Generate<Bounds>(n, [] {
+		Vec3 c = RandomVec3();
+		return Bounds(AABB(c - Vec3::Ones, c + Vec3::Ones), BoundingSphere(c, 1.7f));
+	});
+	auto models = Generate<Matrix>(n, [] { return RandomTransform().GetTransformMatrix(); });
+	std::vector<Bounds> worldBounds(n);
+	Map(h, "Bounds", "Bounds::Transformed", worldBounds, [&](std::size_t i) { return localBounds[i].Transformed(models[i]); });
+}
+
+void BenchSkinning(Harness& h, std::size_t n)
+{
+	const std::size_t BONE_COUNT = 64u;
+
+	auto bones = Generate<Transform>(BONE_COUNT, [] { return Transform(RandomVec3(), RandomQuaternion(), Vec3::Ones); });
+	std::vector<DualQuaternion> dqPalette(BONE_COUNT);
+	std::vector<Matrix> matrixPalette(BONE_COUNT);
+	for (std::size_t i = 0u; i < BONE_COUNT; i++)
+	{
+		dqPalette[i] = DualQuaternion::FromTransform(bones[i]);
+		matrixPalette[i] = bones[i].GetTransformMatrix();
+	}
+
+	auto a = Generate<DualQuaternion>(n, [] { return DualQuaternion::FromTransform(RandomTransform()); });
+	auto b = Generate<DualQuaternion>(n, [] { return DualQuaternion::FromTransform(RandomTransform()); });
+	auto t = Generate<Transform>(n, RandomTransform);
+	auto positions = Generate<Vec3>(n, RandomVec3);
+	auto normals = Generate<Vec3>(n, [] { return RandomVec3().Normal(); });
+	auto influences = Generate<SkinInfluences>(n, [] {
+		float w0 = RandomFloat(0.f, 1.f), w1 = RandomFloat(0.f, 1.f - w0), w2 = RandomFloat(0.f, 1.f - w0 - w1);
+		auto bone = [] { return (std::uint16_t)(RandomFloat(0.f, (float)BONE_COUNT - 0.01f)); };
+		return SkinInfluences{ { w0, w1, w2, 1.f - w0 - w1 - w2 }, { bone(), bone(), bone(), bone() } };
+	});
+	std::vector<DualQuaternion> out(n);
+	std::vector<Vec3> outV(n);
+	std::vector<Vec3> outN(n);
+
+	Map(h, "DualQuaternion", "FromTransform", out, [&](std::size_t i) { return DualQuaternion::FromTransform(t[i]); });
+	Map(h, "DualQuaternion", "operator*", out, [&](std::size_t i) { return a[i] * b[i]; });
+	Map(h, "DualQuaternion", "TransformPoint", outV, [&](std::size_t i) { return a[i].TransformPoint(positions[i]); });
+	Map(h, "DualQuaternion", "Blend", out, [&](std::size_t i) { return DualQuaternion::Blend(dqPalette.data(), influences[i]); });
+
+	h.Run("DualQuaternion", "SkinVertices", n, [&] {
+		SkinVertices(dqPalette.data(), influences.data(), positions.data(), normals.data(), outV.data(), outN.data(), n);
+		DoNotOptimize(outV.data());
+		DoNotOptimize(outN.data());
+	});
+
+	// For comparison: classic linear blend skinning, summing the four bone matrices
+	h.Run("DualQuaternion", "MatrixPaletteSkinning", n, [&] {
+		for (std::size_t i = 0u; i < n; i++)
+		{
+			const SkinInfluences& inf = influences[i];
+			Matrix blended;
+			for (int r = 0; r < 3; r++)
+			{
+				for (int c = 0; c < 4; c++)
+				{
+					blended.m[r][c] =
+						matrixPalette[inf.Bones[0]].m[r][c] * inf.Weights[0] + matrixPalette[inf.Bones[1]].m[r][c] * inf.Weights[1] +
+						matrixPalette[inf.Bones[2]].m[r][c] * inf.Weights[2] + matrixPalette[inf.Bones[3]].m[r][c] * inf.Weights[3];
+				}
+			}
+			outV[i] = blended.TransformPoint(positions[i]);
+			outN[i] = blended.TransformDirection(normals[i]).Normal();
+		}
+		DoNotOptimize(outV.data());
+		DoNotOptimize(outN.data());
+	});
+}
+
+// Same inputs as the sess versions above, so the rows line up one for one
+void BenchAssimp(Harness& h, std::size_t n)
+{
+	std::vector<aiMatrix4x4> a(n);
+	std::vector<aiMatrix4x4> b(n);
+	std::vector<aiVector3D> p;
+	std::vector<aiVector3D> scale;
+	std::vector<aiVector3D> pos;
+	p.reserve(n);
+	scale.reserve(n);
+	pos.reserve(n);
+	std::vector<aiQuaternion> qa(n);
+	std::vector<aiQuaternion> qb(n);
+	for (std::size_t i = 0u; i < n; i++)
+	{
+		Transform ta = RandomTransform();
+		a[i] = ToAi(ta.GetTransformMatrix());
+		b[i] = ToAi(RandomTransform().GetTransformMatrix());
+		p.push_back(ToAi(RandomVec3()));
+		scale.push_back(ToAi(ta.Scale));
+		pos.push_back(ToAi(ta.Position));
+		qa[i] = ToAi(ta.Rotation);
+		qb[i] = ToAi(RandomQuaternion());
+	}
+	std::vector<aiMatrix4x4> out(n);
+	std::vector<aiVector3D> outV(n);
+	std::vector<aiQuaternion> outQ(n);
+	std::vector<float> outF(n);
+
+	Map(h, "assimp", "aiMatrix4x4::Transpose", out, [&](std::size_t i) { aiMatrix4x4 r = a[i]; r.Transpose(); return r; });
+	Map(h, "assimp", "aiMatrix4x4::Determinant", outF, [&](std::size_t i) { return a[i].Determinant(); });
+	Map(h, "assimp", "aiMatrix4x4::Inverse", out, [&](std::size_t i) { aiMatrix4x4 r = a[i]; r.Inverse(); return r; });
+	Map(h, "assimp", "aiMatrix4x4::operator*", out, [&](std::size_t i) { return a[i] * b[i]; });
+	Map(h, "assimp", "aiMatrix4x4*aiVector3D", outV, [&](std::size_t i) { return a[i] * p[i]; });
+	Map(h, "assimp", "aiMatrix4x4(scale,rot,pos)", out, [&](std::size_t i) { return aiMatrix4x4(scale[i], qa[i], pos[i]); });
+	Map(h, "assimp", "aiMatrix4x4::Decompose", outQ, [&](std::size_t i) {
+		aiVector3D s, t;
+		aiQuaternion r;
+		a[i].Decompose(s, r, t);
+		return r;
+	});
+	Map(h, "assimp", "aiQuaternion::operator*", outQ, [&](std::size_t i) { return qa[i] * qb[i]; });
+	Map(h, "assimp", "aiQuaternion(aiMatrix3x3)", outQ, [&](std::size_t i) { return aiQuaternion(aiMatrix3x3(a[i])); });
+	Map(h, "assimp", "aiQuaternion::Interpolate", outQ, [&](std::size_t i) {
+		aiQuaternion r;
+		aiQuaternion::Interpolate(r, qa[i], qb[i], 0.3f);
+		return r;
+	});
+	Map(h, "assimp", "aiQuaternion::Rotate", outV, [&](std::size_t i) { return qa[i].Rotate(p[i]); });
+}
+
+};
+
+int main(int argc, char** argv)
+{
+	Harness h(argc, argv);
+
+	// One size at a time, and each group frees its arrays before the next one starts -
+	//  at a million elements a single array of matrices is already 64MB
+	for (std::size_t n : SCALES)
+	{
+		BenchVec3(h, n);
+		BenchMatrix(h, n);
+		BenchAffine3x4(h, n);
+		BenchQuaternion(h, n);
+		BenchTransform(h, n);
+		BenchMathExtras(h, n);
+		BenchVectorStream(h, n);
+		BenchFrustum(h, n);
+		BenchBounds(h, n);
+		BenchSkinning(h, n);
+		BenchAssimp(h, n);
+	}
+
+	return h.WriteJson() ? 0 : 1;
+}
@@ -0,0 +1,100 @@
+// Asset pack checks (see ../common/AssetPack.h): packed entries come back byte for byte,
+//  compressed or not, names are matched the way the header says, and anything not in the
+//  pack falls back to the loose file.
+
+#include "Check.h"
+
+#include <AssetPack.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+using namespace sess;
+
+namespace
+{
+
+const char* PACK_FILE = "check-asset-pack.pack";
+const char* TRUNCATED_PACK_FILE = "check-asset-pack-truncated.pack";
+const char* LOOSE_FILE = "check-asset-pack-loose.txt";
+
+bool Matches(const AssetData& data, const std::vector<std::uint8_t>& expected)
+{
+	return data.GetSize() == expected.size() && (expected.empty() || memcmp(data.GetData(), expected.data(), expected.size()) == 0);
+}
+
+};
+
+int main()
+{
+	// Slashes, case and leading ./ and ../ don't matter
+	SESS_CHECK(AssetPack::NormalizeName("../assets\\Road.FBX") == "assets/road.fbx");
+	SESS_CHECK(AssetPack::NormalizeName("./../x") == "x");
+
+	std::vector<std::uint8_t> repetitive(100000u, 7u);
+	std::vector<std::uint8_t> small = { 1u, 2u, 3u };
+	std::vector<std::uint8_t> noisy(5000u);
+	for (std::size_t i = 0u; i < noisy.size(); i++)
+	{
+		noisy[i] = std::uint8_t((i * 2654435761u) >> 13u);
+	}
+
+	AssetPackWriter writer;
+	SESS_CHECK(writer.Add("../check/Repetitive.bin", repetitive, AssetPack::Compression::Zlib));
+	SESS_CHECK(writer.Add("check/small.bin", small, AssetPack::Compression::None));
+	SESS_CHECK(writer.Add("check/noisy.bin", noisy, AssetPack::Compression::Zlib));
+	SESS_CHECK(writer.Add("check/empty.bin", {}, AssetPack::Compression::Zlib));
+	SESS_CHECK(!writer.Add("./check/SMALL.bin", small, AssetPack::Compression::None)); // Same name once normalized
+	SESS_CHECK(writer.Write(PACK_FILE));
+	std::ofstream(LOOSE_FILE) << "hello";
+
+	// Everything that maps a file is gone before the files get removed
+	{
+		AssetData data;
+		{
+			// Without a pack, everything is a loose file
+			AssetPack noPack;
+			SESS_CHECK(!noPack.Open("check-asset-pack-missing.pack"));
+			SESS_CHECK(noPack.Load(LOOSE_FILE, data) && data.GetSize() == 5u && memcmp(data.GetData(), "hello", 5u) == 0);
+		}
+
+		{
+			AssetPack pack;
+			SESS_CHECK(pack.Open(PACK_FILE));
+			SESS_CHECK(pack.Contains("../CHECK/repetitive.bin") && !pack.Contains(LOOSE_FILE));
+			SESS_CHECK(pack.Load("check/repetitive.bin", data) && Matches(data, repetitive));
+			SESS_CHECK(pack.Load("check/noisy.bin", data) && Matches(data, noisy));
+			SESS_CHECK(pack.Load("check/empty.bin", data) && data.GetSize() == 0u);
+
+			// Uncompressed entries are used in place, and entries start 16 byte aligned
+			SESS_CHECK(pack.Load("check/small.bin", data) && Matches(data, small) && reinterpret_cast<std::uintptr_t>(data.GetData()) % 16u == 0u);
+
+			SESS_CHECK(pack.Load(LOOSE_FILE, data) && data.GetSize() == 5u);
+			SESS_CHECK(!pack.Load("check/not-there.bin", data));
+		}
+
+		// 100KB of the same byte should squash down to almost nothing
+		std::ifstream packed(PACK_FILE, std::ios::binary | std::ios::ate);
+		SESS_CHECK(std::size_t(packed.tellg()) < noisy.size() + small.size() + 1200u);
+		packed.close();
+
+		// A pack that got cut short is rejected outright, and loose files still work
+		{
+			std::vector<char> start(200u);
+			std::ifstream(PACK_FILE, std::ios::binary).read(start.data(), start.size());
+			std::ofstream(TRUNCATED_PACK_FILE, std::ios::binary).write(start.data(), start.size());
+
+			AssetPack truncated;
+			SESS_CHECK(!truncated.Open(TRUNCATED_PACK_FILE));
+			SESS_CHECK(truncated.Load(LOOSE_FILE, data));
+		}
+	}
+
+	remove(PACK_FILE);
+	remove(TRUNCATED_PACK_FILE);
+	remove(LOOSE_FILE);
+	return check::Finish("asset-pack-check");
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+// Bare-bones checks for the guarantees the headers in ../common promise - round trips,
+//  error bounds, "same output no matter the thread count" and so on. Same idea as
+//  ../benchmarks/Bench.h: just enough to not need another dependency.
+//  - SESS_CHECK(condition) prints the file, line and condition if it doesn't hold, and
+//    keeps going so one run shows everything that's wrong
+//  - Finish() prints a one line summary and gives back what main should return
+
+#include <cstdio>
+
+namespace sess
+{
+namespace check
+{
+
+inline int& FailureCount()
+{
+	static int failures = 0;
+	return failures;
+}
+
+// Returns whether it passed, so a check can guard the ones after it
+inline bool Record(bool passed, const char* condition, const char* file, int line)
+{
+	if (!passed)
+	{
+		std::fprintf(stderr, "%s:%d: check failed: %s\n", file, line, condition);
+		FailureCount()++;
+	}
+	return passed;
+}
+
+inline int Finish(const char* name)
+{
+	if (FailureCount() > 0)
+	{
+		std::printf("%s: %d check(s) failed\n", name, FailureCount());
+		return 1;
+	}
+	std::printf("%s: all checks passed\n", name);
+	return 0;
+}
+
+};
+};
+
+#define SESS_CHECK(condition) ::sess::check::Record((condition), #condition, __FILE__, __LINE__)
@@ -0,0 +1,42 @@
+// 16-bit index checks (see ../common/IndexFormat.h): the vertex limit sits exactly where a
+//  16-bit index runs out, and narrowing keeps every index that fits.
+
+#include "Check.h"
+
+#include <IndexFormat.h>
+
+#include <cstdint>
+#include <vector>
+
+using namespace sess;
+
+int main()
+{
+	// Indices 0..65535 can pick 65536 vertices, and not one more
+	SESS_CHECK(FitsShortIndices(0u));
+	SESS_CHECK(FitsShortIndices(0x10000u));
+	SESS_CHECK(!FitsShortIndices(0x10001u));
+
+	// Every index a mesh that fits can have comes through unchanged
+	std::vector<std::uint32_t> indices(MAX_16BIT_INDEX_VERTICES);
+	for (std::uint32_t i = 0u; i < MAX_16BIT_INDEX_VERTICES; i++)
+	{
+		indices[i] = MAX_16BIT_INDEX_VERTICES - 1u - i;
+	}
+	std::vector<std::uint16_t> narrowed;
+	NarrowIndices(indices, narrowed);
+	bool unchanged = narrowed.size() == indices.size();
+	for (std::size_t i = 0u; i < indices.size() && unchanged; i++)
+	{
+		unchanged &= (narrowed[i] == indices[i]);
+	}
+	SESS_CHECK(unchanged);
+
+	// out is sized to match, whatever was in it before
+	NarrowIndices({ 2u, 1u, 0u }, narrowed);
+	SESS_CHECK(narrowed == std::vector<std::uint16_t>({ 2u, 1u, 0u }));
+	NarrowIndices({}, narrowed);
+	SESS_CHECK(narrowed.empty());
+
+	return check::Finish("index-format-check");
+}
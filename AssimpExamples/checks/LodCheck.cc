@@ -0,0 +1,198 @@
+// LOD checks (see ../common/MeshSimplifier.h and LodSelector.h): simplified meshes keep
+//  their borders, seams and facing, and the selector only ever moves one way as the camera
+//  does, without flickering at the thresholds.
+
+#include "Check.h"
+
+#include <LodSelector.h>
+#include <MathExtras.h>
+#include <MeshSimplifier.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <set>
+#include <vector>
+
+using namespace sess;
+
+namespace
+{
+
+void CheckSimplifySphere()
+{
+	// A UV sphere with a seam down one side (the first and last column of vertices are in
+	//  the same place) and no triangles touching the poles, so the ring next to each pole
+	//  is a border
+	const std::uint32_t segments = 48u;
+	std::vector<Vec3> positions;
+	std::vector<std::uint32_t> indices;
+	for (std::uint32_t ring = 0u; ring <= segments; ring++)
+	{
+		for (std::uint32_t slice = 0u; slice <= segments; slice++)
+		{
+			float theta = 3.14159265f * ring / segments;
+			float phi = 6.28318531f * slice / segments;
+			positions.push_back(Vec3(sinf(theta) * cosf(phi), cosf(theta), sinf(theta) * sinf(phi)));
+		}
+	}
+	for (std::uint32_t ring = 0u; ring < segments; ring++)
+	{
+		for (std::uint32_t slice = 0u; slice < segments; slice++)
+		{
+			std::uint32_t a = ring * (segments + 1u) + slice;
+			std::uint32_t b = a + 1u;
+			std::uint32_t c = a + segments + 1u;
+			std::uint32_t d = c + 1u;
+			if (ring > 0u)
+			{
+				indices.insert(indices.end(), { a, b, c });
+			}
+			if (ring < segments - 1u)
+			{
+				indices.insert(indices.end(), { b, d, c });
+			}
+		}
+	}
+
+	float previousError = 0.f;
+	for (float ratio : { 0.5f, 0.25f, 0.1f })
+	{
+		std::vector<std::uint32_t> simplified(indices.size());
+		std::size_t target = std::size_t(indices.size() / 3u * ratio) * 3u;
+		float error = -1.f;
+		std::size_t count = SimplifyMesh(simplified.data(), indices.data(), indices.size(), &positions[0].x, sizeof(Vec3), positions.size(), target, &error);
+		SESS_CHECK(count > 0u && count <= target);
+
+		// Coarser never claims to be more accurate, and it still looks like a sphere
+		SESS_CHECK(error >= previousError && error < 0.2f);
+		previousError = error;
+
+		bool noDegenerates = true;
+		bool facingOut = true;
+		float worstDeviation = 0.f;
+		for (std::size_t i = 0u; i < count; i += 3u)
+		{
+			const Vec3& a = positions[simplified[i]];
+			const Vec3& b = positions[simplified[i + 1u]];
+			const Vec3& c = positions[simplified[i + 2u]];
+			Vec3 middle = (a + b + c) * (1.f / 3.f);
+			noDegenerates &= (simplified[i] != simplified[i + 1u] && simplified[i + 1u] != simplified[i + 2u] && simplified[i] != simplified[i + 2u]);
+			facingOut &= (Vec3::Dot(Vec3::Cross(b - a, c - a), middle) > 0.f);
+			worstDeviation = std::max(worstDeviation, 1.f - middle.Magnitude());
+		}
+		SESS_CHECK(noDegenerates);
+		SESS_CHECK(facingOut);
+		SESS_CHECK(worstDeviation < 0.1f);
+
+		// Both sides of the seam are still there, on every ring that has one
+		std::set<std::uint32_t> used(simplified.begin(), simplified.begin() + count);
+		bool seamKept = true;
+		for (std::uint32_t ring = 1u; ring < segments; ring++)
+		{
+			seamKept &= (used.count(ring * (segments + 1u)) == 1u && used.count(ring * (segments + 1u) + segments) == 1u);
+		}
+		SESS_CHECK(seamKept);
+	}
+}
+
+void CheckSimplifyBorder()
+{
+	// A nearly flat grid - the simplified version should cover exactly the same area, with
+	//  every vertex along the outside left where it was
+	const std::uint32_t size = 30u;
+	std::vector<Vec3> positions;
+	std::vector<std::uint32_t> indices;
+	for (std::uint32_t y = 0u; y <= size; y++)
+	{
+		for (std::uint32_t x = 0u; x <= size; x++)
+		{
+			positions.push_back(Vec3(float(x), float(y), 0.01f * sinf(x * 0.3f)));
+		}
+	}
+	for (std::uint32_t y = 0u; y < size; y++)
+	{
+		for (std::uint32_t x = 0u; x < size; x++)
+		{
+			std::uint32_t a = y * (size + 1u) + x;
+			indices.insert(indices.end(), { a, a + 1u, a + size + 1u, a + 1u, a + size + 2u, a + size + 1u });
+		}
+	}
+
+	std::vector<std::uint32_t> simplified(indices.size());
+	float error = -1.f;
+	std::size_t count = SimplifyMesh(simplified.data(), indices.data(), indices.size(), &positions[0].x, sizeof(Vec3), positions.size(), indices.size() / 30u * 3u, &error);
+	SESS_CHECK(count < indices.size() / 4u);
+
+	std::set<std::uint32_t> used(simplified.begin(), simplified.begin() + count);
+	bool borderKept = true;
+	for (std::uint32_t k = 0u; k <= size; k++)
+	{
+		borderKept &= used.count(k) == 1u && used.count(size * (size + 1u) + k) == 1u;
+		borderKept &= used.count(k * (size + 1u)) == 1u && used.count(k * (size + 1u) + size) == 1u;
+	}
+	SESS_CHECK(borderKept);
+
+	double area = 0.0;
+	for (std::size_t i = 0u; i < count; i += 3u)
+	{
+		const Vec3& a = positions[simplified[i]];
+		area += 0.5 * Vec3::Cross(positions[simplified[i + 1u]] - a, positions[simplified[i + 2u]] - a).Magnitude();
+	}
+	SESS_CHECK(std::fabs(area - double(size * size)) < 1.0);
+}
+
+void CheckSelector()
+{
+	// Level 2's error is smaller than level 1's - it gets treated as level 1's instead
+	LodSelector selector;
+	selector.SetLevelErrors({ 0.f, 0.01f, 0.005f, 0.1f });
+	const float pixelsPerUnit = LodSelector::PixelsPerUnit(Radians(80.f), 720.f);
+	const BoundingSphere sphere(Vec3::Zero, 1.f);
+
+	// Walking away only ever goes coarser, and walking back only ever finer
+	bool coarserOnly = true;
+	std::uint32_t level = 0u;
+	for (float distance = 2.f; distance < 200.f; distance += 0.5f)
+	{
+		std::uint32_t next = selector.Select(sphere, 1.f, Vec3(0.f, 0.f, -distance), pixelsPerUnit);
+		coarserOnly &= (next >= level);
+		level = next;
+	}
+	SESS_CHECK(coarserOnly);
+	SESS_CHECK(level == 3u);
+
+	bool finerOnly = true;
+	for (float distance = 200.f; distance > 2.f; distance -= 0.5f)
+	{
+		std::uint32_t next = selector.Select(sphere, 1.f, Vec3(0.f, 0.f, -distance), pixelsPerUnit);
+		finerOnly &= (next <= level);
+		level = next;
+	}
+	SESS_CHECK(finerOnly);
+	SESS_CHECK(level == 0u);
+
+	// Wobbling back and forth right at a threshold doesn't flicker
+	selector.SetLevelErrors({ 0.f, 0.01f });
+	const float threshold = 0.01f * pixelsPerUnit + 1.f;
+	level = selector.Select(sphere, 1.f, Vec3(0.f, 0.f, -threshold), pixelsPerUnit);
+	int switches = 0;
+	for (int step = 0; step < 100; step++)
+	{
+		float wobble = (step & 1) ? 0.3f : -0.3f;
+		std::uint32_t next = selector.Select(sphere, 1.f, Vec3(0.f, 0.f, -(threshold + wobble)), pixelsPerUnit);
+		switches += (next != level) ? 1 : 0;
+		level = next;
+	}
+	SESS_CHECK(switches == 0);
+}
+
+};
+
+int main()
+{
+	CheckSimplifySphere();
+	CheckSimplifyBorder();
+	CheckSelector();
+	return check::Finish("lod-check");
+}
@@ -0,0 +1,375 @@
+// Everything in ../common that has an SSE/AVX path, run on the same made up inputs every
+//  time. This file doesn't know which copy it's in (see MathCases.h) - it just writes down
+//  whatever comes out, and MathCheck.cc compares the two.
+
+#include "MathCases.h"
+
+#include <Affine3x4.h>
+#include <Bounds.h>
+#include <DualQuaternion.h>
+#include <Frustum.h>
+#include <MathExtras.h>
+#include <TransformSoA.h>
+#include <VectorStream.h>
+
+#include <random>
+
+namespace sess
+{
+
+namespace
+{
+
+// Not a multiple of 4 or 8, so every batch function has leftovers to deal with
+constexpr std::size_t COUNT = 37u;
+
+// How far apart the copies can be, relative to the values:
+//  - SAME_ORDER: the SIMD code does the same math in the same order, so the only
+//    difference is the compiler fusing multiply-adds in the scalar copy (1 ulp each)
+//  - REORDERED: same math, different order (dot products added up pairwise, a rotation
+//    turned into a matrix first...) - a few ulps, more through a division or sqrt
+constexpr float SAME_ORDER = 4e-7f;
+constexpr float REORDERED = 1e-5f;
+
+float Random(std::mt19937& rng, float lo, float hi)
+{
+	return std::uniform_real_distribution<float>(lo, hi)(rng);
+}
+
+Vec3 RandomVec3(std::mt19937& rng, float lo, float hi)
+{
+	float x = Random(rng, lo, hi);
+	float y = Random(rng, lo, hi);
+	float z = Random(rng, lo, hi);
+	return Vec3(x, y, z);
+}
+
+// Normalized by the constructor
+Quaternion RandomRotation(std::mt19937& rng)
+{
+	float w = Random(rng, -1.f, 1.f);
+	float x = Random(rng, -1.f, 1.f);
+	float y = Random(rng, -1.f, 1.f);
+	float z = Random(rng, -1.f, 1.f);
+	return Quaternion(w, x, y, z);
+}
+
+// Positive scale only - a mirrored transform is fine for matrices, but not for dual
+//  quaternions or TransformNormalStream
+Transform RandomTransform(std::mt19937& rng)
+{
+	Vec3 position = RandomVec3(rng, -10.f, 10.f);
+	Quaternion rotation = RandomRotation(rng);
+	Vec3 scale = RandomVec3(rng, 0.5f, 2.f);
+	return Transform(position, rotation, scale);
+}
+
+// Mostly diagonal, so it's nowhere near singular and the inverses are well behaved
+Matrix RandomMatrix(std::mt19937& rng)
+{
+	Matrix m;
+	for (int row = 0; row < 4; row++)
+	{
+		for (int col = 0; col < 4; col++)
+		{
+			m.m[row][col] = Random(rng, -1.f, 1.f) + ((row == col) ? 3.f : 0.f);
+		}
+	}
+	return m;
+}
+
+void Append(std::vector<float>& out, const Vec3& v)
+{
+	out.insert(out.end(), { v.x, v.y, v.z });
+}
+
+void Append(std::vector<float>& out, const Quaternion& q)
+{
+	out.insert(out.end(), { q.x, q.y, q.z, q.w });
+}
+
+void Append(std::vector<float>& out, const Matrix& m)
+{
+	out.insert(out.end(), &m.m[0][0], &m.m[0][0] + 16);
+}
+
+void Append(std::vector<float>& out, const Affine3x4& m)
+{
+	out.insert(out.end(), &m.m[0][0], &m.m[0][0] + 12);
+}
+
+void Append(std::vector<float>& out, const DualQuaternion& dq)
+{
+	Append(out, dq.Real);
+	Append(out, dq.Dual);
+}
+
+void AddMatrixCases(std::mt19937& rng, std::vector<MathCase>& cases)
+{
+	std::vector<Matrix> a(COUNT), b(COUNT), out(COUNT);
+	for (std::size_t i = 0u; i < COUNT; i++)
+	{
+		a[i] = RandomMatrix(rng);
+		b[i] = RandomMatrix(rng);
+	}
+
+	MathCase product = { "Matrix::operator*", {}, SAME_ORDER };
+	MathCase determinant = { "Matrix::Determinant", {}, REORDERED };
+	MathCase inverse = { "Matrix::Inverse", {}, REORDERED };
+	for (std::size_t i = 0u; i < COUNT; i++)
+	{
+		Append(product.Values, a[i] * b[i]);
+		determinant.Values.push_back(a[i].Determinant());
+		Append(inverse.Values, a[i].Inverse());
+	}
+
+	MathCase batch = { "Matrix::MultiplyBatch", {}, SAME_ORDER };
+	Matrix::MultiplyBatch(a.data(), b.data(), out.data(), COUNT);
+	for (auto&& m : out) Append(batch.Values, m);
+
+	// out = a, then out = out * b - every row of a has to be read before it's overwritten
+	MathCase aliased = { "Matrix::MultiplyBatch (out is a)", {}, SAME_ORDER };
+	out = a;
+	Matrix::MultiplyBatch(out.data(), b.data(), out.data(), COUNT);
+	for (auto&& m : out) Append(aliased.Values, m);
+
+	MathCase inverseAffine = { "Matrix::InverseAffine", {}, REORDERED };
+	std::vector<Vec3> points(COUNT), transformed(COUNT);
+	for (std::size_t i = 0u; i < COUNT; i++)
+	{
+		Append(inverseAffine.Values, RandomTransform(rng).GetTransformMatrix().InverseAffine());
+		points[i] = RandomVec3(rng, -10.f, 10.f);
+	}
+
+	MathCase transformPoints = { "Matrix::TransformPoints", {}, SAME_ORDER };
+	const Matrix m = RandomTransform(rng).GetTransformMatrix();
+	Matrix::TransformPoints(m, points.data(), transformed.data(), COUNT);
+	for (auto&& p : transformed) Append(transformPoints.Values, p);
+
+	MathCase transformPointsInPlace = { "Matrix::TransformPoints (in place)", {}, SAME_ORDER };
+	Matrix::TransformPoints(m, points.data(), points.data(), COUNT);
+	for (auto&& p : points) Append(transformPointsInPlace.Values, p);
+
+	cases.insert(cases.end(), { product, determinant, inverse, batch, aliased, inverseAffine, transformPoints, transformPointsInPlace });
+}
+
+void AddAffineCases(std::mt19937& rng, std::vector<MathCase>& cases)
+{
+	std::vector<Affine3x4> a(COUNT), b(COUNT), out(COUNT);
+	for (std::size_t i = 0u; i < COUNT; i++)
+	{
+		a[i] = Affine3x4(RandomTransform(rng).GetTransformMatrix());
+		b[i] = Affine3x4(RandomTransform(rng).GetTransformMatrix());
+	}
+
+	MathCase product = { "Affine3x4::operator*", {}, SAME_ORDER };
+	MathCase inverse = { "Affine3x4::Inverse", {}, REORDERED };
+	MathCase points = { "Affine3x4::TransformPoint", {}, SAME_ORDER };
+	MathCase normals = { "Affine3x4::TransformNormal", {}, REORDERED };
+	for (std::size_t i = 0u; i < COUNT; i++)
+	{
+		Append(product.Values, a[i] * b[i]);
+		Append(inverse.Values, a[i].Inverse());
+		Vec3 v = RandomVec3(rng, -1.f, 1.f);
+		Append(points.Values, a[i].TransformPoint(v));
+		Append(normals.Values, a[i].TransformNormal(v));
+	}
+
+	MathCase batch = { "Affine3x4::MultiplyBatch", {}, SAME_ORDER };
+	Affine3x4::MultiplyBatch(a.data(), b.data(), out.data(), COUNT);
+	for (auto&& m : out) Append(batch.Values, m);
+
+	MathCase aliased = { "Affine3x4::MultiplyBatch (out is b)", {}, SAME_ORDER };
+	out = b;
+	Affine3x4::MultiplyBatch(a.data(), out.data(), out.data(), COUNT);
+	for (auto&& m : out) Append(aliased.Values, m);
+
+	cases.insert(cases.end(), { product, inverse, points, normals, batch, aliased });
+}
+
+void AddStreamCases(std::mt19937& rng, std::vector<MathCase>& cases)
+{
+	TransformSoA soa;
+	for (std::size_t i = 0u; i < COUNT; i++)
+	{
+		soa.Add(RandomTransform(rng));
+	}
+	std::vector<Matrix> matrices(COUNT);
+	soa.ComputeMatrices(matrices.data(), COUNT);
+	MathCase soaCase = { "TransformSoA::ComputeMatrices", {}, SAME_ORDER };
+	for (auto&& m : matrices) Append(soaCase.Values, m);
+
+	std::vector<Vec3> in(COUNT), out(COUNT);
+	for (auto&& v : in) v = RandomVec3(rng, -1.f, 1.f);
+	const Quaternion q = RandomRotation(rng);
+	const Transform t = RandomTransform(rng);
+
+	MathCase rotate = { "RotateStream", {}, SAME_ORDER };
+	RotateStream(q, in.data(), out.data(), COUNT);
+	for (auto&& v : out) Append(rotate.Values, v);
+
+	MathCase transform = { "TransformStream", {}, SAME_ORDER };
+	TransformStream(t, in.data(), out.data(), COUNT);
+	for (auto&& v : out) Append(transform.Values, v);
+
+	MathCase normals = { "TransformNormalStream", {}, REORDERED };
+	TransformNormalStream(t, in.data(), out.data(), COUNT);
+	for (auto&& v : out) Append(normals.Values, v);
+
+	MathCase inPlace = { "TransformStream (in place)", {}, SAME_ORDER };
+	TransformStream(t, in.data(), in.data(), COUNT);
+	for (auto&& v : in) Append(inPlace.Values, v);
+
+	cases.insert(cases.end(), { soaCase, rotate, transform, normals, inPlace });
+}
+
+void AddQuaternionCases(std::mt19937& rng, std::vector<MathCase>& cases)
+{
+	// Every fourth pair is nearly the same rotation (Slerp falls back to Nlerp there), and
+	//  every fourth is the same rotation with the signs flipped (it has to go the short way)
+	std::vector<Quaternion> a(COUNT), b(COUNT), out(COUNT);
+	for (std::size_t i = 0u; i < COUNT; i++)
+	{
+		a[i] = RandomRotation(rng);
+		switch (i % 4u)
+		{
+		case 0u: b[i] = Quaternion(a[i].w + 1e-4f, a[i].x, a[i].y, a[i].z); break;
+		case 1u: b[i] = Quaternion::FromComponents(-a[i].w, -a[i].x, -a[i].y, -a[i].z); break;
+		default: b[i] = RandomRotation(rng); break;
+		}
+	}
+
+	MathCase nlerp = { "Quaternion::NlerpBatch", {}, REORDERED };
+	Quaternion::NlerpBatch(a.data(), b.data(), 0.3f, out.data(), COUNT);
+	for (auto&& q : out) Append(nlerp.Values, q);
+
+	MathCase unnormalized = { "Quaternion::NlerpBatch (no normalize)", {}, SAME_ORDER };
+	Quaternion::NlerpBatch(a.data(), b.data(), 0.3f, out.data(), COUNT, false);
+	for (auto&& q : out) Append(unnormalized.Values, q);
+
+	MathCase slerp = { "Quaternion::SlerpBatch", {}, REORDERED };
+	Quaternion::SlerpBatch(a.data(), b.data(), 0.7f, out.data(), COUNT);
+	for (auto&& q : out) Append(slerp.Values, q);
+
+	cases.insert(cases.end(), { nlerp, unnormalized, slerp });
+}
+
+void AddDualQuaternionCases(std::mt19937& rng, std::vector<MathCase>& cases)
+{
+	std::vector<DualQuaternion> palette(8u);
+	for (auto&& dq : palette) dq = DualQuaternion::FromTransform(RandomTransform(rng));
+
+	std::vector<SkinInfluences> influences(COUNT);
+	for (auto&& vert : influences)
+	{
+		float total = 0.f;
+		for (int slot = 0; slot < 4; slot++)
+		{
+			vert.Weights[slot] = Random(rng, 0.f, 1.f);
+			vert.Bones[slot] = static_cast<std::uint16_t>(rng() % palette.size());
+			total += vert.Weights[slot];
+		}
+		for (float& w : vert.Weights) w /= total;
+	}
+
+	std::vector<Vec3> positions(COUNT), normals(COUNT), outPositions(COUNT), outNormals(COUNT);
+	for (std::size_t i = 0u; i < COUNT; i++)
+	{
+		positions[i] = RandomVec3(rng, -10.f, 10.f);
+		normals[i] = RandomVec3(rng, -1.f, 1.f).Normal();
+	}
+
+	MathCase compose = { "DualQuaternion::operator*", {}, SAME_ORDER };
+	MathCase transform = { "DualQuaternion::TransformPoint", {}, REORDERED };
+	MathCase blend = { "DualQuaternion::Blend", {}, REORDERED };
+	for (std::size_t i = 0u; i < COUNT; i++)
+	{
+		const DualQuaternion& a = palette[i % palette.size()];
+		const DualQuaternion& b = palette[(i * 3u + 1u) % palette.size()];
+		Append(compose.Values, a * b);
+		Append(transform.Values, a.TransformPoint(positions[i]));
+		Append(blend.Values, DualQuaternion::Blend(palette.data(), influences[i]));
+	}
+
+	MathCase skin = { "SkinVertices", {}, REORDERED };
+	SkinVertices(palette.data(), influences.data(), positions.data(), normals.data(), outPositions.data(), outNormals.data(), COUNT);
+	for (std::size_t i = 0u; i < COUNT; i++)
+	{
+		Append(skin.Values, outPositions[i]);
+		Append(skin.Values, outNormals[i]);
+	}
+
+	// Nothing to blend - both copies have to come back with the identity, not NaNs
+	MathCase unweighted = { "DualQuaternion::Blend (all weights 0)", {}, 0.f };
+	Append(unweighted.Values, DualQuaternion::Blend(palette.data(), SkinInfluences{ { 0.f, 0.f, 0.f, 0.f }, { 1u, 2u, 3u, 4u } }));
+
+	cases.insert(cases.end(), { compose, transform, blend, skin, unweighted });
+}
+
+void AddBoundsCases(std::mt19937& rng, std::vector<MathCase>& cases)
+{
+	std::vector<float> xyz(COUNT * 3u);
+	for (float& f : xyz) f = Random(rng, -10.f, 10.f);
+
+	// All of them, and few enough that there's no full block for the SIMD loop
+	MathCase boxes = { "AABB::FromPoints", {}, 0.f };
+	MathCase spheres = { "BoundingSphere::FromPoints", {}, REORDERED };
+	for (std::size_t count : { COUNT, std::size_t(3u) })
+	{
+		AABB box = AABB::FromPoints(xyz.data(), count);
+		Append(boxes.Values, box.Min);
+		Append(boxes.Values, box.Max);
+		BoundingSphere sphere = BoundingSphere::FromPoints(xyz.data(), count);
+		Append(spheres.Values, sphere.Center);
+		spheres.Values.push_back(sphere.Radius);
+	}
+
+	cases.insert(cases.end(), { boxes, spheres });
+}
+
+void AddFrustumCases(std::mt19937& rng, std::vector<MathCase>& cases)
+{
+	const Frustum frustum(LookAtLH(Vec3(0.f, 2.f, -30.f), Vec3(5.f, 0.f, 0.f), Vec3::UnitY) * PerspectiveLH(PI / 3.f, 16.f / 9.f, 0.1f, 60.f));
+
+	// Enough of them that some are on every side of every plane
+	constexpr std::size_t BOUND_COUNT = 1003u;
+	std::vector<BoundingSphere> spheres(BOUND_COUNT);
+	std::vector<AABB> boxes(BOUND_COUNT);
+	for (std::size_t i = 0u; i < BOUND_COUNT; i++)
+	{
+		Vec3 center = RandomVec3(rng, -60.f, 60.f);
+		Vec3 extents = RandomVec3(rng, 0.f, 5.f);
+		spheres[i] = BoundingSphere(center, extents.x);
+		boxes[i] = AABB(center - extents, center + extents);
+	}
+
+	// One bit per bound - these have to match exactly
+	VisibilitySet visible;
+	MathCase sphereCase = { "Frustum::CullSpheres", {}, 0.f };
+	frustum.CullSpheres(spheres.data(), BOUND_COUNT, visible);
+	for (std::size_t i = 0u; i < BOUND_COUNT; i++) sphereCase.Values.push_back(visible.IsVisible(i) ? 1.f : 0.f);
+
+	MathCase boxCase = { "Frustum::CullBoxes", {}, 0.f };
+	frustum.CullBoxes(boxes.data(), BOUND_COUNT, visible);
+	for (std::size_t i = 0u; i < BOUND_COUNT; i++) boxCase.Values.push_back(visible.IsVisible(i) ? 1.f : 0.f);
+
+	cases.insert(cases.end(), { sphereCase, boxCase });
+}
+
+};
+
+std::vector<MathCase> RunMathCases()
+{
+	std::mt19937 rng(1u);
+	std::vector<MathCase> cases;
+	AddMatrixCases(rng, cases);
+	AddAffineCases(rng, cases);
+	AddStreamCases(rng, cases);
+	AddQuaternionCases(rng, cases);
+	AddDualQuaternionCases(rng, cases);
+	AddBoundsCases(rng, cases);
+	AddFrustumCases(rng, cases);
+	return cases;
+}
+
+};
@@ -0,0 +1,26 @@
+#pragma once
+
+// The math results math-check compares. MathCases.cc gets built twice into the same
+//  program (see the Makefile): once as is, and once with SESS_NO_SIMD and namespace sess
+//  renamed to sess_scalar, so the plain C++ fallback can run right next to the SSE/AVX
+//  code on exactly the same inputs.
+// MathCase is outside of namespace sess on purpose - both copies hand back the same type.
+
+#include <vector>
+
+struct MathCase
+{
+	const char* Name;
+	std::vector<float> Values;
+	float Tolerance; // How far apart the two copies can be, relative to the size of the values
+};
+
+namespace sess
+{
+std::vector<MathCase> RunMathCases();
+};
+
+namespace sess_scalar
+{
+std::vector<MathCase> RunMathCases();
+};
@@ -0,0 +1,257 @@
+// SIMD math checks (see ../common/Simd.h): every SSE/AVX path gives the same answers as
+//  the plain C++ fallback on the same inputs (MathCases.cc, built both ways), and the
+//  ones with an easy exact answer get checked against that too.
+
+#include "Check.h"
+#include "MathCases.h"
+
+#include <Affine3x4.h>
+#include <DualQuaternion.h>
+#include <Frustum.h>
+#include <MathExtras.h>
+#include <Simd.h>
+
+#include <assimp/mesh.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <random>
+
+using namespace sess;
+
+namespace
+{
+
+// Largest difference between the two copies of a case, relative to the size of the values
+//  (and never relative to anything smaller than 1, so values near 0 don't blow it up)
+float Difference(const MathCase& a, const MathCase& b)
+{
+	float worst = 0.f;
+	for (std::size_t i = 0u; i < a.Values.size(); i++)
+	{
+		float x = a.Values[i];
+		float y = b.Values[i];
+		if (std::isnan(x) || std::isnan(y))
+		{
+			return INFINITY;
+		}
+		worst = std::max(worst, std::fabs(x - y) / std::max({ 1.f, std::fabs(x), std::fabs(y) }));
+	}
+	return worst;
+}
+
+void CheckAgainstScalar()
+{
+	std::vector<MathCase> simd = sess::RunMathCases();
+	std::vector<MathCase> scalar = sess_scalar::RunMathCases();
+	SESS_CHECK(simd.size() == scalar.size());
+
+	for (std::size_t i = 0u; i < std::min(simd.size(), scalar.size()); i++)
+	{
+		const MathCase& a = simd[i];
+		const MathCase& b = scalar[i];
+		bool same = strcmp(a.Name, b.Name) == 0 && a.Values.size() == b.Values.size() && Difference(a, b) <= a.Tolerance;
+		if (!same)
+		{
+			std::cerr << a.Name << ": SIMD and scalar differ by " << Difference(a, b) << " (allowed " << a.Tolerance << ")" << std::endl;
+		}
+		SESS_CHECK(same);
+	}
+}
+
+// Determinant and inverse the slow way, in double
+double ReferenceDeterminant(const double (&m)[4][4])
+{
+	double det = 0.0;
+	for (int col = 0; col < 4; col++)
+	{
+		double minor[3][3];
+		for (int row = 1; row < 4; row++)
+		{
+			for (int c = 0, mc = 0; c < 4; c++)
+			{
+				if (c != col) minor[row - 1][mc++] = m[row][c];
+			}
+		}
+		double sub = minor[0][0] * (minor[1][1] * minor[2][2] - minor[1][2] * minor[2][1])
+			- minor[0][1] * (minor[1][0] * minor[2][2] - minor[1][2] * minor[2][0])
+			+ minor[0][2] * (minor[1][0] * minor[2][1] - minor[1][1] * minor[2][0]);
+		det += ((col % 2 == 0) ? m[0][col] : -m[0][col]) * sub;
+	}
+	return det;
+}
+
+// Gauss-Jordan with partial pivoting
+void ReferenceInverse(const double (&m)[4][4], double (&inv)[4][4])
+{
+	double a[4][8];
+	for (int row = 0; row < 4; row++)
+	{
+		for (int col = 0; col < 4; col++)
+		{
+			a[row][col] = m[row][col];
+			a[row][col + 4] = (row == col) ? 1.0 : 0.0;
+		}
+	}
+	for (int col = 0; col < 4; col++)
+	{
+		int pivot = col;
+		for (int row = col + 1; row < 4; row++)
+		{
+			if (std::fabs(a[row][col]) > std::fabs(a[pivot][col])) pivot = row;
+		}
+		std::swap(a[col], a[pivot]);
+		for (int row = 0; row < 4; row++)
+		{
+			if (row == col) continue;
+			double f = a[row][col] / a[col][col];
+			for (int c = 0; c < 8; c++) a[row][c] -= f * a[col][c];
+		}
+	}
+	for (int row = 0; row < 4; row++)
+	{
+		for (int col = 0; col < 4; col++)
+		{
+			inv[row][col] = a[row][col + 4] / a[row][row];
+		}
+	}
+}
+
+void CheckAgainstReference()
+{
+	std::mt19937 rng(2u);
+	std::uniform_real_distribution<float> element(-2.f, 2.f);
+
+	float worstDeterminant = 0.f;
+	float worstInverse = 0.f;
+	float worstAffine = 0.f;
+	for (int i = 0; i < 1000; i++)
+	{
+		Matrix m;
+		double md[4][4];
+		for (int row = 0; row < 4; row++)
+		{
+			for (int col = 0; col < 4; col++)
+			{
+				m.m[row][col] = element(rng) + ((row == col) ? 4.f : 0.f);
+				md[row][col] = m.m[row][col];
+			}
+		}
+
+		double det = ReferenceDeterminant(md);
+		worstDeterminant = std::max(worstDeterminant, float(std::fabs(m.Determinant() - det) / std::fabs(det)));
+
+		double invd[4][4];
+		ReferenceInverse(md, invd);
+		Matrix inv = m.Inverse();
+		for (int row = 0; row < 4; row++)
+		{
+			for (int col = 0; col < 4; col++)
+			{
+				worstInverse = std::max(worstInverse, float(std::fabs(inv.m[row][col] - invd[row][col])));
+			}
+		}
+
+		// An affine matrix's inverse is affine too, whichever way it's worked out
+		Affine3x4 affine(m);
+		Matrix affineInverse = affine.ToMatrix().Inverse();
+		Matrix fastInverse = affine.ToMatrix().InverseAffine();
+		for (int row = 0; row < 4; row++)
+		{
+			for (int col = 0; col < 4; col++)
+			{
+				worstAffine = std::max(worstAffine, std::fabs(affineInverse.m[row][col] - fastInverse.m[row][col]));
+			}
+		}
+	}
+	SESS_CHECK(worstDeterminant < 1e-5f);
+	SESS_CHECK(worstInverse < 1e-4f); // Everything goes through a division by the determinant
+	SESS_CHECK(worstAffine < 1e-5f);
+
+	// A singular matrix has a determinant of exactly 0 (two equal rows cancel exactly)
+	Matrix singular(1.f, 2.f, 3.f, 4.f, 5.f, 6.f, 7.f, 8.f, 1.f, 2.f, 3.f, 4.f, 0.f, 1.f, 0.f, 1.f);
+	SESS_CHECK(singular.Determinant() == 0.f);
+}
+
+void CheckCulling()
+{
+	// The batch versions say the same thing as asking about one bound at a time
+	const Frustum frustum(LookAtLH(Vec3(3.f, 1.f, -20.f), Vec3(0.f, 0.f, 5.f), Vec3::UnitY) * PerspectiveLH(PI / 4.f, 4.f / 3.f, 0.5f, 40.f));
+	std::mt19937 rng(4u);
+	std::uniform_real_distribution<float> position(-40.f, 40.f), size(0.f, 4.f);
+
+	std::vector<BoundingSphere> spheres(999u);
+	std::vector<AABB> boxes(999u);
+	for (std::size_t i = 0u; i < spheres.size(); i++)
+	{
+		Vec3 center(position(rng), position(rng), position(rng));
+		Vec3 extents(size(rng), size(rng), size(rng));
+		spheres[i] = BoundingSphere(center, extents.x);
+		boxes[i] = AABB(center - extents, center + extents);
+	}
+
+	VisibilitySet sphereSet, boxSet;
+	frustum.CullSpheres(spheres.data(), spheres.size(), sphereSet);
+	frustum.CullBoxes(boxes.data(), boxes.size(), boxSet);
+	bool spheresMatch = sphereSet.Size() == spheres.size();
+	bool boxesMatch = boxSet.Size() == boxes.size();
+	for (std::size_t i = 0u; i < spheres.size(); i++)
+	{
+		spheresMatch &= sphereSet.IsVisible(i) == frustum.Intersects(spheres[i]);
+		boxesMatch &= boxSet.IsVisible(i) == frustum.Intersects(boxes[i]);
+	}
+	SESS_CHECK(spheresMatch);
+	SESS_CHECK(boxesMatch);
+
+	// Some of each, or it wasn't much of a test
+	SESS_CHECK(sphereSet.CountVisible() > 0u && sphereSet.CountVisible() < spheres.size());
+	SESS_CHECK(boxSet.CountVisible() > 0u && boxSet.CountVisible() < boxes.size());
+}
+
+void CheckUnweightedSkinning()
+{
+	// Two vertices, and the only bone pulls on the first one
+	aiMesh mesh;
+	mesh.mNumVertices = 2u;
+	mesh.mNumBones = 1u;
+	mesh.mBones = new aiBone*[1];
+	mesh.mBones[0] = new aiBone();
+	mesh.mBones[0]->mNumWeights = 1u;
+	mesh.mBones[0]->mWeights = new aiVertexWeight[1];
+	mesh.mBones[0]->mWeights[0] = aiVertexWeight(0u, 0.5f);
+
+	std::vector<SkinInfluences> influences = GatherSkinInfluences(&mesh);
+	SESS_CHECK(influences.size() == 2u);
+	SESS_CHECK(influences[0].Weights[0] + influences[0].Weights[1] + influences[0].Weights[2] + influences[0].Weights[3] == 1.f);
+	SESS_CHECK(influences[1].Weights[0] + influences[1].Weights[1] + influences[1].Weights[2] + influences[1].Weights[3] == 0.f);
+
+	// The bone moves its vertex, and the other one stays exactly where it was
+	const DualQuaternion palette[1] = { DualQuaternion::FromTransform(Transform(Vec3(1.f, 2.f, 3.f), Quaternion::Identity, Vec3::Ones)) };
+	const Vec3 positions[2] = { Vec3(1.f, 1.f, 1.f), Vec3(4.f, 5.f, 6.f) };
+	const Vec3 normals[2] = { Vec3::UnitY, Vec3::UnitZ };
+	Vec3 outPositions[2], outNormals[2];
+	SkinVertices(palette, influences.data(), positions, normals, outPositions, outNormals, 2u);
+	SESS_CHECK((outPositions[0] - Vec3(2.f, 3.f, 4.f)).Magnitude() < 1e-5f);
+	SESS_CHECK(outPositions[1].x == 4.f && outPositions[1].y == 5.f && outPositions[1].z == 6.f);
+	SESS_CHECK(outNormals[1].x == 0.f && outNormals[1].y == 0.f && outNormals[1].z == 1.f);
+
+	DualQuaternion identity = DualQuaternion::Blend(palette, influences[1]);
+	SESS_CHECK(memcmp(&identity, &DualQuaternion::Identity, sizeof(DualQuaternion)) == 0);
+}
+
+};
+
+int main()
+{
+	CheckAgainstScalar();
+	CheckAgainstReference();
+	CheckCulling();
+	CheckUnweightedSkinning();
+#if defined(SESS_AVX)
+	return check::Finish("math-check-avx");
+#else
+	return check::Finish("math-check");
+#endif
+}
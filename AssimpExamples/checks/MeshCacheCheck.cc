@@ -0,0 +1,142 @@
+// Mesh cache checks (see ../common/MeshCache.h): what gets saved comes back byte for byte,
+//  and anything that should make the cache stale does.
+
+#include "Check.h"
+
+#include <MeshCache.h>
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+using namespace sess;
+
+namespace
+{
+
+struct TestVertex
+{
+	Vec3 Position;
+	Vec3 Normal;
+	float U, V;
+};
+
+const char* SOURCE_FILE = "check-mesh-cache.fbx";
+const char* CACHE_FILE = "check-mesh-cache.fbx.smesh";
+const char* PACK_FILE = "check-mesh-cache.pack";
+
+void WriteFile(const char* fName, const std::string& contents)
+{
+	std::ofstream(fName, std::ios::binary) << contents;
+}
+
+std::string ReadFile(const char* fName)
+{
+	std::ifstream in(fName, std::ios::binary);
+	return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+// A fresh MeshCache for the source file as it is right now
+MeshCache CacheFor(const AssetPack& assets, const char* vertexFormat, const ImportProfile& profile)
+{
+	AssetData source;
+	AssetPack::LoadLoose(SOURCE_FILE, source);
+	return MeshCache(assets, SOURCE_FILE, source, vertexFormat, profile);
+}
+
+bool SameMeshes(const std::vector<CookedMesh<TestVertex>>& a, const std::vector<CookedMesh<TestVertex>>& b)
+{
+	if (a.size() != b.size())
+	{
+		return false;
+	}
+	for (std::size_t meshIdx = 0u; meshIdx < a.size(); meshIdx++)
+	{
+		const CookedMesh<TestVertex>& x = a[meshIdx];
+		const CookedMesh<TestVertex>& y = b[meshIdx];
+		float xAmbient[4], yAmbient[4];
+		x.Material.Ambient.packAsFloatArray(xAmbient);
+		y.Material.Ambient.packAsFloatArray(yAmbient);
+		if (x.Vertices.size() != y.Vertices.size()
+			|| (!x.Vertices.empty() && memcmp(x.Vertices.data(), y.Vertices.data(), x.Vertices.size() * sizeof(TestVertex)) != 0)
+			|| x.Indices != y.Indices
+			|| x.Lods.size() != y.Lods.size()
+			|| memcmp(xAmbient, yAmbient, sizeof(xAmbient)) != 0
+			|| memcmp(&x.LocalBounds, &y.LocalBounds, sizeof(Bounds)) != 0)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+};
+
+int main()
+{
+	// Made up on the spot - the real ones live in ImportProfile.cc, which needs Assimp
+	AssetPack noPack;
+	const ImportProfile profile = { "check", 0x1u, false, 0.f, 0u, {}, false, false };
+	const ImportProfile otherProfile = { "check", 0x3u, false, 0.f, 0u, {}, false, false };
+
+	// Meshes of different sizes, an empty one included
+	std::vector<CookedMesh<TestVertex>> meshes(3u);
+	for (std::uint32_t meshIdx = 0u; meshIdx < meshes.size(); meshIdx++)
+	{
+		CookedMesh<TestVertex>& mesh = meshes[meshIdx];
+		for (std::uint32_t i = 0u; i < 10u * meshIdx + 1u; i++)
+		{
+			mesh.Vertices.push_back({ Vec3(float(i), float(meshIdx), 1.f), Vec3::UnitY, 0.5f * i, float(meshIdx) });
+		}
+		for (std::uint32_t i = 0u; i < 3u * meshIdx; i++)
+		{
+			mesh.Indices.push_back(i * 7u + meshIdx);
+		}
+		mesh.Lods.push_back({ 0u, static_cast<std::uint32_t>(mesh.Indices.size()), 0.f });
+		mesh.Material = CookedMaterial(Color(1.f, 2.f, 3.f, 4.f), Color(5.f, 6.f, 7.f, 8.f), Color(9.f, 10.f, 11.f, float(meshIdx)));
+		mesh.LocalBounds = Bounds::FromPoints(&mesh.Vertices[0].Position.x, 1u);
+	}
+
+	remove(CACHE_FILE);
+	WriteFile(SOURCE_FILE, "pretend this is an fbx");
+
+	std::vector<CookedMesh<TestVertex>> loaded;
+	SESS_CHECK(!CacheFor(noPack, "TestVertex", profile).Load(loaded));
+	SESS_CHECK(CacheFor(noPack, "TestVertex", profile).Save(meshes));
+	SESS_CHECK(CacheFor(noPack, "TestVertex", profile).Load(loaded) && SameMeshes(meshes, loaded));
+
+	// A different profile, vertex format or source file all make it stale
+	SESS_CHECK(!CacheFor(noPack, "TestVertex", otherProfile).Load(loaded));
+	SESS_CHECK(!CacheFor(noPack, "OtherVertex", profile).Load(loaded));
+	WriteFile(SOURCE_FILE, "pretend this is a different fbx");
+	SESS_CHECK(!CacheFor(noPack, "TestVertex", profile).Load(loaded));
+
+	// A cache file that got cut short is rejected, not read past its end
+	SESS_CHECK(CacheFor(noPack, "TestVertex", profile).Save(meshes));
+	std::string cached = ReadFile(CACHE_FILE);
+	WriteFile(CACHE_FILE, cached.substr(0u, cached.size() - 8u));
+	SESS_CHECK(!CacheFor(noPack, "TestVertex", profile).Load(loaded));
+
+	// A cache in the asset pack gets used when there's none on disk...
+	AssetPackWriter writer;
+	SESS_CHECK(writer.Add(CACHE_FILE, std::vector<std::uint8_t>(cached.begin(), cached.end()), AssetPack::Compression::Zlib));
+	SESS_CHECK(writer.Write(PACK_FILE));
+	remove(CACHE_FILE);
+	{
+		AssetPack pack;
+		SESS_CHECK(pack.Open(PACK_FILE));
+		SESS_CHECK(CacheFor(pack, "TestVertex", profile).Load(loaded) && SameMeshes(meshes, loaded));
+
+		// ...but once it's stale, the one on disk wins
+		WriteFile(SOURCE_FILE, "pretend this is a third fbx");
+		SESS_CHECK(CacheFor(pack, "TestVertex", profile).Save(meshes));
+		SESS_CHECK(CacheFor(pack, "TestVertex", profile).Load(loaded) && SameMeshes(meshes, loaded));
+	}
+
+	remove(SOURCE_FILE);
+	remove(CACHE_FILE);
+	remove(PACK_FILE);
+	return check::Finish("mesh-cache-check");
+}
@@ -0,0 +1,234 @@
+// Mesh optimizer checks (see ../common/MeshOptimizer.h): every pass only ever reorders -
+//  the same triangles come out that went in - and each one actually moves its number the
+//  way it's supposed to on meshes where the right answer is known.
+
+#include "Check.h"
+
+#include <MeshOptimizer.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <set>
+#include <vector>
+
+using namespace sess;
+
+namespace
+{
+
+using Triangle = std::array<std::uint32_t, 3u>;
+
+// Triangles as a multiset, so two index arrays can be compared ignoring the order
+std::multiset<Triangle> TrianglesOf(const std::vector<std::uint32_t>& indices)
+{
+	std::multiset<Triangle> triangles;
+	for (std::size_t i = 0u; i + 2u < indices.size(); i += 3u)
+	{
+		triangles.insert({ indices[i], indices[i + 1u], indices[i + 2u] });
+	}
+	return triangles;
+}
+
+// size x size quads, two triangles each, vertex (x, y) at index y * (size + 1) + x
+std::vector<std::uint32_t> GridIndices(std::uint32_t size)
+{
+	std::vector<std::uint32_t> indices;
+	auto vertex = [size](std::uint32_t x, std::uint32_t y) { return y * (size + 1u) + x; };
+	for (std::uint32_t y = 0u; y < size; y++)
+	{
+		for (std::uint32_t x = 0u; x < size; x++)
+		{
+			indices.insert(indices.end(), { vertex(x, y), vertex(x + 1u, y), vertex(x, y + 1u) });
+			indices.insert(indices.end(), { vertex(x + 1u, y), vertex(x + 1u, y + 1u), vertex(x, y + 1u) });
+		}
+	}
+	return indices;
+}
+
+// Same triangles, in a random order
+std::vector<std::uint32_t> ShuffleTriangles(const std::vector<std::uint32_t>& indices, std::uint32_t seed)
+{
+	std::vector<Triangle> triangles;
+	for (std::size_t i = 0u; i < indices.size(); i += 3u)
+	{
+		triangles.push_back({ indices[i], indices[i + 1u], indices[i + 2u] });
+	}
+	std::mt19937 rng(seed);
+	std::shuffle(triangles.begin(), triangles.end(), rng);
+
+	std::vector<std::uint32_t> shuffled;
+	for (auto&& triangle : triangles)
+	{
+		shuffled.insert(shuffled.end(), triangle.begin(), triangle.end());
+	}
+	return shuffled;
+}
+
+// A UV sphere of radius radius around the origin, positions as x, y, z float triples
+void AddSphere(std::vector<float>& positions, std::vector<std::uint32_t>& indices, float radius, std::uint32_t segments)
+{
+	const std::uint32_t base = static_cast<std::uint32_t>(positions.size() / 3u);
+	for (std::uint32_t ring = 0u; ring <= segments; ring++)
+	{
+		for (std::uint32_t slice = 0u; slice <= segments; slice++)
+		{
+			float theta = 3.14159265f * ring / segments;
+			float phi = 6.28318531f * slice / segments;
+			positions.insert(positions.end(), { radius * sinf(theta) * cosf(phi), radius * cosf(theta), radius * sinf(theta) * sinf(phi) });
+		}
+	}
+	for (std::uint32_t ring = 0u; ring < segments; ring++)
+	{
+		for (std::uint32_t slice = 0u; slice < segments; slice++)
+		{
+			std::uint32_t a = base + ring * (segments + 1u) + slice;
+			std::uint32_t b = a + 1u;
+			std::uint32_t c = a + segments + 1u;
+			std::uint32_t d = c + 1u;
+			indices.insert(indices.end(), { a, c, b, b, c, d });
+		}
+	}
+}
+
+void CheckVertexCache()
+{
+	const std::uint32_t size = 100u;
+	const std::size_t vertexCount = (size + 1u) * (size + 1u);
+	std::vector<std::uint32_t> shuffled = ShuffleTriangles(GridIndices(size), 1u);
+
+	// Shuffled, nearly every corner is a miss
+	VertexCacheStats before = AnalyzeVertexCache(shuffled.data(), shuffled.size(), vertexCount);
+	SESS_CHECK(before.Acmr > 2.5f);
+
+	// In place, same triangles (same winding), and close to the ~0.5 a grid can get
+	std::vector<std::uint32_t> optimized(shuffled);
+	OptimizeVertexCache(optimized.data(), optimized.data(), optimized.size(), vertexCount);
+	VertexCacheStats after = AnalyzeVertexCache(optimized.data(), optimized.size(), vertexCount);
+	SESS_CHECK(TrianglesOf(optimized) == TrianglesOf(shuffled));
+	SESS_CHECK(after.Acmr < 0.75f);
+	SESS_CHECK(after.Atvr < 1.4f);
+
+	// Degenerate triangles, disconnected pieces and vertices nothing uses don't trip it up
+	std::vector<std::uint32_t> awkward = { 0u, 0u, 1u, 2u, 3u, 4u, 5u, 6u, 7u, 0u, 1u, 2u };
+	std::vector<std::uint32_t> awkwardOut(awkward.size());
+	OptimizeVertexCache(awkwardOut.data(), awkward.data(), awkward.size(), 10u);
+	SESS_CHECK(TrianglesOf(awkwardOut) == TrianglesOf(awkward));
+}
+
+void CheckOverdraw()
+{
+	// Three spheres inside each other, smallest first - every view shades all three.
+	//  Biggest first would be the ideal order: only the outside one ever gets seen.
+	std::vector<float> positions;
+	std::vector<std::uint32_t> indices;
+	for (float radius : { 0.5f, 0.7f, 1.f })
+	{
+		AddSphere(positions, indices, radius, 40u);
+	}
+	const std::size_t vertexCount = positions.size() / 3u;
+	const std::size_t stride = 3u * sizeof(float);
+
+	std::vector<std::uint32_t> cacheOrder(indices);
+	OptimizeVertexCache(cacheOrder.data(), cacheOrder.data(), cacheOrder.size(), vertexCount);
+	VertexCacheStats cacheBefore = AnalyzeVertexCache(cacheOrder.data(), cacheOrder.size(), vertexCount);
+	OverdrawStats before = AnalyzeOverdraw(cacheOrder.data(), cacheOrder.size(), positions.data(), stride, vertexCount);
+	SESS_CHECK(before.Overdraw > 2.f);
+
+	std::vector<std::uint32_t> optimized(cacheOrder.size());
+	OptimizeOverdraw(optimized.data(), cacheOrder.data(), cacheOrder.size(), positions.data(), stride, vertexCount, 1.05f);
+	VertexCacheStats cacheAfter = AnalyzeVertexCache(optimized.data(), optimized.size(), vertexCount);
+	OverdrawStats after = AnalyzeOverdraw(optimized.data(), optimized.size(), positions.data(), stride, vertexCount);
+	SESS_CHECK(TrianglesOf(optimized) == TrianglesOf(cacheOrder));
+	SESS_CHECK(after.PixelsCovered == before.PixelsCovered);
+	SESS_CHECK(after.Overdraw < 1.6f);
+
+	// The ACMR only gets as much worse as the threshold allows
+	SESS_CHECK(cacheAfter.Acmr <= cacheBefore.Acmr * 1.05f);
+
+	// Under 1, only the cache order's own clusters move - still the same triangles
+	std::vector<std::uint32_t> clustersOnly(cacheOrder);
+	OptimizeOverdraw(clustersOnly.data(), clustersOnly.data(), clustersOnly.size(), positions.data(), stride, vertexCount, 0.f);
+	SESS_CHECK(TrianglesOf(clustersOnly) == TrianglesOf(cacheOrder));
+	SESS_CHECK(AnalyzeOverdraw(clustersOnly.data(), clustersOnly.size(), positions.data(), stride, vertexCount).Overdraw <= before.Overdraw);
+}
+
+void CheckVertexFetch()
+{
+	// A grid whose vertices are in a random order in memory, plus a few nothing uses. Each
+	//  vertex remembers where it started out, so the triangles can be followed through.
+	struct TestVertex
+	{
+		float Position[3];
+		float Normal[3];
+		float UV[2];
+		std::uint32_t OriginalIndex;
+	};
+
+	const std::uint32_t size = 80u;
+	const std::size_t usedCount = (size + 1u) * (size + 1u);
+	std::vector<TestVertex> vertices(usedCount + 5u, TestVertex());
+	for (std::size_t i = 0u; i < vertices.size(); i++)
+	{
+		vertices[i].OriginalIndex = static_cast<std::uint32_t>(i);
+	}
+
+	std::vector<std::uint32_t> scattered(usedCount);
+	for (std::uint32_t i = 0u; i < usedCount; i++)
+	{
+		scattered[i] = i;
+	}
+	std::mt19937 rng(3u);
+	std::shuffle(scattered.begin(), scattered.end(), rng);
+
+	std::vector<std::uint32_t> indices = GridIndices(size);
+	for (auto&& index : indices)
+	{
+		index = scattered[index];
+	}
+	OptimizeVertexCache(indices.data(), indices.data(), indices.size(), vertices.size());
+
+	std::vector<std::uint32_t> originalCorners;
+	for (std::uint32_t index : indices)
+	{
+		originalCorners.push_back(vertices[index].OriginalIndex);
+	}
+
+	VertexFetchStats before = AnalyzeVertexFetch(indices.data(), indices.size(), vertices.size(), sizeof(TestVertex));
+	std::size_t kept = OptimizeVertexFetch(vertices.data(), sizeof(TestVertex), vertices.size(), indices.data(), indices.size());
+	VertexFetchStats after = AnalyzeVertexFetch(indices.data(), indices.size(), kept, sizeof(TestVertex));
+
+	// The unused ones are gone, and every corner still ends up at the same vertex
+	SESS_CHECK(kept == usedCount);
+	bool sameCorners = true;
+	for (std::size_t i = 0u; i < indices.size(); i++)
+	{
+		sameCorners &= (indices[i] < kept && vertices[indices[i]].OriginalIndex == originalCorners[i]);
+	}
+	SESS_CHECK(sameCorners);
+
+	// First-use order - no index is more than one past the highest one before it
+	bool firstUseOrder = true;
+	std::uint32_t nextNew = 0u;
+	for (std::uint32_t index : indices)
+	{
+		firstUseOrder &= (index <= nextNew);
+		nextNew = std::max(nextNew, index + 1u);
+	}
+	SESS_CHECK(firstUseOrder);
+
+	SESS_CHECK(after.BytesUsed == before.BytesUsed);
+	SESS_CHECK(after.Efficiency > before.Efficiency * 1.5f);
+}
+
+};
+
+int main()
+{
+	CheckVertexCache();
+	CheckOverdraw();
+	CheckVertexFetch();
+	return check::Finish("mesh-optimizer-check");
+}
@@ -0,0 +1,195 @@
+// Meshlet checks (see ../common/Meshlets.h): building them only regroups triangles, every
+//  meshlet stays within its limits and inside its own bounds, the normal cone never culls a
+//  triangle that faces the camera, and the visible ranges cover exactly the visible meshlets.
+
+#include "Check.h"
+
+#include <MathExtras.h>
+#include <MeshOptimizer.h>
+#include <Meshlets.h>
+#include <Transform.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <random>
+#include <set>
+#include <vector>
+
+using namespace sess;
+
+namespace
+{
+
+using Triangle = std::array<std::uint32_t, 3u>;
+
+// Triangles as a multiset, each one rotated to start at its smallest index - so the same
+//  triangle with the same winding compares equal whichever corner comes first
+std::multiset<Triangle> TrianglesOf(const std::vector<std::uint32_t>& indices)
+{
+	std::multiset<Triangle> triangles;
+	for (std::size_t i = 0u; i + 2u < indices.size(); i += 3u)
+	{
+		Triangle triangle = { indices[i], indices[i + 1u], indices[i + 2u] };
+		std::rotate(triangle.begin(), std::min_element(triangle.begin(), triangle.end()), triangle.end());
+		triangles.insert(triangle);
+	}
+	return triangles;
+}
+
+void CheckMeshlets()
+{
+	// A unit UV sphere, clockwise from outside like the demos' meshes
+	const std::uint32_t segments = 64u;
+	std::vector<Vec3> positions;
+	std::vector<std::uint32_t> indices;
+	for (std::uint32_t ring = 0u; ring <= segments; ring++)
+	{
+		for (std::uint32_t slice = 0u; slice <= segments; slice++)
+		{
+			float theta = 3.14159265f * ring / segments;
+			float phi = 6.28318531f * slice / segments;
+			positions.push_back(Vec3(sinf(theta) * cosf(phi), cosf(theta), sinf(theta) * sinf(phi)));
+		}
+	}
+	for (std::uint32_t ring = 0u; ring < segments; ring++)
+	{
+		for (std::uint32_t slice = 0u; slice < segments; slice++)
+		{
+			std::uint32_t a = ring * (segments + 1u) + slice;
+			std::uint32_t b = a + 1u;
+			std::uint32_t c = a + segments + 1u;
+			std::uint32_t d = c + 1u;
+			if (ring > 0u)
+			{
+				indices.insert(indices.end(), { a, b, c });
+			}
+			if (ring < segments - 1u)
+			{
+				indices.insert(indices.end(), { b, d, c });
+			}
+		}
+	}
+	OptimizeVertexCache(indices.data(), indices.data(), indices.size(), positions.size());
+
+	std::multiset<Triangle> before = TrianglesOf(indices);
+	std::vector<Meshlet> meshlets = BuildMeshlets(indices.data(), indices.size(), &positions[0].x, sizeof(Vec3), positions.size());
+	SESS_CHECK(!meshlets.empty());
+	SESS_CHECK(TrianglesOf(indices) == before);
+
+	// Back to back, within the limits, and every vertex inside the meshlet's sphere
+	bool contiguous = true;
+	bool withinLimits = true;
+	bool bounded = true;
+	std::uint32_t nextIndex = 0u;
+	for (auto&& meshlet : meshlets)
+	{
+		contiguous &= (meshlet.FirstIndex == nextIndex);
+		nextIndex += meshlet.TriangleCount * 3u;
+
+		std::set<std::uint32_t> used(indices.begin() + meshlet.FirstIndex, indices.begin() + meshlet.FirstIndex + meshlet.TriangleCount * 3u);
+		withinLimits &= (meshlet.TriangleCount > 0u && meshlet.TriangleCount <= MAX_MESHLET_TRIANGLES);
+		withinLimits &= (used.size() == meshlet.VertexCount && meshlet.VertexCount <= MAX_MESHLET_VERTICES);
+		for (std::uint32_t vertex : used)
+		{
+			bounded &= (positions[vertex] - meshlet.Sphere.Center).Magnitude() <= meshlet.Sphere.Radius;
+		}
+	}
+	SESS_CHECK(contiguous && nextIndex == indices.size());
+	SESS_CHECK(withinLimits);
+	SESS_CHECK(bounded);
+
+	// The cone test is conservative: from a few hundred spots around the sphere, not one
+	//  triangle of a meshlet it calls backfacing is actually facing the camera. And it
+	//  does call some backfacing - about half, on a sphere.
+	std::mt19937 rng(1u);
+	std::uniform_real_distribution<float> coordinate(-5.f, 5.f);
+	std::size_t tests = 0u;
+	std::size_t culled = 0u;
+	std::size_t wronglyCulled = 0u;
+	for (int camera = 0; camera < 200; camera++)
+	{
+		Vec3 cameraPosition(coordinate(rng), coordinate(rng), coordinate(rng));
+		if (cameraPosition.Magnitude() < 1.2f)
+		{
+			continue;
+		}
+		for (auto&& meshlet : meshlets)
+		{
+			tests++;
+			if (!IsMeshletBackfacing(meshlet, cameraPosition))
+			{
+				continue;
+			}
+			culled++;
+			for (std::uint32_t i = meshlet.FirstIndex; i < meshlet.FirstIndex + meshlet.TriangleCount * 3u; i += 3u)
+			{
+				const Vec3& a = positions[indices[i]];
+				const Vec3& b = positions[indices[i + 1u]];
+				const Vec3& c = positions[indices[i + 2u]];
+				wronglyCulled += (Vec3::Dot(Vec3::Cross(b - a, c - a), a - cameraPosition) < 0.f) ? 1u : 0u;
+			}
+		}
+	}
+	SESS_CHECK(wronglyCulled == 0u);
+	SESS_CHECK(culled * 3u > tests);
+
+	// Culled from in front of the sphere, the ranges cover exactly the visible meshlets
+	Vec3 cameraPosition(0.f, 0.f, -3.f);
+	Frustum frustum(LookAtLH(cameraPosition, Vec3::Zero, Vec3::UnitY) * PerspectiveLH(Radians(60.f), 1.f, 0.1f, 100.f));
+	VisibilitySet visible;
+	std::size_t visibleCount = CullMeshlets(meshlets.data(), meshlets.size(), frustum, &cameraPosition, visible);
+	SESS_CHECK(visibleCount > 0u && visibleCount < meshlets.size() && visibleCount == visible.CountVisible());
+
+	std::vector<IndexRange> ranges;
+	GatherVisibleRanges(meshlets.data(), meshlets.size(), visible, ranges);
+	std::vector<bool> inRange(indices.size(), false);
+	for (auto&& range : ranges)
+	{
+		std::fill(inRange.begin() + range.FirstIndex, inRange.begin() + range.FirstIndex + range.IndexCount, true);
+	}
+	bool rangesMatch = ranges.size() <= visibleCount;
+	for (std::size_t meshletIdx = 0u; meshletIdx < meshlets.size(); meshletIdx++)
+	{
+		const Meshlet& meshlet = meshlets[meshletIdx];
+		for (std::uint32_t i = meshlet.FirstIndex; i < meshlet.FirstIndex + meshlet.TriangleCount * 3u; i++)
+		{
+			rangesMatch &= (inRange[i] == visible.IsVisible(meshletIdx));
+		}
+	}
+	SESS_CHECK(rangesMatch);
+
+	// With nothing to cull against, everything is visible
+	VisibilitySet all;
+	SESS_CHECK(CullMeshlets(meshlets.data(), meshlets.size(), Frustum(), nullptr, all) == meshlets.size());
+}
+
+void CheckModelSpaceFrustum()
+{
+	// Meshlets are culled in model space, with a frustum built from model * view * projection.
+	//  That has to agree with moving the bounds to world space and culling there.
+	Transform model(Vec3(1.f, 2.f, 3.f), Quaternion(Vec3::UnitY, Radians(-90.f)) * Quaternion(Vec3::UnitX, Radians(-90.f)), Vec3(2.f, 2.f, 2.f));
+	Matrix modelMatrix = model.GetTransformMatrix();
+	Matrix viewProj = LookAtLH(Vec3(0.f, 2.2f, 0.f), Vec3(0.f, 2.2f, 1.f), Vec3::UnitY) * PerspectiveLH(Radians(80.f), 1.5f, 0.1f, 100.f);
+	Frustum worldFrustum(viewProj);
+	Frustum modelFrustum(modelMatrix.Transpose() * viewProj);
+
+	std::mt19937 rng(2u);
+	std::uniform_real_distribution<float> coordinate(-20.f, 20.f);
+	std::size_t disagreements = 0u;
+	for (int i = 0; i < 2000; i++)
+	{
+		BoundingSphere sphere(Vec3(coordinate(rng), coordinate(rng), coordinate(rng)), 0.3f);
+		disagreements += (worldFrustum.Intersects(sphere.Transformed(modelMatrix)) != modelFrustum.Intersects(sphere)) ? 1u : 0u;
+	}
+	SESS_CHECK(disagreements == 0u);
+}
+
+};
+
+int main()
+{
+	CheckMeshlets();
+	CheckModelSpaceFrustum();
+	return check::Finish("meshlets-check");
+}
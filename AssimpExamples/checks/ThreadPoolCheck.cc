@@ -0,0 +1,64 @@
+// Thread pool checks (see ../common/ThreadPool.h): every index gets done exactly once,
+//  including from several threads at once and from inside another ParallelFor.
+
+#include "Check.h"
+
+#include <ThreadPool.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace sess;
+
+int main()
+{
+	ThreadPool pool(4u);
+
+	// Lots of small jobs, of every size from 1 up - each index writes only its own slot
+	bool allDone = true;
+	for (std::size_t count = 1u; count < 600u; count += 3u)
+	{
+		std::vector<std::size_t> out(count, 0u);
+		pool.ParallelFor(count, [&out](std::size_t i) { out[i] = i * i + 1u; });
+		for (std::size_t i = 0u; i < count; i++)
+		{
+			allDone &= (out[i] == i * i + 1u);
+		}
+	}
+	SESS_CHECK(allDone);
+
+	// Nested - the inner calls can't wait on workers that are all busy with outer ones
+	std::atomic<int> nestedSum{ 0 };
+	pool.ParallelFor(16u, [&pool, &nestedSum](std::size_t i) {
+		pool.ParallelFor(16u, [i, &nestedSum](std::size_t j) { nestedSum += int(i * 16u + j); });
+	});
+	SESS_CHECK(nestedSum == 255 * 256 / 2);
+
+	// Two threads sharing the pool
+	std::atomic<int> calls{ 0 };
+	auto hammer = [&pool, &calls] {
+		for (int rep = 0; rep < 100; rep++)
+		{
+			pool.ParallelFor(50u, [&calls](std::size_t) { calls++; });
+		}
+	};
+	std::thread first(hammer);
+	std::thread second(hammer);
+	first.join();
+	second.join();
+	SESS_CHECK(calls == 2 * 100 * 50);
+
+	// A single worker, so it and the calling thread split the work
+	ThreadPool oneWorker(1u);
+	std::atomic<int> count{ 0 };
+	oneWorker.ParallelFor(500u, [&count](std::size_t) { count++; });
+	SESS_CHECK(count == 500);
+
+	// The shared pool can have no workers at all (one core) - then the caller does it all
+	std::atomic<int> sharedCount{ 0 };
+	ThreadPool::Shared().ParallelFor(100u, [&sharedCount](std::size_t) { sharedCount++; });
+	SESS_CHECK(sharedCount == 100);
+
+	return check::Finish("thread-pool-check");
+}
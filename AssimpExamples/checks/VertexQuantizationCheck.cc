@@ -0,0 +1,234 @@
+// Compact vertex checks (see ../common/VertexQuantization.h): every encoding round trips
+//  within the error bounds the header documents, and the stream kernels write the same
+//  thing the one-at-a-time functions do, at any stride.
+
+#include "Check.h"
+
+#include <VertexQuantization.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <random>
+
+using namespace sess;
+
+namespace
+{
+
+bool IsNaNHalf(std::uint16_t half)
+{
+	return (half & 0x7c00u) == 0x7c00u && (half & 0x03ffu) != 0u;
+}
+
+void CheckHalf()
+{
+	// Every half that isn't a NaN survives the trip through float exactly
+	bool exact = true;
+	for (std::uint32_t half = 0u; half < 0x10000u; half++)
+	{
+		if (!IsNaNHalf(std::uint16_t(half)))
+		{
+			exact &= (FloatToHalf(HalfToFloat(std::uint16_t(half))) == half);
+		}
+	}
+	SESS_CHECK(exact);
+
+	// Any float in range rounds to the nearest half, and to the even one on a tie. That's
+	//  checked against its neighbours, so it covers denormals too.
+	std::mt19937 rng(3u);
+	std::uniform_real_distribution<float> mantissa(-4.f, 4.f);
+	std::uniform_int_distribution<int> exponent(-30, 13);
+	bool nearest = true;
+	for (int i = 0; i < 1000000; i++)
+	{
+		float value = std::ldexp(mantissa(rng), exponent(rng));
+		if (std::fabs(value) >= 65504.f)
+		{
+			continue;
+		}
+		std::uint16_t half = FloatToHalf(value);
+		std::uint16_t magnitude = half & 0x7fffu;
+		float error = std::fabs(HalfToFloat(half) - value);
+		float errorUp = std::fabs(HalfToFloat(std::uint16_t(half + 1u)) - value);
+		float errorDown = (magnitude > 0u) ? std::fabs(HalfToFloat(std::uint16_t(half - 1u)) - value) : INFINITY;
+		nearest &= (error <= errorUp && error <= errorDown);
+		if (error == errorUp || error == errorDown)
+		{
+			nearest &= (half & 1u) == 0u;
+		}
+	}
+	SESS_CHECK(nearest);
+
+	// Too big is infinity, too small is (signed) zero
+	SESS_CHECK(FloatToHalf(65519.f) == 0x7bffu);
+	SESS_CHECK(FloatToHalf(65520.f) == 0x7c00u);
+	SESS_CHECK(FloatToHalf(-1e10f) == 0xfc00u);
+	SESS_CHECK(FloatToHalf(1e-10f) == 0x0000u);
+	SESS_CHECK(FloatToHalf(-1e-10f) == 0x8000u);
+
+	// The documented UV bounds: 2^-11 relative, and at most 1/4096 in 0..1
+	std::uniform_real_distribution<float> uv(0.f, 1.f);
+	float worstAbsolute = 0.f;
+	float worstRelative = 0.f;
+	for (int i = 0; i < 1000000; i++)
+	{
+		float value = uv(rng);
+		float error = std::fabs(HalfToFloat(FloatToHalf(value)) - value);
+		worstAbsolute = std::max(worstAbsolute, error);
+		if (value >= 6.103515625e-5f) // Smallest normal half - denormals only have an absolute bound
+		{
+			worstRelative = std::max(worstRelative, error / value);
+		}
+	}
+	SESS_CHECK(worstAbsolute <= 1.f / 4096.f);
+	SESS_CHECK(worstRelative <= 1.f / 2048.f);
+}
+
+// Angle between two directions, in degrees. atan2 of the cross and dot products, since
+//  acos is useless this close to 1.
+double DegreesBetween(const Vec3& a, const Vec3& b)
+{
+	double cx = double(a.y) * b.z - double(a.z) * b.y;
+	double cy = double(a.z) * b.x - double(a.x) * b.z;
+	double cz = double(a.x) * b.y - double(a.y) * b.x;
+	double dot = double(a.x) * b.x + double(a.y) * b.y + double(a.z) * b.z;
+	return std::atan2(std::sqrt(cx * cx + cy * cy + cz * cz), dot) * 180.0 / 3.14159265358979323846;
+}
+
+void CheckOctahedral()
+{
+	// Directions spread evenly over the sphere
+	std::mt19937 rng(5u);
+	std::normal_distribution<float> gaussian;
+	double worst = 0.0;
+	for (int i = 0; i < 2000000; i++)
+	{
+		Vec3 normal(gaussian(rng), gaussian(rng), gaussian(rng));
+		float length = normal.Magnitude();
+		if (length < 1e-3f)
+		{
+			continue;
+		}
+		normal = normal * (1.f / length);
+
+		std::int16_t encoded[2];
+		EncodeOctahedral(normal, encoded);
+		worst = std::max(worst, DegreesBetween(normal, DecodeOctahedral(encoded)));
+	}
+	SESS_CHECK(worst < 0.005);
+
+	// The axes - the corners and middle of the square, and the folded edges
+	bool axesExact = true;
+	for (const Vec3& axis : { Vec3::UnitX, Vec3::UnitY, Vec3::UnitZ, -Vec3::UnitX, -Vec3::UnitY, -Vec3::UnitZ })
+	{
+		std::int16_t encoded[2];
+		EncodeOctahedral(axis, encoded);
+		axesExact &= DegreesBetween(axis, DecodeOctahedral(encoded)) < 0.001;
+	}
+	SESS_CHECK(axesExact);
+
+	// Doesn't have to be unit length going in
+	std::int16_t scaled[2], unit[2];
+	EncodeOctahedral(Vec3(3.f, -4.f, 12.f), scaled);
+	EncodeOctahedral(Vec3(3.f, -4.f, 12.f) * (1.f / 13.f), unit);
+	SESS_CHECK(scaled[0] == unit[0] && scaled[1] == unit[1]);
+}
+
+void CheckPositions()
+{
+	// A box that's much longer on one side, so it really does get stretched into a cube
+	AABB box(Vec3(-3.f, 1.f, 2.f), Vec3(5.f, 1.5f, 40.f));
+	PositionQuantization quantization = PositionQuantization::FromBox(box);
+	SESS_CHECK(quantization.Scale == 38.f);
+
+	std::mt19937 rng(7u);
+	std::uniform_real_distribution<float> x(-3.f, 5.f), y(1.f, 1.5f), z(2.f, 40.f);
+	const Affine3x4 dequantize = quantization.ToAffine();
+	float worst = 0.f;
+	bool wIsOne = true;
+	bool matchesAffine = true;
+	for (int i = 0; i < 1000000; i++)
+	{
+		Vec3 position(x(rng), y(rng), z(rng));
+		std::uint16_t encoded[4];
+		QuantizePosition(position, quantization, encoded);
+		Vec3 decoded = DecodePosition(encoded, quantization);
+		worst = std::max({ worst, std::fabs(decoded.x - position.x), std::fabs(decoded.y - position.y), std::fabs(decoded.z - position.z) });
+		wIsOne &= (encoded[3] == 65535u);
+
+		// What the GPU does: UNORM to 0..1, then the model matrix with ToAffine folded in
+		Vec3 onGpu = dequantize.TransformPoint(Vec3(encoded[0] / 65535.f, encoded[1] / 65535.f, encoded[2] / 65535.f));
+		matchesAffine &= (onGpu - decoded).Magnitude() < 1e-5f;
+	}
+	SESS_CHECK(wIsOne);
+	SESS_CHECK(matchesAffine);
+	SESS_CHECK(worst <= quantization.Scale / 131070.f * 1.01f); // Half a step, plus float rounding
+
+	// A flat box (all on one plane) still gets a usable scale
+	PositionQuantization flat = PositionQuantization::FromBox(AABB(Vec3(1.f, 2.f, 3.f), Vec3(1.f, 2.f, 3.f)));
+	SESS_CHECK(flat.Scale > 0.f);
+}
+
+void CheckStreams()
+{
+	// The stream kernels against the one-at-a-time functions, reading and writing with
+	//  strides that aren't the element size
+	struct CompactVertex
+	{
+		std::uint16_t Position[4];
+		std::int16_t Normal[2];
+		std::uint16_t UV[2];
+	};
+	static_assert(sizeof(CompactVertex) == 16u, "Same layout as TexturedShader::CompactVertex");
+
+	struct FullVertex
+	{
+		float Position[3];
+		float Normal[3];
+		float UV[2];
+		float Padding;
+	};
+
+	std::mt19937 rng(9u);
+	std::uniform_real_distribution<float> coordinate(-1.f, 1.f);
+	FullVertex in[64];
+	for (auto&& vertex : in)
+	{
+		for (float& value : vertex.Position) value = coordinate(rng) * 10.f;
+		for (float& value : vertex.Normal) value = coordinate(rng);
+		for (float& value : vertex.UV) value = coordinate(rng) + 1.f;
+	}
+	PositionQuantization quantization = PositionQuantization::FromBox(AABB(Vec3(-10.f, -10.f, -10.f), Vec3(10.f, 10.f, 10.f)));
+
+	CompactVertex out[64];
+	memset(out, 0, sizeof(out));
+	QuantizePositions(in[0].Position, sizeof(FullVertex), 64u, quantization, out, sizeof(CompactVertex));
+	EncodeOctahedralNormals(in[0].Normal, sizeof(FullVertex), 64u, reinterpret_cast<std::uint8_t*>(out) + offsetof(CompactVertex, Normal), sizeof(CompactVertex));
+	EncodeHalf2(in[0].UV, sizeof(FullVertex), 64u, reinterpret_cast<std::uint8_t*>(out) + offsetof(CompactVertex, UV), sizeof(CompactVertex));
+
+	bool same = true;
+	for (std::size_t i = 0u; i < 64u; i++)
+	{
+		std::uint16_t position[4];
+		std::int16_t normal[2];
+		QuantizePosition(Vec3(in[i].Position[0], in[i].Position[1], in[i].Position[2]), quantization, position);
+		EncodeOctahedral(Vec3(in[i].Normal[0], in[i].Normal[1], in[i].Normal[2]), normal);
+		same &= memcmp(position, out[i].Position, sizeof(position)) == 0;
+		same &= normal[0] == out[i].Normal[0] && normal[1] == out[i].Normal[1];
+		same &= FloatToHalf(in[i].UV[0]) == out[i].UV[0] && FloatToHalf(in[i].UV[1]) == out[i].UV[1];
+	}
+	SESS_CHECK(same);
+}
+
+};
+
+int main()
+{
+	CheckHalf();
+	CheckOctahedral();
+	CheckPositions();
+	CheckStreams();
+	return check::Finish("vertex-quantization-check");
+}
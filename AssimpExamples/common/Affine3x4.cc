@@ -0,0 +1,119 @@
+#include <Affine3x4.h>
+#include <Simd.h>
+
+namespace sess
+{
+
+namespace
+{
+
+#if defined(SESS_SSE)
+// One row of the result. Splatting each element of a's row across a register is the
+//  bottleneck here (the shuffle unit is only on one port), so with AVX around they get
+//  broadcast straight from memory instead, which goes through the load ports.
+inline __m128 Row(const float* ar, __m128 b0, __m128 b1, __m128 b2)
+{
+	const __m128 translationOnly = _mm_castsi128_ps(_mm_set_epi32(-1, 0, 0, 0));
+#if defined(SESS_AVX)
+	__m128 acc = _mm_mul_ps(_mm_broadcast_ss(ar), b0);
+	acc = _mm_add_ps(acc, _mm_mul_ps(_mm_broadcast_ss(ar + 1), b1));
+	acc = _mm_add_ps(acc, _mm_mul_ps(_mm_broadcast_ss(ar + 2), b2));
+#else
+	__m128 a = _mm_load_ps(ar);
+	__m128 acc = _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(0, 0, 0, 0)), b0);
+	acc = _mm_add_ps(acc, _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(1, 1, 1, 1)), b1));
+	acc = _mm_add_ps(acc, _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 2, 2, 2)), b2));
+#endif
+	return _mm_add_ps(acc, _mm_and_ps(_mm_load_ps(ar), translationOnly));
+}
+#endif
+
+// Same as the Matrix multiply, with b's missing bottom row treated as 0 0 0 1:
+//  r[i] = a[i][0] * b[0] + a[i][1] * b[1] + a[i][2] * b[2] + (0, 0, 0, a[i][3])
+// That last term is just a's own translation, so three multiply-adds per row instead
+//  of four, and three rows instead of four.
+inline void Multiply(const Affine3x4& a, const Affine3x4& b, Affine3x4& r)
+{
+#if defined(SESS_SSE)
+	__m128 b0 = _mm_load_ps(b.m[0]);
+	__m128 b1 = _mm_load_ps(b.m[1]);
+	__m128 b2 = _mm_load_ps(b.m[2]);
+
+	// Written out row by row on purpose - as a loop into an array (like Matrix does),
+	//  compilers spill the rows to the stack and read them back
+	__m128 r0 = Row(a.m[0], b0, b1, b2);
+	__m128 r1 = Row(a.m[1], b0, b1, b2);
+	__m128 r2 = Row(a.m[2], b0, b1, b2);
+
+	// Stored only once all three are done, in case r is the same matrix as a or b
+	_mm_store_ps(r.m[0], r0);
+	_mm_store_ps(r.m[1], r1);
+	_mm_store_ps(r.m[2], r2);
+#else
+	float tmp[3][4];
+	for (int row = 0; row < 3; row++)
+	{
+		for (int col = 0; col < 4; col++)
+		{
+			tmp[row][col] =
+				a.m[row][0] * b.m[0][col]
+				+ a.m[row][1] * b.m[1][col]
+				+ a.m[row][2] * b.m[2][col]
+				+ (col == 3 ? a.m[row][3] : 0.f);
+		}
+	}
+
+	for (int row = 0; row < 3; row++)
+	{
+		for (int col = 0; col < 4; col++)
+		{
+			r.m[row][col] = tmp[row][col];
+		}
+	}
+#endif
+}
+
+};
+
+Affine3x4 Affine3x4::operator*(const Affine3x4& o) const
+{
+	Affine3x4 r{ NoInit() };
+	Multiply(*this, o, r);
+	return r;
+}
+
+Affine3x4 Affine3x4::Inverse() const
+{
+	// [ A t ]^-1   [ A^-1  -A^-1 t ]
+	// [ 0 1 ]    = [ 0      1      ]
+	// The columns of A^-1 are cross products of the rows of A, over det(A)
+	Vec3 r0(_11, _12, _13);
+	Vec3 r1(_21, _22, _23);
+	Vec3 r2(_31, _32, _33);
+
+	Vec3 c0 = Vec3::Cross(r1, r2);
+	Vec3 c1 = Vec3::Cross(r2, r0);
+	Vec3 c2 = Vec3::Cross(r0, r1);
+
+	float invDet = 1.f / Vec3::Dot(r0, c0);
+	c0 *= invDet;
+	c1 *= invDet;
+	c2 *= invDet;
+
+	Vec3 t(_14, _24, _34);
+
+	return Affine3x4(
+		c0.x, c1.x, c2.x, -(c0.x * t.x + c1.x * t.y + c2.x * t.z),
+		c0.y, c1.y, c2.y, -(c0.y * t.x + c1.y * t.y + c2.y * t.z),
+		c0.z, c1.z, c2.z, -(c0.z * t.x + c1.z * t.y + c2.z * t.z));
+}
+
+void Affine3x4::MultiplyBatch(const Affine3x4* a, const Affine3x4* b, Affine3x4* out, std::size_t n)
+{
+	for (std::size_t i = 0u; i < n; i++)
+	{
+		Multiply(a[i], b[i], out[i]);
+	}
+}
+
+};
@@ -0,0 +1,121 @@
+#pragma once
+
+// 3x4 affine matrix - a Matrix with the bottom row chopped off.
+// Every model matrix in these demos comes out of Transform::GetTransformMatrix, and the
+//  bottom row of those is always 0 0 0 1. Carrying it around costs 16 bytes out of 64
+//  for every object and 7 multiplies out of 64 for every compose, and never changes
+//  the answer. This keeps just the top three rows:
+//  _11 _12 _13 _14     <- x axis scale/rotation, x translation
+//  _21 _22 _23 _24     <- y ...
+//  _31 _32 _33 _34     <- z ...
+// Same column vector convention as Matrix/Transform, so ToMatrix() gives back exactly
+//  what GetTransformMatrix would have. 48 bytes, which is also exactly three shader
+//  constant registers - upload it as a float4x3 (see MaterialOnlyShader.vs.hlsl).
+
+#include <Matrix.h>
+
+#include <cstddef>
+
+namespace sess
+{
+
+class alignas(16) Affine3x4
+{
+public:
+	union
+	{
+		struct
+		{
+			float _11, _12, _13, _14;
+			float _21, _22, _23, _24;
+			float _31, _32, _33, _34;
+		};
+
+		float m[3][4];
+	};
+
+public:
+	constexpr Affine3x4() noexcept
+		: _11(1.f), _12(0.f), _13(0.f), _14(0.f)
+		, _21(0.f), _22(1.f), _23(0.f), _24(0.f)
+		, _31(0.f), _32(0.f), _33(1.f), _34(0.f)
+	{}
+	Affine3x4(const Affine3x4&) = default;
+	constexpr Affine3x4(float m11, float m12, float m13, float m14, float m21, float m22, float m23, float m24, float m31, float m32, float m33, float m34) noexcept
+		: _11(m11), _12(m12), _13(m13), _14(m14)
+		, _21(m21), _22(m22), _23(m23), _24(m24)
+		, _31(m31), _32(m32), _33(m33), _34(m34)
+	{}
+
+	// Drops the bottom row - only makes sense if it was 0 0 0 1 to begin with
+	explicit constexpr Affine3x4(const Matrix& o) noexcept
+		: _11(o._11), _12(o._12), _13(o._13), _14(o._14)
+		, _21(o._21), _22(o._22), _23(o._23), _24(o._24)
+		, _31(o._31), _32(o._32), _33(o._33), _34(o._34)
+	{}
+	~Affine3x4() = default;
+
+	constexpr Matrix ToMatrix() const noexcept
+	{
+		return Matrix(
+			_11, _12, _13, _14,
+			_21, _22, _23, _24,
+			_31, _32, _33, _34,
+			0.f, 0.f, 0.f, 1.f);
+	}
+
+	// Same order as Matrix: a * b applies b first, then a
+	Affine3x4 operator*(const Affine3x4& o) const;
+
+	// Matrix::InverseAffine goes through this too. A matrix that squashes everything flat
+	//  (zero scale on some axis) gives infinities/NaNs back.
+	Affine3x4 Inverse() const;
+
+	Vec3 TransformPoint(const Vec3& p) const noexcept
+	{
+		return Vec3(
+			_11 * p.x + _12 * p.y + _13 * p.z + _14,
+			_21 * p.x + _22 * p.y + _23 * p.z + _24,
+			_31 * p.x + _32 * p.y + _33 * p.z + _34);
+	}
+
+	Vec3 TransformDirection(const Vec3& d) const noexcept
+	{
+		return Vec3(
+			_11 * d.x + _12 * d.y + _13 * d.z,
+			_21 * d.x + _22 * d.y + _23 * d.z,
+			_31 * d.x + _32 * d.y + _33 * d.z);
+	}
+
+	// Normals need the inverse transpose, otherwise non-uniform scale tilts them the
+	//  wrong way (squash a sphere flat and its normals should point more up, not less).
+	//  The inverse transpose is the cofactor matrix over the determinant, and since the
+	//  result gets normalized anyways, only the sign of the determinant matters.
+	Vec3 TransformNormal(const Vec3& n) const noexcept
+	{
+		Vec3 c0(_11, _21, _31);
+		Vec3 c1(_12, _22, _32);
+		Vec3 c2(_13, _23, _33);
+
+		Vec3 cof0 = Vec3::Cross(c1, c2);
+		Vec3 r = cof0 * n.x + Vec3::Cross(c2, c0) * n.y + Vec3::Cross(c0, c1) * n.z;
+		return (Vec3::Dot(c0, cof0) < 0.f) ? -r.Normal() : r.Normal();
+	}
+
+	// out[i] = a[i] * b[i] for every i < n. out may alias a or b.
+	// Same idea as Matrix::MultiplyBatch, for placing lots of instances at once.
+	static void MultiplyBatch(const Affine3x4* a, const Affine3x4* b, Affine3x4* out, std::size_t n);
+
+public:
+	static const Affine3x4 Identity;
+
+private:
+	struct NoInit {};
+	explicit Affine3x4(NoInit) noexcept {}
+};
+
+inline constexpr Affine3x4 Affine3x4::Identity = Affine3x4();
+
+static_assert(sizeof(Affine3x4) == 48u, "Affine3x4 has to match a float4x3 in a constant buffer");
+
+};
@@ -0,0 +1,380 @@
+#include <AssetPack.h>
+
+#include <lodepng.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+namespace sess
+{
+
+namespace
+{
+
+const char MAGIC[8] = { 'S', 'E', 'S', 'S', 'P', 'A', 'C', 'K' };
+
+struct FileHeader
+{
+	char Magic[8];
+	std::uint32_t Version;
+	std::uint32_t EntryCount;
+	std::uint64_t NamesOffset;
+	std::uint64_t NamesSize;
+};
+
+// If either of these trip, the layout changed - bump AssetPack::Version
+static_assert(sizeof(FileHeader) == 32u, "Pack header layout changed");
+static_assert(sizeof(AssetPack::Entry) == 40u, "Pack entry layout changed");
+
+// FNV-1a, 64 bit - same as the mesh cache uses for its source hash
+const std::uint64_t FNV_OFFSET = 14695981039346656037ull;
+const std::uint64_t FNV_PRIME = 1099511628211ull;
+
+constexpr std::uint64_t AlignTo(std::uint64_t offset, std::uint64_t alignment)
+{
+	return (offset + alignment - 1u) & ~(alignment - 1u);
+}
+
+// Is [offset, offset + size) inside a file of fileSize bytes, without overflowing?
+bool InFile(std::uint64_t offset, std::uint64_t size, std::uint64_t fileSize)
+{
+	return offset <= fileSize && size <= fileSize - offset;
+}
+
+bool HashLess(const AssetPack::Entry& entry, std::uint64_t hash)
+{
+	return entry.NameHash < hash;
+}
+
+};
+
+//
+// AssetData
+//
+AssetData::AssetData()
+	: data_(nullptr)
+	, size_(0u)
+{}
+
+const std::uint8_t* AssetData::GetData() const
+{
+	return data_;
+}
+
+std::size_t AssetData::GetSize() const
+{
+	return size_;
+}
+
+void AssetData::Clear()
+{
+	data_ = nullptr;
+	size_ = 0u;
+	inflated_.clear();
+	looseFile_.Close();
+}
+
+//
+// AssetPack
+//
+AssetPack::AssetPack()
+	: names_(nullptr)
+	, namesSize_(0u)
+{}
+
+bool AssetPack::Open(const char* fName)
+{
+	entries_.clear();
+	names_ = nullptr;
+	namesSize_ = 0u;
+
+	// Random, not sequential - assets get pulled out of the middle of the file in whatever
+	//  order the demo asks for them, and most of the pack might never be touched at all
+	if (!file_.Open(fName, MappedFile::Access::Random))
+	{
+		return false;
+	}
+
+	std::uint64_t fileSize = file_.GetSize();
+	FileHeader header;
+	if (fileSize < sizeof(header))
+	{
+		std::cerr << "Asset pack " << fName << " is truncated" << std::endl;
+		file_.Close();
+		return false;
+	}
+
+	memcpy(&header, file_.GetData(), sizeof(header));
+	if (memcmp(header.Magic, MAGIC, sizeof(MAGIC)) != 0 || header.Version != Version)
+	{
+		std::cerr << fName << " is not an asset pack, or was made by a different version of the packer" << std::endl;
+		file_.Close();
+		return false;
+	}
+
+	if (!InFile(sizeof(FileHeader), std::uint64_t(header.EntryCount) * sizeof(Entry), fileSize)
+		|| !InFile(header.NamesOffset, header.NamesSize, fileSize))
+	{
+		std::cerr << "Asset pack " << fName << " is truncated" << std::endl;
+		file_.Close();
+		return false;
+	}
+
+	// Copied out instead of used in place - a few KB at most, and this way nothing has to
+	//  worry about how the mapping happens to be aligned
+	entries_.resize(header.EntryCount);
+	if (header.EntryCount > 0u)
+	{
+		memcpy(entries_.data(), file_.GetData() + sizeof(FileHeader), entries_.size() * sizeof(Entry));
+	}
+
+	// Check every entry now, so Load() can trust them later
+	for (auto&& entry : entries_)
+	{
+		if (!InFile(entry.Offset, entry.StoredSize, fileSize)
+			|| !InFile(entry.NameOffset, entry.NameLength, header.NamesSize)
+			|| entry.CompressionType > Compression::Zlib
+			|| (entry.CompressionType == Compression::None && entry.StoredSize != entry.Size))
+		{
+			std::cerr << "Asset pack " << fName << " is corrupt" << std::endl;
+			entries_.clear();
+			file_.Close();
+			return false;
+		}
+	}
+
+	// The packer already sorts them, but it's cheap to not depend on that
+	std::sort(entries_.begin(), entries_.end(), [](const Entry& a, const Entry& b) { return a.NameHash < b.NameHash; });
+
+	names_ = reinterpret_cast<const char*>(file_.GetData()) + header.NamesOffset;
+	namesSize_ = static_cast<std::size_t>(header.NamesSize);
+
+	return true;
+}
+
+bool AssetPack::IsOpen() const
+{
+	return file_.IsOpen();
+}
+
+bool AssetPack::Load(const char* path, AssetData& out) const
+{
+	const Entry* entry = IsOpen() ? Find(NormalizeName(path)) : nullptr;
+	if (entry == nullptr)
+	{
+		// Not packed - straight from the disk then
+		return LoadLoose(path, out);
+	}
+
+	out.Clear();
+
+	const std::uint8_t* stored = file_.GetData() + entry->Offset;
+	if (entry->CompressionType == Compression::None)
+	{
+		// The good case - no copy at all, the bytes are used right where they're mapped
+		out.data_ = stored;
+		out.size_ = static_cast<std::size_t>(entry->Size);
+		return true;
+	}
+
+	out.inflated_.reserve(static_cast<std::size_t>(entry->Size));
+	unsigned int error = lodepng::decompress(out.inflated_, stored, static_cast<std::size_t>(entry->StoredSize));
+	if (error != 0u || out.inflated_.size() != entry->Size)
+	{
+		std::cerr << "Could not inflate " << path << " from the asset pack: " << lodepng_error_text(error) << std::endl;
+		out.inflated_.clear();
+		return false;
+	}
+
+	out.data_ = out.inflated_.data();
+	out.size_ = out.inflated_.size();
+	return true;
+}
+
+bool AssetPack::Contains(const char* path) const
+{
+	return Find(NormalizeName(path)) != nullptr;
+}
+
+bool AssetPack::LoadLoose(const char* path, AssetData& out)
+{
+	out.Clear();
+	if (!out.looseFile_.Open(path, MappedFile::Access::Sequential))
+	{
+		return false;
+	}
+
+	out.data_ = out.looseFile_.GetData();
+	out.size_ = out.looseFile_.GetSize();
+	return true;
+}
+
+std::string AssetPack::NormalizeName(const char* path)
+{
+	std::string name(path);
+	std::replace(name.begin(), name.end(), '\\', '/');
+
+	// Everything is relative to AssimpExamples, and the demos run from one folder below that
+	for (;;)
+	{
+		if (name.compare(0u, 2u, "./") == 0)
+		{
+			name.erase(0u, 2u);
+		}
+		else if (name.compare(0u, 3u, "../") == 0)
+		{
+			name.erase(0u, 3u);
+		}
+		else
+		{
+			break;
+		}
+	}
+
+	std::transform(name.begin(), name.end(), name.begin(), [](char c) { return static_cast<char>(std::tolower(static_cast<unsigned char>(c))); });
+	return name;
+}
+
+std::uint64_t AssetPack::HashName(const std::string& normalizedName)
+{
+	std::uint64_t hash = FNV_OFFSET;
+	for (char c : normalizedName)
+	{
+		hash = (hash ^ static_cast<std::uint8_t>(c)) * FNV_PRIME;
+	}
+	return hash;
+}
+
+const AssetPack::Entry* AssetPack::Find(const std::string& normalizedName) const
+{
+	std::uint64_t hash = HashName(normalizedName);
+
+	// Two names with the same hash are unlikely but not impossible, so check the name too
+	for (auto it = std::lower_bound(entries_.begin(), entries_.end(), hash, HashLess);
+		it != entries_.end() && it->NameHash == hash; ++it)
+	{
+		if (it->NameLength == normalizedName.size()
+			&& memcmp(names_ + it->NameOffset, normalizedName.data(), normalizedName.size()) == 0)
+		{
+			return &*it;
+		}
+	}
+
+	return nullptr;
+}
+
+//
+// AssetPackWriter
+//
+bool AssetPackWriter::Add(const char* name, std::vector<std::uint8_t> data, AssetPack::Compression compression)
+{
+	std::string normalizedName = AssetPack::NormalizeName(name);
+	if (normalizedName.empty() || normalizedName.size() > 0xFFFFu)
+	{
+		std::cerr << "Bad asset name \"" << name << "\"" << std::endl;
+		return false;
+	}
+
+	for (auto&& pending : pending_)
+	{
+		if (pending.Name == normalizedName)
+		{
+			std::cerr << "Asset " << normalizedName << " is already in the pack" << std::endl;
+			return false;
+		}
+	}
+
+	Pending pending;
+	pending.Name = normalizedName;
+	pending.Size = data.size();
+	pending.Compression = AssetPack::Compression::None;
+
+	if (compression == AssetPack::Compression::Zlib && !data.empty())
+	{
+		std::vector<std::uint8_t> compressed;
+		if (lodepng::compress(compressed, data) == 0u && compressed.size() < data.size())
+		{
+			pending.Compression = AssetPack::Compression::Zlib;
+			pending.Stored = std::move(compressed);
+		}
+	}
+
+	if (pending.Compression == AssetPack::Compression::None)
+	{
+		pending.Stored = std::move(data);
+	}
+
+	pending_.push_back(std::move(pending));
+	return true;
+}
+
+bool AssetPackWriter::Write(const char* fName) const
+{
+	// Lay everything out first...
+	std::vector<AssetPack::Entry> entries(pending_.size());
+	std::uint64_t namesSize = 0u;
+	for (std::size_t entryIdx = 0u; entryIdx < pending_.size(); entryIdx++)
+	{
+		const Pending& pending = pending_[entryIdx];
+		AssetPack::Entry& entry = entries[entryIdx];
+
+		entry.NameHash = AssetPack::HashName(pending.Name);
+		entry.StoredSize = pending.Stored.size();
+		entry.Size = pending.Size;
+		entry.NameOffset = static_cast<std::uint32_t>(namesSize);
+		entry.NameLength = static_cast<std::uint16_t>(pending.Name.size());
+		entry.CompressionType = pending.Compression;
+		namesSize += pending.Name.size();
+	}
+
+	FileHeader header = {};
+	memcpy(header.Magic, MAGIC, sizeof(MAGIC));
+	header.Version = AssetPack::Version;
+	header.EntryCount = static_cast<std::uint32_t>(entries.size());
+	header.NamesOffset = sizeof(FileHeader) + entries.size() * sizeof(AssetPack::Entry);
+	header.NamesSize = namesSize;
+
+	std::uint64_t offset = header.NamesOffset + namesSize;
+	for (auto&& entry : entries)
+	{
+		offset = AlignTo(offset, AssetPack::Alignment);
+		entry.Offset = offset;
+		offset += entry.StoredSize;
+	}
+
+	// ... then fill in one buffer and write it all in one go
+	std::vector<std::uint8_t> file(static_cast<std::size_t>(offset), 0u);
+	memcpy(file.data(), &header, sizeof(header));
+	for (std::size_t entryIdx = 0u; entryIdx < pending_.size(); entryIdx++)
+	{
+		const Pending& pending = pending_[entryIdx];
+		const AssetPack::Entry& entry = entries[entryIdx];
+
+		memcpy(file.data() + header.NamesOffset + entry.NameOffset, pending.Name.data(), pending.Name.size());
+		if (!pending.Stored.empty())
+		{
+			memcpy(file.data() + entry.Offset, pending.Stored.data(), pending.Stored.size());
+		}
+	}
+
+	// Table of contents goes in sorted, so a lookup is a binary search
+	std::sort(entries.begin(), entries.end(), [](const AssetPack::Entry& a, const AssetPack::Entry& b) { return a.NameHash < b.NameHash; });
+	if (!entries.empty())
+	{
+		memcpy(file.data() + sizeof(FileHeader), entries.data(), entries.size() * sizeof(AssetPack::Entry));
+	}
+
+	std::ofstream out(fName, std::ios::binary | std::ios::trunc);
+	if (!out || !out.write(reinterpret_cast<const char*>(file.data()), file.size()))
+	{
+		std::cerr << "Could not write asset pack " << fName << std::endl;
+		return false;
+	}
+
+	return true;
+}
+
+};
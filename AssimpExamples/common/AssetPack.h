@@ -0,0 +1,141 @@
+#pragma once
+
+// Asset pack - all of the demo's files (models, textures, compiled shaders...) rolled up
+//  into one big file, made ahead of time by the packer (see packer/AssetPacker.cc).
+// Opening a dozen loose files means a dozen trips through the file system (path lookup,
+//  permission checks, open, read, close). With a pack it's one open and one map, and
+//  every asset after that is a binary search in a table that's already in memory.
+//
+// Assets are named by their path relative to the AssimpExamples folder, with forward
+//  slashes: "assets/road.fbx", "cso/TexturedShader.vs.cso". Load() also takes the paths
+//  the demos already use ("../assets/road.fbx") and figures out which entry is meant.
+// Anything that isn't in the pack (or all of it, if there's no pack) gets loaded from
+//  the loose file instead, so the pack is purely an optimization.
+//
+// File layout, everything little endian:
+//  Header          magic, version, entry count, where the names start
+//  Entry[count]    sorted by name hash: hash, where the data is, sizes, compression, name
+//  names           all entry names back to back, no terminators
+//  data            every entry starts on a 16 byte boundary
+
+#include <MappedFile.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace sess
+{
+
+// The bytes of one asset, wherever they ended up coming from. Depending on that, they
+//  live in the mapped pack, a mapped loose file or a buffer of inflated data - whoever
+//  is using them doesn't have to care which.
+class AssetData
+{
+public:
+	AssetData();
+	AssetData(const AssetData&) = delete;
+	~AssetData() = default;
+
+	const std::uint8_t* GetData() const;
+	std::size_t GetSize() const;
+
+private:
+	friend class AssetPack;
+
+	void Clear();
+
+private:
+	const std::uint8_t* data_;
+	std::size_t size_;
+	std::vector<std::uint8_t> inflated_;
+	MappedFile looseFile_;
+};
+
+class AssetPack
+{
+public:
+	enum class Compression : std::uint16_t
+	{
+		None = 0,
+		Zlib = 1, // Through LodePNG's zlib, since it's already in the project for the textures
+	};
+
+public:
+	AssetPack();
+	AssetPack(const AssetPack&) = delete;
+	~AssetPack() = default;
+
+	// False if the pack is missing or broken - everything will come from loose files then
+	bool Open(const char* fName);
+	bool IsOpen() const;
+
+	// Bytes of the asset at path, from the pack if it's in there and from the file at path
+	//  otherwise. Safe to call from several threads at once.
+	bool Load(const char* path, AssetData& out) const;
+	bool Contains(const char* path) const;
+
+	// Only ever the file at path, whether or not the pack has something by that name
+	static bool LoadLoose(const char* path, AssetData& out);
+
+	// "../assets\Road.FBX" -> "assets/road.fbx". Leading ./ and ../ go, slashes go forward
+	//  and everything goes lowercase (Windows doesn't care about case, so neither do we).
+	static std::string NormalizeName(const char* path);
+
+	static std::uint64_t HashName(const std::string& normalizedName);
+
+public:
+	static constexpr std::uint32_t Version = 1u;
+	static constexpr std::size_t Alignment = 16u;
+
+	// What's stored in the file for every asset
+	struct Entry
+	{
+		std::uint64_t NameHash;
+		std::uint64_t Offset; // Where the (possibly compressed) bytes start
+		std::uint64_t StoredSize; // Bytes in the pack
+		std::uint64_t Size; // Bytes once inflated
+		std::uint32_t NameOffset; // From the start of the names block
+		std::uint16_t NameLength;
+		Compression CompressionType;
+	};
+
+private:
+	const Entry* Find(const std::string& normalizedName) const;
+
+private:
+	MappedFile file_;
+	std::vector<Entry> entries_; // Copied out of the file, sorted by NameHash
+	const char* names_;
+	std::size_t namesSize_;
+};
+
+// Builds a pack file. Used by the packer tool, but nothing stops a demo from using it.
+class AssetPackWriter
+{
+public:
+	AssetPackWriter() = default;
+	AssetPackWriter(const AssetPackWriter&) = delete;
+	~AssetPackWriter() = default;
+
+	// name is normalized (see AssetPack::NormalizeName). Compression is only kept if it
+	//  actually makes the entry smaller - already compressed things like PNGs won't shrink.
+	// False if there's already an entry with that name.
+	bool Add(const char* name, std::vector<std::uint8_t> data, AssetPack::Compression compression);
+
+	bool Write(const char* fName) const;
+
+private:
+	struct Pending
+	{
+		std::string Name;
+		std::uint64_t Size;
+		AssetPack::Compression Compression;
+		std::vector<std::uint8_t> Stored;
+	};
+
+	std::vector<Pending> pending_;
+};
+
+};
@@ -0,0 +1,176 @@
+#include <Bounds.h>
+#include <Simd.h>
+
+namespace sess
+{
+
+namespace
+{
+
+// Min/max over a packed x, y, z, x, y, z... float stream without any shuffling: three
+//  registers' worth of floats always holds a whole number of points, so if the stream is
+//  read three registers at a time, each lane of each register always lands on the same
+//  component. Keep a running min and max per register, and sort out which lane was which
+//  component once at the very end.
+template <typename Ops>
+inline std::size_t MinMaxBlocks(const float* xyz, std::size_t count, float (&lo)[3], float (&hi)[3])
+{
+	using V = typename Ops::V;
+	const std::size_t POINTS_PER_BLOCK = Ops::WIDTH; // 3 registers of WIDTH floats = WIDTH points
+
+	if (count < POINTS_PER_BLOCK)
+	{
+		return 0u;
+	}
+
+	V mn[3], mx[3];
+	for (int r = 0; r < 3; r++)
+	{
+		mn[r] = mx[r] = Ops::Load(xyz + r * Ops::WIDTH);
+	}
+
+	std::size_t i = POINTS_PER_BLOCK;
+	for (; i + POINTS_PER_BLOCK <= count; i += POINTS_PER_BLOCK)
+	{
+		const float* block = xyz + 3u * i;
+		for (int r = 0; r < 3; r++)
+		{
+			V v = Ops::Load(block + r * Ops::WIDTH);
+			mn[r] = Ops::Min(mn[r], v);
+			mx[r] = Ops::Max(mx[r], v);
+		}
+	}
+
+	float mnLanes[3 * Ops::WIDTH], mxLanes[3 * Ops::WIDTH];
+	for (int r = 0; r < 3; r++)
+	{
+		Ops::Store(mnLanes + r * Ops::WIDTH, mn[r]);
+		Ops::Store(mxLanes + r * Ops::WIDTH, mx[r]);
+	}
+	for (std::size_t lane = 0u; lane < 3u * Ops::WIDTH; lane++)
+	{
+		lo[lane % 3u] = std::min(lo[lane % 3u], mnLanes[lane]);
+		hi[lane % 3u] = std::max(hi[lane % 3u], mxLanes[lane]);
+	}
+
+	return i;
+}
+
+#if defined(SESS_SSE)
+struct SSEOps
+{
+	using V = __m128;
+	static const std::size_t WIDTH = 4u;
+	static V Load(const float* p) { return _mm_loadu_ps(p); }
+	static void Store(float* p, V v) { _mm_storeu_ps(p, v); }
+	static V Min(V a, V b) { return _mm_min_ps(a, b); }
+	static V Max(V a, V b) { return _mm_max_ps(a, b); }
+};
+#endif
+
+#if defined(SESS_AVX)
+struct AVXOps
+{
+	using V = __m256;
+	static const std::size_t WIDTH = 8u;
+	static V Load(const float* p) { return _mm256_loadu_ps(p); }
+	static void Store(float* p, V v) { _mm256_storeu_ps(p, v); }
+	static V Min(V a, V b) { return _mm256_min_ps(a, b); }
+	static V Max(V a, V b) { return _mm256_max_ps(a, b); }
+};
+#endif
+
+inline Vec3 PointAt(const float* xyz, std::size_t idx)
+{
+	return Vec3(xyz[3u * idx], xyz[3u * idx + 1u], xyz[3u * idx + 2u]);
+}
+
+};
+
+AABB AABB::FromPoints(const float* xyz, std::size_t count)
+{
+	float lo[3] = { FLT_MAX, FLT_MAX, FLT_MAX };
+	float hi[3] = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+
+	std::size_t i = 0u;
+#if defined(SESS_AVX)
+	i = MinMaxBlocks<AVXOps>(xyz, count, lo, hi);
+#elif defined(SESS_SSE)
+	i = MinMaxBlocks<SSEOps>(xyz, count, lo, hi);
+#endif
+
+	for (; i < count; i++)
+	{
+		for (int c = 0; c < 3; c++)
+		{
+			lo[c] = std::min(lo[c], xyz[3u * i + c]);
+			hi[c] = std::max(hi[c], xyz[3u * i + c]);
+		}
+	}
+
+	return AABB(Vec3(lo[0], lo[1], lo[2]), Vec3(hi[0], hi[1], hi[2]));
+}
+
+BoundingSphere BoundingSphere::FromPoints(const float* xyz, std::size_t count)
+{
+	if (count == 0u)
+	{
+		return Empty();
+	}
+
+	// First pass: the points with the smallest and largest x, y and z
+	std::size_t minIdx[3] = { 0u, 0u, 0u };
+	std::size_t maxIdx[3] = { 0u, 0u, 0u };
+	for (std::size_t i = 1u; i < count; i++)
+	{
+		for (int c = 0; c < 3; c++)
+		{
+			float v = xyz[3u * i + c];
+			if (v < xyz[3u * minIdx[c] + c]) minIdx[c] = i;
+			if (v > xyz[3u * maxIdx[c] + c]) maxIdx[c] = i;
+		}
+	}
+
+	// Whichever of those three pairs is furthest apart makes the starting diameter
+	Vec3 a = PointAt(xyz, minIdx[0]);
+	Vec3 b = PointAt(xyz, maxIdx[0]);
+	for (int c = 1; c < 3; c++)
+	{
+		Vec3 ca = PointAt(xyz, minIdx[c]);
+		Vec3 cb = PointAt(xyz, maxIdx[c]);
+		if (Vec3::Dot(cb - ca, cb - ca) > Vec3::Dot(b - a, b - a))
+		{
+			a = ca;
+			b = cb;
+		}
+	}
+
+	Vec3 center = (a + b) * 0.5f;
+	float radius = (b - a).Magnitude() * 0.5f;
+	float radiusSq = radius * radius;
+
+	// Second pass: any point still outside pulls the sphere towards itself, just far
+	//  enough that the new sphere touches the point and the far side of the old one
+	for (std::size_t i = 0u; i < count; i++)
+	{
+		Vec3 toPoint = PointAt(xyz, i) - center;
+		float distSq = Vec3::Dot(toPoint, toPoint);
+		if (distSq > radiusSq)
+		{
+			float dist = sqrtf(distSq);
+			float newRadius = (radius + dist) * 0.5f;
+			center += toPoint * ((newRadius - radius) / dist);
+			radius = newRadius;
+			radiusSq = radius * radius;
+		}
+	}
+
+	// Rounding in the center updates can leave the odd point a hair outside. That rounding
+	//  (and the rounding in whatever tests points against the sphere later) is relative to
+	//  the coordinates, not the radius - a small mesh far from the origin needs more room
+	//  than its radius alone would give it.
+	float magnitude = std::max(fabsf(center.x), std::max(fabsf(center.y), fabsf(center.z)));
+	return BoundingSphere(center, radius + FLT_EPSILON * 4.f * (radius + magnitude));
+}
+
+};
@@ -0,0 +1,146 @@
+#pragma once
+
+// Bounding volumes - cheap shapes that are guaranteed to contain some more
+//  complicated geometry. If the camera can't see the bounding volume, it can't
+//  see anything inside of it either, so the whole thing can be skipped.
+// Two flavors, because each one is better at different shapes:
+//  - AABB (axis aligned bounding box): snug around boxy things like the road
+//  - BoundingSphere: one number for size, so it's the cheapest thing to test
+// Meshes get both (see Bounds at the bottom), computed once when they're loaded.
+
+#include <Matrix.h>
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstddef>
+
+namespace sess
+{
+
+struct AABB
+{
+public:
+	Vec3 Min;
+	Vec3 Max;
+
+public:
+	constexpr AABB() noexcept : Min(), Max() {}
+	constexpr AABB(const Vec3& min, const Vec3& max) noexcept : Min(min), Max(max) {}
+
+	// Box around nothing at all - merging anything into it gives back the other box
+	static constexpr AABB Empty() noexcept
+	{
+		return AABB(Vec3(FLT_MAX, FLT_MAX, FLT_MAX), Vec3(-FLT_MAX, -FLT_MAX, -FLT_MAX));
+	}
+
+	// Tightest box around a bunch of points. xyz is x, y, z for the first point, then
+	//  x, y, z for the second and so on - the layout of both Vec3 and aiVector3D arrays.
+	static AABB FromPoints(const float* xyz, std::size_t count);
+
+	static AABB Merge(const AABB& a, const AABB& b) noexcept
+	{
+		return AABB(
+			Vec3(std::min(a.Min.x, b.Min.x), std::min(a.Min.y, b.Min.y), std::min(a.Min.z, b.Min.z)),
+			Vec3(std::max(a.Max.x, b.Max.x), std::max(a.Max.y, b.Max.y), std::max(a.Max.z, b.Max.z)));
+	}
+
+	constexpr Vec3 Center() const noexcept { return (Min + Max) * 0.5f; }
+	constexpr Vec3 Extents() const noexcept { return (Max - Min) * 0.5f; }
+
+	// Bounds of this box after going through m (column vector convention, like
+	//  Transform::GetTransformMatrix). Rotating a box makes it poke out further along
+	//  the axes, so the result is the box around the rotated box - still a valid bound,
+	//  just a bit looser than the original.
+	AABB Transformed(const Matrix& m) const noexcept
+	{
+		Vec3 c = m.TransformPoint(Center());
+		Vec3 e = Extents();
+		Vec3 newExtents(
+			fabsf(m._11) * e.x + fabsf(m._12) * e.y + fabsf(m._13) * e.z,
+			fabsf(m._21) * e.x + fabsf(m._22) * e.y + fabsf(m._23) * e.z,
+			fabsf(m._31) * e.x + fabsf(m._32) * e.y + fabsf(m._33) * e.z);
+		return AABB(c - newExtents, c + newExtents);
+	}
+};
+
+struct BoundingSphere
+{
+public:
+	Vec3 Center;
+	float Radius;
+
+public:
+	constexpr BoundingSphere() noexcept : Center(), Radius(0.f) {}
+	constexpr BoundingSphere(const Vec3& center, float radius) noexcept : Center(center), Radius(radius) {}
+
+	// A negative radius means "contains nothing", same idea as AABB::Empty
+	static constexpr BoundingSphere Empty() noexcept { return BoundingSphere(Vec3(), -1.f); }
+
+	// Ritter's algorithm - start from the two points furthest apart along x, y or z, then
+	//  grow the sphere to take in every point that's still outside. Not the smallest
+	//  possible sphere (usually within 5-20% of it), but only two passes over the points.
+	// Same point layout as AABB::FromPoints.
+	static BoundingSphere FromPoints(const float* xyz, std::size_t count);
+
+	// Smallest sphere containing both spheres
+	static BoundingSphere Merge(const BoundingSphere& a, const BoundingSphere& b) noexcept
+	{
+		if (a.Radius < 0.f) return b;
+		if (b.Radius < 0.f) return a;
+
+		Vec3 toB = b.Center - a.Center;
+		float dist = toB.Magnitude();
+		if (dist + b.Radius <= a.Radius) return a;
+		if (dist + a.Radius <= b.Radius) return b;
+
+		float radius = (dist + a.Radius + b.Radius) * 0.5f;
+		return BoundingSphere(a.Center + toB * ((radius - a.Radius) / dist), radius);
+	}
+
+	// Smallest sphere around the box - not the smallest sphere around whatever is in
+	//  the box, but good enough for a start
+	static BoundingSphere FromAABB(const AABB& box) noexcept
+	{
+		return BoundingSphere(box.Center(), box.Extents().Magnitude());
+	}
+
+	// Non-uniform scale squashes a sphere into an ellipsoid, so the radius grows by
+	//  the largest scale of the three axes to keep containing it
+	BoundingSphere Transformed(const Matrix& m) const noexcept
+	{
+		float sx = Vec3(m._11, m._21, m._31).Magnitude();
+		float sy = Vec3(m._12, m._22, m._32).Magnitude();
+		float sz = Vec3(m._13, m._23, m._33).Magnitude();
+		return BoundingSphere(m.TransformPoint(Center), Radius * std::max(sx, std::max(sy, sz)));
+	}
+};
+
+// Both kinds of bounds for the same geometry, so whoever uses them can pick
+struct Bounds
+{
+public:
+	AABB Box;
+	BoundingSphere Sphere;
+
+public:
+	constexpr Bounds() noexcept : Box(AABB::Empty()), Sphere(BoundingSphere::Empty()) {}
+	constexpr Bounds(const AABB& box, const BoundingSphere& sphere) noexcept : Box(box), Sphere(sphere) {}
+
+	static Bounds FromPoints(const float* xyz, std::size_t count)
+	{
+		return Bounds(AABB::FromPoints(xyz, count), BoundingSphere::FromPoints(xyz, count));
+	}
+
+	static Bounds Merge(const Bounds& a, const Bounds& b) noexcept
+	{
+		return Bounds(AABB::Merge(a.Box, b.Box), BoundingSphere::Merge(a.Sphere, b.Sphere));
+	}
+
+	Bounds Transformed(const Matrix& m) const noexcept
+	{
+		return Bounds(Box.Transformed(m), Sphere.Transformed(m));
+	}
+};
+
+};
@@ -0,0 +1,169 @@
+#include <DualQuaternion.h>
+#include <Simd.h>
+
+#include <assimp/mesh.h>
+
+namespace sess
+{
+
+static_assert(sizeof(DualQuaternion) == 8u * sizeof(float), "Blend loads a dual quaternion as eight packed floats");
+
+namespace
+{
+
+// A blend whose rotation part is shorter than this (squared) has nothing left to
+//  normalize - all four weights were 0, so it's the identity instead of 0 / 0
+constexpr float MIN_BLEND_LENGTH_SQ = 1e-12f;
+
+#if defined(SESS_SSE)
+// Dot product of two quaternions, copied into all four lanes
+inline __m128 Dot4(__m128 a, __m128 b)
+{
+	__m128 m = _mm_mul_ps(a, b);
+	m = _mm_add_ps(m, _mm_shuffle_ps(m, m, _MM_SHUFFLE(2, 3, 0, 1)));
+	return _mm_add_ps(m, _mm_shuffle_ps(m, m, _MM_SHUFFLE(1, 0, 3, 2)));
+}
+#endif
+
+};
+
+std::vector<SkinInfluences> GatherSkinInfluences(const aiMesh* mesh)
+{
+	std::vector<SkinInfluences> influences(mesh->mNumVertices, SkinInfluences{ { 0.f, 0.f, 0.f, 0.f }, { 0u, 0u, 0u, 0u } });
+
+	for (std::uint32_t boneIdx = 0u; boneIdx < mesh->mNumBones; boneIdx++)
+	{
+		const aiBone* bone = mesh->mBones[boneIdx];
+		for (std::uint32_t weightIdx = 0u; weightIdx < bone->mNumWeights; weightIdx++)
+		{
+			const aiVertexWeight& vw = bone->mWeights[weightIdx];
+			SkinInfluences& vert = influences[vw.mVertexId];
+
+			// Replace whichever slot is weakest, if this bone pulls harder than it
+			int weakest = 0;
+			for (int slot = 1; slot < 4; slot++)
+			{
+				if (vert.Weights[slot] < vert.Weights[weakest]) weakest = slot;
+			}
+			if (vw.mWeight > vert.Weights[weakest])
+			{
+				vert.Weights[weakest] = vw.mWeight;
+				vert.Bones[weakest] = (std::uint16_t)boneIdx;
+			}
+		}
+	}
+
+	for (SkinInfluences& vert : influences)
+	{
+		float total = vert.Weights[0] + vert.Weights[1] + vert.Weights[2] + vert.Weights[3];
+		if (total > 0.f)
+		{
+			for (float& w : vert.Weights) w /= total;
+		}
+	}
+
+	return influences;
+}
+
+DualQuaternion DualQuaternion::Blend(const DualQuaternion* palette, const SkinInfluences& influences)
+{
+	const DualQuaternion& pivot = palette[influences.Bones[0]];
+
+#if defined(SESS_AVX)
+	// One whole dual quaternion per register - real part in the low half, dual in the high
+	__m128 pivotReal = _mm_loadu_ps(&pivot.Real.x);
+	__m128 signBit = _mm_set1_ps(-0.f);
+	__m256 acc = _mm256_setzero_ps();
+	for (int i = 0; i < 4; i++)
+	{
+		const DualQuaternion& dq = palette[influences.Bones[i]];
+		__m256 v = _mm256_loadu_ps(&dq.Real.x);
+
+		__m128 w = _mm_xor_ps(_mm_set1_ps(influences.Weights[i]), _mm_and_ps(Dot4(pivotReal, _mm256_castps256_ps128(v)), signBit));
+		acc = _mm256_add_ps(acc, _mm256_mul_ps(v, _mm256_insertf128_ps(_mm256_castps128_ps256(w), w, 1)));
+	}
+
+	__m128 lenSq = Dot4(_mm256_castps256_ps128(acc), _mm256_castps256_ps128(acc));
+	if (_mm_cvtss_f32(lenSq) < MIN_BLEND_LENGTH_SQ)
+	{
+		return DualQuaternion::Identity;
+	}
+
+	__m128 len = _mm_sqrt_ps(lenSq);
+	acc = _mm256_div_ps(acc, _mm256_insertf128_ps(_mm256_castps128_ps256(len), len, 1));
+
+	DualQuaternion result;
+	_mm256_storeu_ps(&result.Real.x, acc);
+	return result;
+#elif defined(SESS_SSE)
+	__m128 pivotReal = _mm_loadu_ps(&pivot.Real.x);
+	__m128 signBit = _mm_set1_ps(-0.f);
+	__m128 accReal = _mm_setzero_ps();
+	__m128 accDual = _mm_setzero_ps();
+	for (int i = 0; i < 4; i++)
+	{
+		const DualQuaternion& dq = palette[influences.Bones[i]];
+		__m128 real = _mm_loadu_ps(&dq.Real.x);
+		__m128 dual = _mm_loadu_ps(&dq.Dual.x);
+
+		__m128 w = _mm_xor_ps(_mm_set1_ps(influences.Weights[i]), _mm_and_ps(Dot4(pivotReal, real), signBit));
+		accReal = _mm_add_ps(accReal, _mm_mul_ps(real, w));
+		accDual = _mm_add_ps(accDual, _mm_mul_ps(dual, w));
+	}
+
+	__m128 lenSq = Dot4(accReal, accReal);
+	if (_mm_cvtss_f32(lenSq) < MIN_BLEND_LENGTH_SQ)
+	{
+		return DualQuaternion::Identity;
+	}
+
+	__m128 len = _mm_sqrt_ps(lenSq);
+
+	DualQuaternion result;
+	_mm_storeu_ps(&result.Real.x, _mm_div_ps(accReal, len));
+	_mm_storeu_ps(&result.Dual.x, _mm_div_ps(accDual, len));
+	return result;
+#else
+	float acc[8] = {};
+	for (int i = 0; i < 4; i++)
+	{
+		const DualQuaternion& dq = palette[influences.Bones[i]];
+		float w = Quaternion::Dot(pivot.Real, dq.Real) < 0.f ? -influences.Weights[i] : influences.Weights[i];
+		const float* src = &dq.Real.x;
+		for (int c = 0; c < 8; c++)
+		{
+			acc[c] += src[c] * w;
+		}
+	}
+
+	float lenSq = acc[0] * acc[0] + acc[1] * acc[1] + acc[2] * acc[2] + acc[3] * acc[3];
+	if (lenSq < MIN_BLEND_LENGTH_SQ)
+	{
+		return DualQuaternion::Identity;
+	}
+
+	float len = sqrtf(lenSq);
+	return DualQuaternion(
+		Quaternion::FromComponents(acc[3] / len, acc[0] / len, acc[1] / len, acc[2] / len),
+		Quaternion::FromComponents(acc[7] / len, acc[4] / len, acc[5] / len, acc[6] / len));
+#endif
+}
+
+void SkinVertices(
+	const DualQuaternion* palette, const SkinInfluences* influences,
+	const Vec3* positions, const Vec3* normals,
+	Vec3* outPositions, Vec3* outNormals,
+	std::size_t n)
+{
+	for (std::size_t i = 0u; i < n; i++)
+	{
+		DualQuaternion dq = DualQuaternion::Blend(palette, influences[i]);
+		outPositions[i] = dq.TransformPoint(positions[i]);
+		if (normals)
+		{
+			outNormals[i] = dq.TransformDirection(normals[i]);
+		}
+	}
+}
+
+};
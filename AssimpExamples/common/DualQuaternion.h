@@ -0,0 +1,143 @@
+#pragma once
+
+// Dual quaternions - a rotation and a translation packed into one 8-float object.
+// For skinning these beat matrices two ways:
+//  - Blending: averaging matrices squashes the mesh where bones twist (the "candy
+//    wrapper" look around wrists and elbows). Averaging dual quaternions and
+//    normalizing keeps everything rigid.
+//  - Size: 8 floats per bone instead of 12 for a 3x4 matrix, so about half the memory
+//    traffic once the bone palette stops fitting in cache.
+// The catch is they can't do scale. FromTransform ignores Transform::Scale entirely.
+// Kavan et al, "Skinning with Dual Quaternions" is the paper to read.
+
+#include <MathExtras.h>
+#include <Transform.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct aiMesh;
+
+namespace sess
+{
+
+// The (up to) four bones that move one vertex, and how much each one pulls on it.
+//  Unused slots have a weight of 0. Weights should add up to 1.
+struct SkinInfluences
+{
+	float Weights[4];
+	std::uint16_t Bones[4];
+};
+
+// Pulls the bone weights out of an Assimp mesh (aiMesh::mBones) into one SkinInfluences
+//  per vertex, indexed the same as aiMesh::mBones. aiProcess_LimitBoneWeights (part of the
+//  TargetRealtime presets) already caps it at four per vertex; if it wasn't used, the four
+//  strongest are kept and re-weighted to add up to 1. A vertex no bone pulls on keeps
+//  all four weights at 0, which Blend turns into the identity - it stays where it is.
+std::vector<SkinInfluences> GatherSkinInfluences(const aiMesh* mesh);
+
+struct DualQuaternion
+{
+public:
+	Quaternion Real; // The rotation
+	Quaternion Dual; // Half the translation, multiplied by the rotation (t * r / 2)
+
+public:
+	// Identity: no rotation, no translation
+	constexpr DualQuaternion() noexcept
+		: Real()
+		, Dual(Quaternion::FromComponents(0.f, 0.f, 0.f, 0.f))
+	{}
+
+	constexpr DualQuaternion(const Quaternion& real, const Quaternion& dual) noexcept
+		: Real(real)
+		, Dual(dual)
+	{}
+
+	DualQuaternion(const DualQuaternion&) = default;
+	~DualQuaternion() = default;
+
+	// Rotate by t.Rotation, then move by t.Position (scale is dropped)
+	static DualQuaternion FromTransform(const Transform& t) noexcept
+	{
+		Quaternion translation = Quaternion::FromComponents(0.f, t.Position.x, t.Position.y, t.Position.z);
+		return DualQuaternion(t.Rotation, Scaled(Multiply(translation, t.Rotation), 0.5f));
+	}
+
+	Transform ToTransform() const noexcept
+	{
+		return Transform(GetTranslation(), Real, Vec3::Ones);
+	}
+
+	Vec3 GetTranslation() const noexcept
+	{
+		Quaternion t = Multiply(Dual, Conjugate(Real));
+		return Vec3(t.x, t.y, t.z) * 2.f;
+	}
+
+	// Same order as Matrix and Transform: a * b applies b first, then a
+	DualQuaternion operator*(const DualQuaternion& o) const noexcept
+	{
+		return DualQuaternion(Multiply(Real, o.Real), Add(Multiply(Real, o.Dual), Multiply(Dual, o.Real)));
+	}
+
+	// These expect a unit dual quaternion - anything built by FromTransform or Blend is
+	Vec3 TransformPoint(const Vec3& p) const noexcept
+	{
+		return p * Real + GetTranslation();
+	}
+
+	Vec3 TransformDirection(const Vec3& d) const noexcept
+	{
+		return d * Real;
+	}
+
+	// Weighted blend of the bones in influences, normalized back into a rigid transform.
+	//  Like Nlerp, bones that are on the far side of the 4D sphere from the first one
+	//  get flipped first, otherwise two near-identical rotations could cancel out.
+	// All four weights at 0 gives the identity, not NaNs.
+	// SSE/AVX for the blend and normalize; see DualQuaternion.cc.
+	static DualQuaternion Blend(const DualQuaternion* palette, const SkinInfluences& influences);
+
+	static const DualQuaternion Identity;
+
+private:
+	// Quaternion::operator* normalizes its result, which is wrong for the dual part
+	static constexpr Quaternion Multiply(const Quaternion& a, const Quaternion& b) noexcept
+	{
+		return Quaternion::FromComponents(
+			a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z,
+			a.w * b.x + a.x * b.w + a.y * b.z - a.z * b.y,
+			a.w * b.y - a.x * b.z + a.y * b.w + a.z * b.x,
+			a.w * b.z + a.x * b.y - a.y * b.x + a.z * b.w);
+	}
+
+	static constexpr Quaternion Add(const Quaternion& a, const Quaternion& b) noexcept
+	{
+		return Quaternion::FromComponents(a.w + b.w, a.x + b.x, a.y + b.y, a.z + b.z);
+	}
+
+	static constexpr Quaternion Scaled(const Quaternion& q, float s) noexcept
+	{
+		return Quaternion::FromComponents(q.w * s, q.x * s, q.y * s, q.z * s);
+	}
+
+	static constexpr Quaternion Conjugate(const Quaternion& q) noexcept
+	{
+		return Quaternion::FromComponents(q.w, -q.x, -q.y, -q.z);
+	}
+};
+
+inline constexpr DualQuaternion DualQuaternion::Identity = DualQuaternion();
+
+// Dual quaternion skinning: for each vertex, blend its bones out of the palette and
+//  move the position and normal by the result. normals/outNormals can be null to only
+//  skin positions. Outputs may be the same arrays as the inputs.
+void SkinVertices(
+	const DualQuaternion* palette, const SkinInfluences* influences,
+	const Vec3* positions, const Vec3* normals,
+	Vec3* outPositions, Vec3* outNormals,
+	std::size_t n);
+
+};
@@ -0,0 +1,255 @@
+#include <Frustum.h>
+#include <Simd.h>
+
+namespace sess
+{
+
+namespace
+{
+
+// Normalizing the plane makes Dot(Normal, p) + D an actual distance, which is what
+//  lets it be compared against a sphere radius
+Plane MakePlane(float a, float b, float c, float d)
+{
+	float invLength = 1.f / Vec3(a, b, c).Magnitude();
+	return Plane{ Vec3(a, b, c) * invLength, d * invLength };
+}
+
+// The sphere and box tests, written once against a small set of operations so the same
+//  code runs on one bound at a time (float), four (SSE) or eight (AVX). Same idea as
+//  ComputeRows in TransformSoA.cc.
+// Each returns one bit per bound, set if the bound is (at least partly) inside.
+template <typename Ops>
+inline std::uint32_t TestSpheres(const Plane (&planes)[Frustum::PlaneCount], const BoundingSphere* spheres)
+{
+	using V = typename Ops::V;
+
+	V cx, cy, cz, r;
+	Ops::LoadSpheres(spheres, cx, cy, cz, r);
+
+	V zero = Ops::Set1(0.f);
+	V outside = Ops::False();
+	for (const Plane& plane : planes)
+	{
+		// Outside if the center is further than one radius behind the plane
+		V d = Ops::Mul(Ops::Set1(plane.Normal.x), cx);
+		d = Ops::Add(d, Ops::Mul(Ops::Set1(plane.Normal.y), cy));
+		d = Ops::Add(d, Ops::Mul(Ops::Set1(plane.Normal.z), cz));
+		d = Ops::Add(d, Ops::Set1(plane.D));
+		outside = Ops::Or(outside, Ops::Less(Ops::Add(d, r), zero));
+	}
+
+	return ~Ops::MoveMask(outside) & Ops::ALL_BITS;
+}
+
+template <typename Ops>
+inline std::uint32_t TestBoxes(const Plane (&planes)[Frustum::PlaneCount], const AABB* boxes)
+{
+	using V = typename Ops::V;
+	const std::size_t STRIDE = sizeof(AABB) / sizeof(float);
+
+	V half = Ops::Set1(0.5f);
+	V minX = Ops::Gather(&boxes->Min.x, STRIDE), maxX = Ops::Gather(&boxes->Max.x, STRIDE);
+	V minY = Ops::Gather(&boxes->Min.y, STRIDE), maxY = Ops::Gather(&boxes->Max.y, STRIDE);
+	V minZ = Ops::Gather(&boxes->Min.z, STRIDE), maxZ = Ops::Gather(&boxes->Max.z, STRIDE);
+	V cx = Ops::Mul(Ops::Add(minX, maxX), half), ex = Ops::Mul(Ops::Sub(maxX, minX), half);
+	V cy = Ops::Mul(Ops::Add(minY, maxY), half), ey = Ops::Mul(Ops::Sub(maxY, minY), half);
+	V cz = Ops::Mul(Ops::Add(minZ, maxZ), half), ez = Ops::Mul(Ops::Sub(maxZ, minZ), half);
+
+	V zero = Ops::Set1(0.f);
+	V outside = Ops::False();
+	for (const Plane& plane : planes)
+	{
+		// Distance from the center, plus how far the box reaches towards the plane.
+		//  If even the corner closest to the inside is behind the plane, it's all outside.
+		V d = Ops::Mul(Ops::Set1(plane.Normal.x), cx);
+		d = Ops::Add(d, Ops::Mul(Ops::Set1(plane.Normal.y), cy));
+		d = Ops::Add(d, Ops::Mul(Ops::Set1(plane.Normal.z), cz));
+		d = Ops::Add(d, Ops::Set1(plane.D));
+
+		V reach = Ops::Mul(Ops::Set1(fabsf(plane.Normal.x)), ex);
+		reach = Ops::Add(reach, Ops::Mul(Ops::Set1(fabsf(plane.Normal.y)), ey));
+		reach = Ops::Add(reach, Ops::Mul(Ops::Set1(fabsf(plane.Normal.z)), ez));
+
+		outside = Ops::Or(outside, Ops::Less(Ops::Add(d, reach), zero));
+	}
+
+	return ~Ops::MoveMask(outside) & Ops::ALL_BITS;
+}
+
+static_assert(sizeof(BoundingSphere) == 4u * sizeof(float), "Sphere loads expect exactly x, y, z, radius");
+static_assert(sizeof(AABB) == 6u * sizeof(float), "Box loads expect exactly min xyz, max xyz");
+
+struct ScalarOps
+{
+	using V = float;
+	static const std::uint32_t WIDTH = 1u;
+	static const std::uint32_t ALL_BITS = 0x1u;
+	static V Set1(float f) { return f; }
+	static V False() { return 0.f; }
+	static V Gather(const float* p, std::size_t) { return *p; }
+	static void LoadSpheres(const BoundingSphere* s, V& x, V& y, V& z, V& r)
+	{
+		x = s->Center.x;
+		y = s->Center.y;
+		z = s->Center.z;
+		r = s->Radius;
+	}
+	static V Add(V a, V b) { return a + b; }
+	static V Sub(V a, V b) { return a - b; }
+	static V Mul(V a, V b) { return a * b; }
+	static V Less(V a, V b) { return a < b ? 1.f : 0.f; }
+	static V Or(V a, V b) { return (a != 0.f || b != 0.f) ? 1.f : 0.f; }
+	static std::uint32_t MoveMask(V a) { return a != 0.f ? 1u : 0u; }
+};
+
+#if defined(SESS_SSE)
+struct SSEOps
+{
+	using V = __m128;
+	static const std::uint32_t WIDTH = 4u;
+	static const std::uint32_t ALL_BITS = 0xFu;
+	static V Set1(float f) { return _mm_set1_ps(f); }
+	static V False() { return _mm_setzero_ps(); }
+	static V Gather(const float* p, std::size_t stride) { return _mm_setr_ps(p[0], p[stride], p[2 * stride], p[3 * stride]); }
+	// Each sphere is exactly one register, so this is the usual 4x4 transpose
+	static void LoadSpheres(const BoundingSphere* s, V& x, V& y, V& z, V& r)
+	{
+		x = _mm_loadu_ps(&s[0].Center.x);
+		y = _mm_loadu_ps(&s[1].Center.x);
+		z = _mm_loadu_ps(&s[2].Center.x);
+		r = _mm_loadu_ps(&s[3].Center.x);
+		_MM_TRANSPOSE4_PS(x, y, z, r);
+	}
+	static V Add(V a, V b) { return _mm_add_ps(a, b); }
+	static V Sub(V a, V b) { return _mm_sub_ps(a, b); }
+	static V Mul(V a, V b) { return _mm_mul_ps(a, b); }
+	static V Less(V a, V b) { return _mm_cmplt_ps(a, b); }
+	static V Or(V a, V b) { return _mm_or_ps(a, b); }
+	static std::uint32_t MoveMask(V a) { return (std::uint32_t)_mm_movemask_ps(a); }
+};
+#endif
+
+#if defined(SESS_AVX)
+struct AVXOps
+{
+	using V = __m256;
+	static const std::uint32_t WIDTH = 8u;
+	static const std::uint32_t ALL_BITS = 0xFFu;
+	static V Set1(float f) { return _mm256_set1_ps(f); }
+	static V False() { return _mm256_setzero_ps(); }
+	static V Gather(const float* p, std::size_t stride)
+	{
+		return _mm256_setr_ps(p[0], p[stride], p[2 * stride], p[3 * stride], p[4 * stride], p[5 * stride], p[6 * stride], p[7 * stride]);
+	}
+	// Spheres 0-3 go in the low halves of the registers and 4-7 in the high halves, then
+	//  both halves get the SSE-style 4x4 transpose at the same time (AVX shuffles never
+	//  cross between the halves)
+	static void LoadSpheres(const BoundingSphere* s, V& x, V& y, V& z, V& r)
+	{
+		V r0 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(&s[0].Center.x)), _mm_loadu_ps(&s[4].Center.x), 1);
+		V r1 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(&s[1].Center.x)), _mm_loadu_ps(&s[5].Center.x), 1);
+		V r2 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(&s[2].Center.x)), _mm_loadu_ps(&s[6].Center.x), 1);
+		V r3 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(&s[3].Center.x)), _mm_loadu_ps(&s[7].Center.x), 1);
+
+		V t0 = _mm256_unpacklo_ps(r0, r1);
+		V t1 = _mm256_unpacklo_ps(r2, r3);
+		V t2 = _mm256_unpackhi_ps(r0, r1);
+		V t3 = _mm256_unpackhi_ps(r2, r3);
+
+		x = _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(1, 0, 1, 0));
+		y = _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(3, 2, 3, 2));
+		z = _mm256_shuffle_ps(t2, t3, _MM_SHUFFLE(1, 0, 1, 0));
+		r = _mm256_shuffle_ps(t2, t3, _MM_SHUFFLE(3, 2, 3, 2));
+	}
+	static V Add(V a, V b) { return _mm256_add_ps(a, b); }
+	static V Sub(V a, V b) { return _mm256_sub_ps(a, b); }
+	static V Mul(V a, V b) { return _mm256_mul_ps(a, b); }
+	static V Less(V a, V b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+	static V Or(V a, V b) { return _mm256_or_ps(a, b); }
+	static std::uint32_t MoveMask(V a) { return (std::uint32_t)_mm256_movemask_ps(a); }
+};
+#endif
+
+template <typename Ops>
+struct SphereTest
+{
+	static std::uint32_t Run(const Plane (&planes)[Frustum::PlaneCount], const BoundingSphere* s) { return TestSpheres<Ops>(planes, s); }
+};
+
+template <typename Ops>
+struct BoxTest
+{
+	static std::uint32_t Run(const Plane (&planes)[Frustum::PlaneCount], const AABB* b) { return TestBoxes<Ops>(planes, b); }
+};
+
+// Tests whole batches of Ops::WIDTH bounds starting at i, returns where it stopped
+template <template <typename> class Test, typename Ops, typename Bound>
+inline std::size_t CullBatches(const Plane (&planes)[Frustum::PlaneCount], const Bound* bounds, std::size_t i, std::size_t n, VisibilitySet& out)
+{
+	for (; i + Ops::WIDTH <= n; i += Ops::WIDTH)
+	{
+		out.SetBits(i, Test<Ops>::Run(planes, bounds + i));
+	}
+	return i;
+}
+
+// Widest batches first, then narrower ones for whatever is left over. Batches always
+//  start on a multiple of their width, so their bits never straddle two bitset words.
+template <template <typename> class Test, typename Bound>
+void Cull(const Plane (&planes)[Frustum::PlaneCount], const Bound* bounds, std::size_t n, VisibilitySet& out)
+{
+	out.Reset(n);
+
+	std::size_t i = 0u;
+#if defined(SESS_AVX)
+	i = CullBatches<Test, AVXOps>(planes, bounds, i, n, out);
+#endif
+#if defined(SESS_SSE)
+	i = CullBatches<Test, SSEOps>(planes, bounds, i, n, out);
+#endif
+	CullBatches<Test, ScalarOps>(planes, bounds, i, n, out);
+}
+
+};
+
+Frustum::Frustum()
+	: planes_()
+{}
+
+Frustum::Frustum(const Matrix& viewProj)
+{
+	// With row vectors, clip = (x, y, z, 1) * viewProj - so each clip space coordinate is
+	//  the dot product of the point with one *column* of the matrix. A point is on screen
+	//  if -w <= x <= w, -w <= y <= w and 0 <= z <= w (D3D depth goes 0 to 1, not -1 to 1),
+	//  and each of those six inequalities is one plane.
+	const Matrix& m = viewProj;
+	planes_[Left] = MakePlane(m._14 + m._11, m._24 + m._21, m._34 + m._31, m._44 + m._41);
+	planes_[Right] = MakePlane(m._14 - m._11, m._24 - m._21, m._34 - m._31, m._44 - m._41);
+	planes_[Bottom] = MakePlane(m._14 + m._12, m._24 + m._22, m._34 + m._32, m._44 + m._42);
+	planes_[Top] = MakePlane(m._14 - m._12, m._24 - m._22, m._34 - m._32, m._44 - m._42);
+	planes_[Near] = MakePlane(m._13, m._23, m._33, m._43);
+	planes_[Far] = MakePlane(m._14 - m._13, m._24 - m._23, m._34 - m._33, m._44 - m._43);
+}
+
+bool Frustum::Intersects(const BoundingSphere& sphere) const
+{
+	return TestSpheres<ScalarOps>(planes_, &sphere) != 0u;
+}
+
+bool Frustum::Intersects(const AABB& box) const
+{
+	return TestBoxes<ScalarOps>(planes_, &box) != 0u;
+}
+
+void Frustum::CullSpheres(const BoundingSphere* spheres, std::size_t n, VisibilitySet& out) const
+{
+	Cull<SphereTest>(planes_, spheres, n, out);
+}
+
+void Frustum::CullBoxes(const AABB* boxes, std::size_t n, VisibilitySet& out) const
+{
+	Cull<BoxTest>(planes_, boxes, n, out);
+}
+
+};
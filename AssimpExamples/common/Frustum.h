@@ -0,0 +1,54 @@
+#pragma once
+
+// View frustum - the chopped off pyramid of space the camera can actually see.
+//  Described by six planes (left, right, bottom, top, near, far), each facing inwards.
+//  Anything entirely on the wrong side of any one plane is off screen.
+// The planes come straight out of the combined view * projection matrix (the trick from
+//  Gribb and Hartmann's "Fast Extraction of Viewing Frustum Planes"), so this works with
+//  whatever LookAtLH and PerspectiveLH produce without caring about field of view etc.
+// The tests are conservative: something that's off screen but near a corner of the
+//  frustum can still come back as visible. Never the other way around though.
+
+#include <Bounds.h>
+#include <VisibilitySet.h>
+
+#include <cstddef>
+
+namespace sess
+{
+
+// Points p with Vec3::Dot(Normal, p) + D >= 0 are on the inside
+struct Plane
+{
+	Vec3 Normal;
+	float D;
+};
+
+class Frustum
+{
+public:
+	enum PlaneId { Left = 0, Right, Bottom, Top, Near, Far, PlaneCount };
+
+public:
+	// Everything passes against a default frustum - all the planes are degenerate
+	Frustum();
+	// viewProj is view * projection, row vector convention (as LookAtLH * PerspectiveLH)
+	explicit Frustum(const Matrix& viewProj);
+	Frustum(const Frustum&) = default;
+	~Frustum() = default;
+
+	const Plane& GetPlane(PlaneId id) const { return planes_[id]; }
+
+	bool Intersects(const BoundingSphere& sphere) const;
+	bool Intersects(const AABB& box) const;
+
+	// Tests a whole array of bounds, writing one bit per bound into out (which is resized
+	//  to n). Eight bounds at a time with AVX, four with SSE.
+	void CullSpheres(const BoundingSphere* spheres, std::size_t n, VisibilitySet& out) const;
+	void CullBoxes(const AABB* boxes, std::size_t n, VisibilitySet& out) const;
+
+private:
+	Plane planes_[PlaneCount];
+};
+
+};
@@ -0,0 +1,204 @@
+#include <ImportProfile.h>
+#include <IndexFormat.h>
+
+#include <assimp/Importer.hpp>
+#include <assimp/config.h>
+#include <assimp/mesh.h>
+#include <assimp/postprocess.h>
+#include <assimp/scene.h>
+
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+namespace sess
+{
+
+namespace
+{
+
+struct PostProcessStep
+{
+	unsigned int Flag;
+	const char* Name;
+};
+
+// Every step, in the same order Assimp runs them in when they're all asked for at once -
+//  running them one at a time in this order gives the same mesh
+const PostProcessStep POST_PROCESS_STEPS[] =
+{
+	{ aiProcess_ValidateDataStructure, "ValidateDataStructure" },
+	{ aiProcess_MakeLeftHanded, "MakeLeftHanded" },
+	{ aiProcess_FlipUVs, "FlipUVs" },
+	{ aiProcess_FlipWindingOrder, "FlipWindingOrder" },
+	{ aiProcess_RemoveComponent, "RemoveComponent" },
+	{ aiProcess_RemoveRedundantMaterials, "RemoveRedundantMaterials" },
+	{ aiProcess_FindInstances, "FindInstances" },
+	{ aiProcess_OptimizeGraph, "OptimizeGraph" },
+	{ aiProcess_OptimizeMeshes, "OptimizeMeshes" },
+	{ aiProcess_FindDegenerates, "FindDegenerates" },
+	{ aiProcess_GenUVCoords, "GenUVCoords" },
+	{ aiProcess_TransformUVCoords, "TransformUVCoords" },
+	{ aiProcess_PreTransformVertices, "PreTransformVertices" },
+	{ aiProcess_Triangulate, "Triangulate" },
+	{ aiProcess_SortByPType, "SortByPType" },
+	{ aiProcess_FindInvalidData, "FindInvalidData" },
+	{ aiProcess_FixInfacingNormals, "FixInfacingNormals" },
+	{ aiProcess_SplitByBoneCount, "SplitByBoneCount" },
+	{ aiProcess_GenNormals, "GenNormals" },
+	{ aiProcess_GenSmoothNormals, "GenSmoothNormals" },
+	{ aiProcess_CalcTangentSpace, "CalcTangentSpace" },
+	{ aiProcess_JoinIdenticalVertices, "JoinIdenticalVertices" },
+	// Assimp splits by triangle count earlier than this, but by vertex count only after
+	//  the vertices are joined - the vertex half is the one that matters for 16-bit indices
+	{ aiProcess_SplitLargeMeshes, "SplitLargeMeshes" },
+	{ aiProcess_Debone, "Debone" },
+	{ aiProcess_LimitBoneWeights, "LimitBoneWeights" },
+	{ aiProcess_ImproveCacheLocality, "ImproveCacheLocality" },
+};
+
+float MsSince(std::chrono::high_resolution_clock::time_point start)
+{
+	return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now() - start).count() / 1000.f;
+}
+
+};
+
+// Triangulate + SortByPType is the minimum - the demos' vertex conversion only handles
+//  triangles, and SortByPType is what gets the lines and points out (see ApplyProperties).
+//  SplitLargeMeshes costs nothing unless a mesh is too big for 16-bit indices.
+const ImportProfile ImportProfile::FastPreview =
+{
+	"fast-preview",
+	aiProcess_Triangulate | aiProcess_SortByPType | aiProcess_GenNormals | aiProcess_SplitLargeMeshes,
+	false,
+	0.f,
+	0u,
+	{},
+	false,
+	false,
+};
+
+// TargetRealtime_Quality without the tangents, which none of the vertex formats have
+const ImportProfile ImportProfile::RuntimeQuality =
+{
+	"runtime-quality",
+	aiProcess_GenSmoothNormals
+		| aiProcess_JoinIdenticalVertices
+		| aiProcess_ImproveCacheLocality
+		| aiProcess_LimitBoneWeights
+		| aiProcess_RemoveRedundantMaterials
+		| aiProcess_SplitLargeMeshes
+		| aiProcess_Triangulate
+		| aiProcess_GenUVCoords
+		| aiProcess_SortByPType
+		| aiProcess_FindDegenerates
+		| aiProcess_FindInvalidData,
+	true,
+	1.05f,
+	0u,
+	{},
+	false,
+	false,
+};
+
+const ImportProfile ImportProfile::OfflineMax =
+{
+	"offline-max",
+	aiProcessPreset_TargetRealtime_MaxQuality,
+	true,
+	1.05f,
+	0u,
+	{},
+	false,
+	false,
+};
+
+ImportProfile ImportProfile::WithStepTiming() const
+{
+	ImportProfile timed = *this;
+	timed.TimeSteps = true;
+	return timed;
+}
+
+ImportProfile ImportProfile::WithMeshStats() const
+{
+	ImportProfile reported = *this;
+	reported.MeshStats = true;
+	return reported;
+}
+
+ImportProfile ImportProfile::WithLods(std::initializer_list<float> ratios) const
+{
+	ImportProfile withLods = *this;
+	withLods.LodCount = 0u;
+	for (float ratio : ratios)
+	{
+		if (withLods.LodCount < MAX_LODS - 1u)
+		{
+			withLods.LodRatios[withLods.LodCount++] = ratio;
+		}
+	}
+	return withLods;
+}
+
+void ImportProfile::ApplyProperties(Assimp::Importer& importer) const
+{
+	// Lines and points can't go through the triangle-only vertex conversion, so they get
+	//  dropped outright instead of coming out as meshes of their own
+	importer.SetPropertyInteger(AI_CONFIG_PP_SBP_REMOVE, aiPrimitiveType_POINT | aiPrimitiveType_LINE);
+	importer.SetPropertyBool(AI_CONFIG_PP_FD_REMOVE, RemoveDegenerates);
+
+	// Meshes too big for 16-bit indices get split into ones that aren't (see IndexFormat.h).
+	//  Assimp's default limit is a million vertices.
+	importer.SetPropertyInteger(AI_CONFIG_PP_SLM_VERTEX_LIMIT, MAX_16BIT_INDEX_VERTICES);
+}
+
+const aiScene* ImportProfile::Import(Assimp::Importer& importer, const AssetData& source, const char* fName) const
+{
+	ApplyProperties(importer);
+
+	// The extension tells Assimp which importer to use
+	const char* extension = strrchr(fName, '.');
+	const char* hint = (extension != nullptr) ? extension + 1 : "";
+
+	if (!TimeSteps)
+	{
+		return importer.ReadFileFromMemory(source.GetData(), source.GetSize(), Flags, hint);
+	}
+
+	// Built up and printed in one go, so models loading on other threads can't end up in
+	//  the middle of it
+	std::ostringstream report;
+	report << std::fixed << std::setprecision(2);
+	report << "Importing " << fName << " (" << Name << "), one step at a time:" << std::endl;
+
+	auto importStart = std::chrono::high_resolution_clock::now();
+	const aiScene* scene = importer.ReadFileFromMemory(source.GetData(), source.GetSize(), 0u, hint);
+	report << "  " << std::setw(26) << std::left << "(read file)" << std::setw(9) << std::right << MsSince(importStart) << "ms" << std::endl;
+
+	for (auto&& step : POST_PROCESS_STEPS)
+	{
+		if (scene == nullptr)
+		{
+			break;
+		}
+		if ((Flags & step.Flag) == 0u)
+		{
+			continue;
+		}
+
+		auto stepStart = std::chrono::high_resolution_clock::now();
+		scene = importer.ApplyPostProcessing(step.Flag);
+		report << "  " << std::setw(26) << std::left << step.Name << std::setw(9) << std::right << MsSince(stepStart) << "ms" << std::endl;
+	}
+
+	report << "  " << std::setw(26) << std::left << "total" << std::setw(9) << std::right << MsSince(importStart) << "ms" << std::endl;
+	std::cout << report.str();
+
+	return scene;
+}
+
+};
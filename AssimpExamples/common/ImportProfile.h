@@ -0,0 +1,82 @@
+#pragma once
+
+// Import profiles - which of Assimp's post-processing steps a model gets run through, and
+//  how those steps are configured.
+// aiProcessPreset_TargetRealtime_MaxQuality does everything, which is great for the mesh
+//  and terrible for load times: finding instances, merging meshes and validating every
+//  data structure all take time, and most models don't need any of it. A profile makes
+//  that trade explicit - pick one per LoadFromFile call.
+//
+//  FastPreview      Just enough to draw the thing: triangles and flat normals, no
+//                   overdraw ordering
+//  RuntimeQuality   Smooth normals, shared vertices, vertex cache ordering, cleanup,
+//                   overdraw ordering
+//  OfflineMax       Everything in TargetRealtime_MaxQuality - what the demos always used -
+//                   and overdraw ordering
+//
+// Not sure which steps are worth it for a model? Import it with WithStepTiming() and
+//  the post-processing runs one step at a time, with the cost of each printed out.
+// Drawing a model far away a lot? WithLods() adds simplified versions of every mesh.
+//
+// Wondering what our own passes (see ModelLoader.h) did to the meshes? WithMeshStats()
+//  prints vertex cache and overdraw numbers for every mesh, before and after.
+
+#include <AssetPack.h>
+
+#include <cstdint>
+#include <initializer_list>
+
+struct aiScene;
+namespace Assimp
+{
+class Importer;
+};
+
+namespace sess
+{
+
+// Most LODs a mesh can have, full detail included
+constexpr std::uint32_t MAX_LODS = 4u;
+
+struct ImportProfile
+{
+	const char* Name;
+	unsigned int Flags; // aiProcess_* steps
+	bool RemoveDegenerates; // aiProcess_FindDegenerates drops degenerate faces, instead of turning them into lines and points
+
+	// How much worse ModelLoader's overdraw pass may make the vertex cache (1.05 = 5% more
+	//  cache misses) to get the triangles that hide others drawn first. 0 skips the pass.
+	float OverdrawThreshold;
+
+	// Simplified versions of every mesh to make (see MeshSimplifier.h), as fractions of the
+	//  full detail triangle count - the first LodCount of LodRatios are used
+	std::uint32_t LodCount;
+	float LodRatios[MAX_LODS - 1u];
+
+	// Run post-processing one step at a time and print how long each one took. The mesh
+	//  comes out the same, it's just slower overall.
+	bool TimeSteps;
+
+	// Print what ModelLoader's optimization passes did to each mesh (see MeshOptimizer.h)
+	bool MeshStats;
+
+	ImportProfile WithStepTiming() const;
+	ImportProfile WithMeshStats() const;
+
+	// Same profile, plus a LOD chain - WithLods({ 0.5f, 0.25f, 0.1f }) makes one with half
+	//  the triangles, one with a quarter and one with a tenth. Past MAX_LODS - 1 are ignored.
+	ImportProfile WithLods(std::initializer_list<float> ratios) const;
+
+	// Puts the profile's settings into the importer's property store
+	void ApplyProperties(Assimp::Importer& importer) const;
+
+	// Reads a model out of memory (fName is only used to tell Assimp what format it is)
+	//  and post-processes it. The scene belongs to importer - null if the import failed.
+	const aiScene* Import(Assimp::Importer& importer, const AssetData& source, const char* fName) const;
+
+	static const ImportProfile FastPreview;
+	static const ImportProfile RuntimeQuality;
+	static const ImportProfile OfflineMax;
+};
+
+};
@@ -0,0 +1,37 @@
+#pragma once
+
+// 16-bit index buffers - half the memory and half the bandwidth of 32-bit ones, and a
+//  16-bit index can still pick any of 65536 vertices. Pretty much every real mesh fits,
+//  and the ones that don't get split up by Assimp on import until they do (every
+//  ImportProfile turns on aiProcess_SplitLargeMeshes with this as the limit).
+// Everything on the CPU side (cooking, the mesh cache, the optimizer passes) stays 32-bit,
+//  so there's only one kind of index to deal with there - indices only get narrowed on
+//  their way into a GPU buffer.
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace sess
+{
+
+// Most vertices a mesh can have and still be drawn with 16-bit indices
+constexpr std::uint32_t MAX_16BIT_INDEX_VERTICES = 0x10000u;
+
+inline bool FitsShortIndices(std::size_t vertexCount)
+{
+	return vertexCount <= MAX_16BIT_INDEX_VERTICES;
+}
+
+// Copies indices into out at 16 bits each. Only for meshes where FitsShortIndices is true -
+//  anything bigger wouldn't survive the trip.
+inline void NarrowIndices(const std::vector<std::uint32_t>& indices, std::vector<std::uint16_t>& out)
+{
+	out.resize(indices.size());
+	for (std::size_t i = 0u; i < indices.size(); i++)
+	{
+		out[i] = static_cast<std::uint16_t>(indices[i]);
+	}
+}
+
+};
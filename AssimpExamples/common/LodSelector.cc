@@ -0,0 +1,59 @@
+#include <LodSelector.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace sess
+{
+
+namespace
+{
+// Closer than this (or inside the sphere), everything gets full detail
+constexpr float MIN_LOD_DISTANCE = 1e-3f;
+}
+
+LodSelector::LodSelector(float maxPixelError)
+	: errors_(1u, 0.f)
+	, maxPixelError_(maxPixelError)
+	, level_(0u)
+{}
+
+void LodSelector::SetLevelErrors(std::vector<float> errors)
+{
+	if (errors.empty())
+	{
+		errors.push_back(0.f);
+	}
+	for (std::size_t lodIdx = 1u; lodIdx < errors.size(); lodIdx++)
+	{
+		errors[lodIdx] = std::max(errors[lodIdx], errors[lodIdx - 1u]);
+	}
+	errors_ = std::move(errors);
+	level_ = std::min(level_, GetLevelCount() - 1u);
+}
+
+float LodSelector::PixelsPerUnit(float fovY, float viewportHeight)
+{
+	// The whole viewport height covers 2 * tan(fovY / 2) units at a distance of 1
+	return viewportHeight / (2.f * tanf(fovY * 0.5f));
+}
+
+std::uint32_t LodSelector::Select(const BoundingSphere& worldSphere, float worldScale, const Vec3& cameraPosition, float pixelsPerUnit)
+{
+	float distance = std::max((worldSphere.Center - cameraPosition).Magnitude() - worldSphere.Radius, MIN_LOD_DISTANCE);
+	float toPixels = worldScale * pixelsPerUnit / distance;
+
+	// Finer until it looks right...
+	while (level_ > 0u && errors_[level_] * toPixels > maxPixelError_)
+	{
+		level_--;
+	}
+	// ...and coarser only while it clearly still would
+	while (level_ + 1u < GetLevelCount() && errors_[level_ + 1u] * toPixels <= maxPixelError_ * (1.f - LOD_HYSTERESIS))
+	{
+		level_++;
+	}
+	return level_;
+}
+
+};
@@ -0,0 +1,51 @@
+#pragma once
+
+// Picks which LOD of a model to draw, by how big its simplification error would look on
+//  screen. A LOD whose error is a fraction of a pixel looks exactly the same as full
+//  detail, so there's no point drawing more triangles than that.
+// Errors are in the model's own units (see MeshSimplifier.h), and get scaled to world
+//  units and then to pixels at the distance of the closest point of the bounding sphere.
+//
+// Hysteresis: switching LOD right at the threshold would flicker back and forth as the
+//  camera moves by a hair. Going to a finer LOD happens as soon as the current one looks
+//  too rough, but going coarser has to get a good bit under the threshold first.
+
+#include <Bounds.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace sess
+{
+
+// How far under the threshold the next coarser LOD has to be before switching to it
+constexpr float LOD_HYSTERESIS = 0.25f;
+
+class LodSelector
+{
+public:
+	explicit LodSelector(float maxPixelError = 1.f);
+	LodSelector(const LodSelector&) = default;
+	~LodSelector() = default;
+
+	// One error per LOD, full detail first. Coarser LODs never count as more accurate than
+	//  finer ones, even if the numbers say so.
+	void SetLevelErrors(std::vector<float> errors);
+
+	// Pixels one world unit covers at a distance of one world unit, straight ahead
+	static float PixelsPerUnit(float fovY, float viewportHeight);
+
+	// worldScale is the largest scale of the model's transform, worldSphere its bounds
+	//  already in world space
+	std::uint32_t Select(const BoundingSphere& worldSphere, float worldScale, const Vec3& cameraPosition, float pixelsPerUnit);
+
+	std::uint32_t GetLevel() const { return level_; }
+	std::uint32_t GetLevelCount() const { return static_cast<std::uint32_t>(errors_.size()); }
+
+private:
+	std::vector<float> errors_;
+	float maxPixelError_;
+	std::uint32_t level_;
+};
+
+};
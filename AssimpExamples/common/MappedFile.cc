@@ -0,0 +1,183 @@
+#include <MappedFile.h>
+
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace sess
+{
+
+MappedFile::MappedFile()
+	: data_(nullptr)
+	, size_(0u)
+	, isOpen_(false)
+#if defined(_WIN32)
+	, fileHandle_(INVALID_HANDLE_VALUE)
+	, mappingHandle_(nullptr)
+#endif
+{}
+
+MappedFile::~MappedFile()
+{
+	Close();
+}
+
+#if defined(_WIN32)
+
+bool MappedFile::Open(const char* fName, Access access)
+{
+	Close();
+
+	DWORD flags = (access == Access::Sequential) ? FILE_FLAG_SEQUENTIAL_SCAN : FILE_FLAG_RANDOM_ACCESS;
+	HANDLE file = CreateFileA(fName, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | flags, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size))
+	{
+		CloseHandle(file);
+		return false;
+	}
+
+	fileHandle_ = file;
+	size_ = static_cast<std::size_t>(size.QuadPart);
+	isOpen_ = true;
+
+	// Windows refuses to map an empty file, but there's nothing to read anyways
+	if (size_ == 0u)
+	{
+		return true;
+	}
+
+	mappingHandle_ = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (mappingHandle_ == nullptr)
+	{
+		Close();
+		return false;
+	}
+
+	data_ = static_cast<const std::uint8_t*>(MapViewOfFile(mappingHandle_, FILE_MAP_READ, 0, 0, 0));
+	if (data_ == nullptr)
+	{
+		Close();
+		return false;
+	}
+
+	return true;
+}
+
+void MappedFile::Close()
+{
+	if (data_ != nullptr)
+	{
+		UnmapViewOfFile(data_);
+	}
+	if (mappingHandle_ != nullptr)
+	{
+		CloseHandle(mappingHandle_);
+	}
+	if (fileHandle_ != INVALID_HANDLE_VALUE)
+	{
+		CloseHandle(fileHandle_);
+	}
+
+	data_ = nullptr;
+	size_ = 0u;
+	isOpen_ = false;
+	mappingHandle_ = nullptr;
+	fileHandle_ = INVALID_HANDLE_VALUE;
+}
+
+#else
+
+bool MappedFile::Open(const char* fName, Access access)
+{
+	Close();
+
+	int fd = open(fName, O_RDONLY);
+	if (fd < 0)
+	{
+		return false;
+	}
+
+	struct stat info;
+	if (fstat(fd, &info) != 0)
+	{
+		close(fd);
+		return false;
+	}
+	size_ = static_cast<std::size_t>(info.st_size);
+	isOpen_ = true;
+
+	if (size_ > 0u)
+	{
+		void* mapping = mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+		if (mapping == MAP_FAILED)
+		{
+			close(fd);
+			size_ = 0u;
+			isOpen_ = false;
+			return false;
+		}
+
+		// Sequential: read ahead aggressively, and start reading the whole thing in now
+		//  instead of waiting for the first page fault
+		if (access == Access::Sequential)
+		{
+			madvise(mapping, size_, MADV_SEQUENTIAL);
+			madvise(mapping, size_, MADV_WILLNEED);
+		}
+		else
+		{
+			madvise(mapping, size_, MADV_RANDOM);
+		}
+
+		data_ = static_cast<const std::uint8_t*>(mapping);
+	}
+
+	// The mapping keeps the file alive by itself
+	close(fd);
+	return true;
+}
+
+void MappedFile::Close()
+{
+	if (data_ != nullptr)
+	{
+		munmap(const_cast<std::uint8_t*>(data_), size_);
+	}
+
+	data_ = nullptr;
+	size_ = 0u;
+	isOpen_ = false;
+}
+
+#endif
+
+bool MappedFile::IsOpen() const
+{
+	return isOpen_;
+}
+
+const std::uint8_t* MappedFile::GetData() const
+{
+	return data_;
+}
+
+std::size_t MappedFile::GetSize() const
+{
+	return size_;
+}
+
+};
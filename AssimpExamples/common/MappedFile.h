@@ -0,0 +1,54 @@
+#pragma once
+
+// Read-only memory mapped file. Instead of copying a file into a buffer with fread/ifstream,
+//  the OS makes the file itself show up in memory and pages it in as it gets touched.
+//  - No copy: reading a byte of the mapping reads the OS's cached copy of the file directly
+//  - No syscall per read: after the one map call, it's all just memory accesses
+//  - Shared: every process that maps the same file uses the same physical pages, so running
+//    the 02 and 03 demos side by side doesn't keep two copies of road.fbx around
+// Windows uses CreateFileMapping/MapViewOfFile, everything else mmap.
+
+#include <cstddef>
+#include <cstdint>
+
+namespace sess
+{
+
+class MappedFile
+{
+public:
+	// How the file is going to be read - passed on to the OS as a hint (madvise on POSIX,
+	//  FILE_FLAG_SEQUENTIAL_SCAN on Windows) so it can read ahead the right amount
+	enum class Access
+	{
+		Sequential, // Front to back, once
+		Random,
+	};
+
+public:
+	MappedFile();
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+	~MappedFile();
+
+	// False if the file doesn't exist or can't be mapped. An empty file opens fine, with
+	//  GetData() returning null.
+	bool Open(const char* fName, Access access);
+	void Close();
+
+	bool IsOpen() const;
+	const std::uint8_t* GetData() const;
+	std::size_t GetSize() const;
+
+private:
+	const std::uint8_t* data_;
+	std::size_t size_;
+	bool isOpen_;
+
+#if defined(_WIN32)
+	void* fileHandle_;
+	void* mappingHandle_;
+#endif
+};
+
+};
@@ -1,67 +1,337 @@
 #include <Matrix.h>
-#include <cstdint>
-#include <memory>
+#include <Affine3x4.h>
+#include <Simd.h>
 
 namespace sess
 {
 
-const Matrix Matrix::Identity = { 1.f, 0.f, 0.f, 0.f,  0.f, 1.f, 0.f, 0.f,  0.f, 0.f, 1.f, 0.f,  0.f, 0.f, 0.f, 1.f };
+namespace
+{
+
+// The actual multiply. Each row of the result is a linear combination of the rows
+//  of b, weighted by the matching row of a:
+//  r[i] = a[i][0] * b[0] + a[i][1] * b[1] + a[i][2] * b[2] + a[i][3] * b[3]
+// Added up left to right in every path so all of them agree with each other.
+inline void Multiply(const Matrix& a, const Matrix& b, Matrix& r)
+{
+#if defined(SESS_SSE)
+	__m128 b0 = _mm_load_ps(b.m[0]);
+	__m128 b1 = _mm_load_ps(b.m[1]);
+	__m128 b2 = _mm_load_ps(b.m[2]);
+	__m128 b3 = _mm_load_ps(b.m[3]);
+
+	// Results go into registers first, in case r is the same matrix as a or b
+	__m128 rows[4];
+	for (int row = 0; row < 4; row++)
+	{
+		__m128 ar = _mm_load_ps(a.m[row]);
+		__m128 acc = _mm_mul_ps(_mm_shuffle_ps(ar, ar, _MM_SHUFFLE(0, 0, 0, 0)), b0);
+		acc = _mm_add_ps(acc, _mm_mul_ps(_mm_shuffle_ps(ar, ar, _MM_SHUFFLE(1, 1, 1, 1)), b1));
+		acc = _mm_add_ps(acc, _mm_mul_ps(_mm_shuffle_ps(ar, ar, _MM_SHUFFLE(2, 2, 2, 2)), b2));
+		acc = _mm_add_ps(acc, _mm_mul_ps(_mm_shuffle_ps(ar, ar, _MM_SHUFFLE(3, 3, 3, 3)), b3));
+		rows[row] = acc;
+	}
+
+	_mm_store_ps(r.m[0], rows[0]);
+	_mm_store_ps(r.m[1], rows[1]);
+	_mm_store_ps(r.m[2], rows[2]);
+	_mm_store_ps(r.m[3], rows[3]);
+#else
+	float tmp[4][4];
+	for (int row = 0; row < 4; row++)
+	{
+		for (int col = 0; col < 4; col++)
+		{
+			tmp[row][col] =
+				a.m[row][0] * b.m[0][col]
+				+ a.m[row][1] * b.m[1][col]
+				+ a.m[row][2] * b.m[2][col]
+				+ a.m[row][3] * b.m[3][col];
+		}
+	}
+
+	for (int row = 0; row < 4; row++)
+	{
+		for (int col = 0; col < 4; col++)
+		{
+			r.m[row][col] = tmp[row][col];
+		}
+	}
+#endif
+}
 
-Matrix::Matrix()
-	: _11(0.f), _12(0.f), _13(0.f), _14(0.f)
-	, _21(0.f), _22(0.f), _23(0.f), _24(0.f)
-	, _31(0.f), _32(0.f), _33(0.f), _34(0.f)
-	, _41(0.f), _42(0.f), _43(0.f), _44(0.f)
-{}
+#if defined(SESS_AVX)
+// Same math as above, but two rows of the result at a time - the lower half of the
+//  256-bit register holds one row of a, the upper half the next one.
+inline void MultiplyAVX(const Matrix& a, const Matrix& b, Matrix& r)
+{
+	__m256 b0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(b.m[0]));
+	__m256 b1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(b.m[1]));
+	__m256 b2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(b.m[2]));
+	__m256 b3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(b.m[3]));
+
+	__m256 a01 = _mm256_loadu_ps(a.m[0]);
+	__m256 a23 = _mm256_loadu_ps(a.m[2]);
+
+	__m256 r01 = _mm256_mul_ps(_mm256_shuffle_ps(a01, a01, _MM_SHUFFLE(0, 0, 0, 0)), b0);
+	r01 = _mm256_add_ps(r01, _mm256_mul_ps(_mm256_shuffle_ps(a01, a01, _MM_SHUFFLE(1, 1, 1, 1)), b1));
+	r01 = _mm256_add_ps(r01, _mm256_mul_ps(_mm256_shuffle_ps(a01, a01, _MM_SHUFFLE(2, 2, 2, 2)), b2));
+	r01 = _mm256_add_ps(r01, _mm256_mul_ps(_mm256_shuffle_ps(a01, a01, _MM_SHUFFLE(3, 3, 3, 3)), b3));
 
-Matrix::Matrix(float m11, float m12, float m13, float m14, float m21, float m22, float m23, float m24, float m31, float m32, float m33, float m34, float m41, float m42, float m43, float m44)
-	: _11(m11), _12(m12), _13(m13), _14(m14)
-	, _21(m21), _22(m22), _23(m23), _24(m24)
-	, _31(m31), _32(m32), _33(m33), _34(m34)
-	, _41(m41), _42(m42), _43(m43), _44(m44)
-{}
+	__m256 r23 = _mm256_mul_ps(_mm256_shuffle_ps(a23, a23, _MM_SHUFFLE(0, 0, 0, 0)), b0);
+	r23 = _mm256_add_ps(r23, _mm256_mul_ps(_mm256_shuffle_ps(a23, a23, _MM_SHUFFLE(1, 1, 1, 1)), b1));
+	r23 = _mm256_add_ps(r23, _mm256_mul_ps(_mm256_shuffle_ps(a23, a23, _MM_SHUFFLE(2, 2, 2, 2)), b2));
+	r23 = _mm256_add_ps(r23, _mm256_mul_ps(_mm256_shuffle_ps(a23, a23, _MM_SHUFFLE(3, 3, 3, 3)), b3));
+
+	_mm256_storeu_ps(r.m[0], r01);
+	_mm256_storeu_ps(r.m[2], r23);
+}
+#endif
+
+};
 
 Matrix Matrix::Transpose() const
 {
-	Matrix tr;
+	Matrix tr{ NoInit() };
 
-	for (std::uint8_t r = 0u; r < 4u; r++)
+#if defined(SESS_SSE)
+	__m128 r0 = _mm_load_ps(m[0]);
+	__m128 r1 = _mm_load_ps(m[1]);
+	__m128 r2 = _mm_load_ps(m[2]);
+	__m128 r3 = _mm_load_ps(m[3]);
+	_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+	_mm_store_ps(tr.m[0], r0);
+	_mm_store_ps(tr.m[1], r1);
+	_mm_store_ps(tr.m[2], r2);
+	_mm_store_ps(tr.m[3], r3);
+#else
+	for (int r = 0; r < 4; r++)
 	{
-		for (std::uint8_t c = 0u; c < 4u; c++)
+		for (int c = 0; c < 4; c++)
 		{
 			tr.m[r][c] = m[c][r];
 		}
 	}
+#endif
 
 	return tr;
 }
 
-// Assumes regular 4x4 matrix, with 0 0 0 1 as the bottom row
+// Laplace expansion along the top two rows - each 2x2 determinant from the top
+//  half gets multiplied by its complementary 2x2 determinant from the bottom half
 float Matrix::Determinant() const
 {
-	return
-		_11 * (_22 * _33 - _23 * _32)
-		- _12 * (_21 * _33 - _13 * _31)
-		+ _13 * (_21 * _32 - _23 * _31);
+	float s0 = _11 * _22 - _21 * _12;
+	float s1 = _11 * _23 - _21 * _13;
+	float s2 = _11 * _24 - _21 * _14;
+	float s3 = _12 * _23 - _22 * _13;
+	float s4 = _12 * _24 - _22 * _14;
+	float s5 = _13 * _24 - _23 * _14;
+
+	float c5 = _33 * _44 - _43 * _34;
+	float c4 = _32 * _44 - _42 * _34;
+	float c3 = _32 * _43 - _42 * _33;
+	float c2 = _31 * _44 - _41 * _34;
+	float c1 = _31 * _43 - _41 * _33;
+	float c0 = _31 * _42 - _41 * _32;
+
+	return s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+}
+
+Matrix Matrix::Inverse() const
+{
+	Matrix inv{ NoInit() };
+
+#if defined(SESS_SSE)
+	// Cramer's rule, four cofactors at a time. This is the approach from Intel's
+	//  "Streaming SIMD Extensions - Inverse of 4x4 Matrix" application note, except with
+	//  a real divide at the end instead of the approximate reciprocal.
+	// Works on the columns of the matrix, with columns 1 and 3 swapped half-for-half.
+	__m128 row0 = _mm_load_ps(m[0]);
+	__m128 row1 = _mm_load_ps(m[1]);
+	__m128 row2 = _mm_load_ps(m[2]);
+	__m128 row3 = _mm_load_ps(m[3]);
+	_MM_TRANSPOSE4_PS(row0, row1, row2, row3);
+	row1 = _mm_shuffle_ps(row1, row1, 0x4E);
+	row3 = _mm_shuffle_ps(row3, row3, 0x4E);
+
+	__m128 minor0, minor1, minor2, minor3, tmp;
+
+	tmp = _mm_mul_ps(row2, row3);
+	tmp = _mm_shuffle_ps(tmp, tmp, 0xB1);
+	minor0 = _mm_mul_ps(row1, tmp);
+	minor1 = _mm_mul_ps(row0, tmp);
+	tmp = _mm_shuffle_ps(tmp, tmp, 0x4E);
+	minor0 = _mm_sub_ps(_mm_mul_ps(row1, tmp), minor0);
+	minor1 = _mm_sub_ps(_mm_mul_ps(row0, tmp), minor1);
+	minor1 = _mm_shuffle_ps(minor1, minor1, 0x4E);
+
+	tmp = _mm_mul_ps(row1, row2);
+	tmp = _mm_shuffle_ps(tmp, tmp, 0xB1);
+	minor0 = _mm_add_ps(_mm_mul_ps(row3, tmp), minor0);
+	minor3 = _mm_mul_ps(row0, tmp);
+	tmp = _mm_shuffle_ps(tmp, tmp, 0x4E);
+	minor0 = _mm_sub_ps(minor0, _mm_mul_ps(row3, tmp));
+	minor3 = _mm_sub_ps(_mm_mul_ps(row0, tmp), minor3);
+	minor3 = _mm_shuffle_ps(minor3, minor3, 0x4E);
+
+	tmp = _mm_mul_ps(_mm_shuffle_ps(row1, row1, 0x4E), row3);
+	tmp = _mm_shuffle_ps(tmp, tmp, 0xB1);
+	row2 = _mm_shuffle_ps(row2, row2, 0x4E);
+	minor0 = _mm_add_ps(_mm_mul_ps(row2, tmp), minor0);
+	minor2 = _mm_mul_ps(row0, tmp);
+	tmp = _mm_shuffle_ps(tmp, tmp, 0x4E);
+	minor0 = _mm_sub_ps(minor0, _mm_mul_ps(row2, tmp));
+	minor2 = _mm_sub_ps(_mm_mul_ps(row0, tmp), minor2);
+	minor2 = _mm_shuffle_ps(minor2, minor2, 0x4E);
+
+	tmp = _mm_mul_ps(row0, row1);
+	tmp = _mm_shuffle_ps(tmp, tmp, 0xB1);
+	minor2 = _mm_add_ps(_mm_mul_ps(row3, tmp), minor2);
+	minor3 = _mm_sub_ps(_mm_mul_ps(row2, tmp), minor3);
+	tmp = _mm_shuffle_ps(tmp, tmp, 0x4E);
+	minor2 = _mm_sub_ps(_mm_mul_ps(row3, tmp), minor2);
+	minor3 = _mm_sub_ps(minor3, _mm_mul_ps(row2, tmp));
+
+	tmp = _mm_mul_ps(row0, row3);
+	tmp = _mm_shuffle_ps(tmp, tmp, 0xB1);
+	minor1 = _mm_sub_ps(minor1, _mm_mul_ps(row2, tmp));
+	minor2 = _mm_add_ps(_mm_mul_ps(row1, tmp), minor2);
+	tmp = _mm_shuffle_ps(tmp, tmp, 0x4E);
+	minor1 = _mm_add_ps(_mm_mul_ps(row2, tmp), minor1);
+	minor2 = _mm_sub_ps(minor2, _mm_mul_ps(row1, tmp));
+
+	tmp = _mm_mul_ps(row0, row2);
+	tmp = _mm_shuffle_ps(tmp, tmp, 0xB1);
+	minor1 = _mm_add_ps(_mm_mul_ps(row3, tmp), minor1);
+	minor3 = _mm_sub_ps(minor3, _mm_mul_ps(row1, tmp));
+	tmp = _mm_shuffle_ps(tmp, tmp, 0x4E);
+	minor1 = _mm_sub_ps(minor1, _mm_mul_ps(row3, tmp));
+	minor3 = _mm_add_ps(_mm_mul_ps(row1, tmp), minor3);
+
+	// Determinant is the first column dotted with its cofactors
+	__m128 det = _mm_mul_ps(row0, minor0);
+	det = _mm_add_ps(_mm_shuffle_ps(det, det, 0x4E), det);
+	det = _mm_add_ss(_mm_shuffle_ps(det, det, 0xB1), det);
+	det = _mm_div_ss(_mm_set_ss(1.f), det);
+	det = _mm_shuffle_ps(det, det, 0x00);
+
+	_mm_store_ps(inv.m[0], _mm_mul_ps(det, minor0));
+	_mm_store_ps(inv.m[1], _mm_mul_ps(det, minor1));
+	_mm_store_ps(inv.m[2], _mm_mul_ps(det, minor2));
+	_mm_store_ps(inv.m[3], _mm_mul_ps(det, minor3));
+#else
+	// Same 2x2 determinants as Determinant() - every cofactor is built out of them
+	float s0 = _11 * _22 - _21 * _12;
+	float s1 = _11 * _23 - _21 * _13;
+	float s2 = _11 * _24 - _21 * _14;
+	float s3 = _12 * _23 - _22 * _13;
+	float s4 = _12 * _24 - _22 * _14;
+	float s5 = _13 * _24 - _23 * _14;
+
+	float c5 = _33 * _44 - _43 * _34;
+	float c4 = _32 * _44 - _42 * _34;
+	float c3 = _32 * _43 - _42 * _33;
+	float c2 = _31 * _44 - _41 * _34;
+	float c1 = _31 * _43 - _41 * _33;
+	float c0 = _31 * _42 - _41 * _32;
+
+	float invDet = 1.f / (s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0);
+
+	inv._11 = (_22 * c5 - _23 * c4 + _24 * c3) * invDet;
+	inv._12 = (-_12 * c5 + _13 * c4 - _14 * c3) * invDet;
+	inv._13 = (_42 * s5 - _43 * s4 + _44 * s3) * invDet;
+	inv._14 = (-_32 * s5 + _33 * s4 - _34 * s3) * invDet;
+
+	inv._21 = (-_21 * c5 + _23 * c2 - _24 * c1) * invDet;
+	inv._22 = (_11 * c5 - _13 * c2 + _14 * c1) * invDet;
+	inv._23 = (-_41 * s5 + _43 * s2 - _44 * s1) * invDet;
+	inv._24 = (_31 * s5 - _33 * s2 + _34 * s1) * invDet;
+
+	inv._31 = (_21 * c4 - _22 * c2 + _24 * c0) * invDet;
+	inv._32 = (-_11 * c4 + _12 * c2 - _14 * c0) * invDet;
+	inv._33 = (_41 * s4 - _42 * s2 + _44 * s0) * invDet;
+	inv._34 = (-_31 * s4 + _32 * s2 - _34 * s0) * invDet;
+
+	inv._41 = (-_21 * c3 + _22 * c1 - _23 * c0) * invDet;
+	inv._42 = (_11 * c3 - _12 * c1 + _13 * c0) * invDet;
+	inv._43 = (-_41 * s3 + _42 * s1 - _43 * s0) * invDet;
+	inv._44 = (_31 * s3 - _32 * s1 + _33 * s0) * invDet;
+#endif
+
+	return inv;
+}
+
+Matrix Matrix::InverseAffine() const
+{
+	// The bottom row is 0 0 0 1, so the top three rows are all there is to invert
+	return Affine3x4(*this).Inverse().ToMatrix();
 }
 
 Matrix Matrix::operator*(const Matrix & m2) const
 {
-	Matrix tr;
+	Matrix tr{ NoInit() };
+	Multiply(*this, m2, tr);
+	return tr;
+}
 
-	for (std::uint8_t row = 0u; row < 4; row++)
+Vec3 Matrix::TransformPoint(const Vec3& p) const
+{
+	return Vec3(
+		_11 * p.x + _12 * p.y + _13 * p.z + _14,
+		_21 * p.x + _22 * p.y + _23 * p.z + _24,
+		_31 * p.x + _32 * p.y + _33 * p.z + _34);
+}
+
+Vec3 Matrix::TransformDirection(const Vec3& d) const
+{
+	return Vec3(
+		_11 * d.x + _12 * d.y + _13 * d.z,
+		_21 * d.x + _22 * d.y + _23 * d.z,
+		_31 * d.x + _32 * d.y + _33 * d.z);
+}
+
+void Matrix::MultiplyBatch(const Matrix* a, const Matrix* b, Matrix* out, std::size_t n)
+{
+	for (std::size_t i = 0u; i < n; i++)
 	{
-		for (std::uint8_t col = 0u; col < 4; col++)
-		{
-			tr.m[row][col] = 0.f;
-			for (std::uint8_t k = 0u; k < 4; k++)
-			{
-				tr.m[row][col] += m[row][k] * m2.m[k][col];
-			}
-		}
+#if defined(SESS_AVX)
+		MultiplyAVX(a[i], b[i], out[i]);
+#else
+		Multiply(a[i], b[i], out[i]);
+#endif
 	}
+}
+
+void Matrix::TransformPoints(const Matrix& m, const Vec3* in, Vec3* out, std::size_t n)
+{
+#if defined(SESS_SSE)
+	// Transposing once up front means each point is just three broadcasts and three
+	//  multiply-adds against the columns of m - same order of operations as TransformPoint
+	Matrix t = m.Transpose();
+	__m128 c0 = _mm_load_ps(t.m[0]);
+	__m128 c1 = _mm_load_ps(t.m[1]);
+	__m128 c2 = _mm_load_ps(t.m[2]);
+	__m128 c3 = _mm_load_ps(t.m[3]);
+
+	for (std::size_t i = 0u; i < n; i++)
+	{
+		__m128 r = _mm_mul_ps(c0, _mm_set1_ps(in[i].x));
+		r = _mm_add_ps(r, _mm_mul_ps(c1, _mm_set1_ps(in[i].y)));
+		r = _mm_add_ps(r, _mm_mul_ps(c2, _mm_set1_ps(in[i].z)));
+		r = _mm_add_ps(r, c3);
 
-	return std::move(tr);
+		// Vec3 is only 12 bytes, so can't write all four lanes without stomping on the next one
+		alignas(16) float res[4];
+		_mm_store_ps(res, r);
+		out[i] = Vec3(res[0], res[1], res[2]);
+	}
+#else
+	for (std::size_t i = 0u; i < n; i++)
+	{
+		out[i] = m.TransformPoint(in[i]);
+	}
+#endif
 }
 
-};
\ No newline at end of file
+};
@@ -4,11 +4,20 @@
 // DirectX and OpenGL both use lots and lots of matrix mathematics,
 //  really it's just sorta an essential part of computer graphics.
 // This handles all the mathy stuff.
+// Storage is 16-byte aligned so each row can be loaded straight into an SSE register.
+//  The SSE/AVX paths add up the products in exactly the same order as the plain C++
+//  fallback (define SESS_NO_SIMD to get that), so results are bit-for-bit identical
+//  unless the compiler decides to fuse the scalar multiply-adds into FMAs - in that
+//  case expect up to 1 ulp of difference per element.
+
+#include <Vec3.h>
+
+#include <cstddef>
 
 namespace sess
 {
 
-class Matrix
+class alignas(16) Matrix
 {
 public:
 	union
@@ -25,18 +34,58 @@ public:
 	};
 
 public:
-	Matrix();
+	constexpr Matrix() noexcept
+		: _11(0.f), _12(0.f), _13(0.f), _14(0.f)
+		, _21(0.f), _22(0.f), _23(0.f), _24(0.f)
+		, _31(0.f), _32(0.f), _33(0.f), _34(0.f)
+		, _41(0.f), _42(0.f), _43(0.f), _44(0.f)
+	{}
 	Matrix(const Matrix&) = default;
-	Matrix(float m11, float m12, float m13, float m14, float m21, float m22, float m23, float m24, float m31, float m32, float m33, float m34, float m41, float m42, float m43, float m44);
+	constexpr Matrix(float m11, float m12, float m13, float m14, float m21, float m22, float m23, float m24, float m31, float m32, float m33, float m34, float m41, float m42, float m43, float m44) noexcept
+		: _11(m11), _12(m12), _13(m13), _14(m14)
+		, _21(m21), _22(m22), _23(m23), _24(m24)
+		, _31(m31), _32(m32), _33(m33), _34(m34)
+		, _41(m41), _42(m42), _43(m43), _44(m44)
+	{}
 	~Matrix() = default;
 
 	Matrix Transpose() const;
 	float Determinant() const;
 
+	// General inverse (cofactors divided by the determinant). A singular matrix gives
+	//  infinities/NaNs back - check Determinant() first if that could happen.
+	Matrix Inverse() const;
+
+	// Much cheaper inverse for matrices with 0 0 0 1 as the bottom row and translation
+	//  in _14, _24, _34 - anything built by Transform::GetTransformMatrix, for example.
+	// Rotation, scale (even non-uniform) and shear are all fine. For LookAtLH style
+	//  matrices (translation along the bottom row), go through Transpose() first.
+	Matrix InverseAffine() const;
+
 	Matrix operator*(const Matrix& m2) const;
 
+	// Treats the vector as a column vector, (x, y, z, 1) for points and (x, y, z, 0) for
+	//  directions. That's the layout Transform::GetTransformMatrix produces (translation
+	//  lives in _14, _24, _34). The bottom row is ignored - no perspective divide here.
+	Vec3 TransformPoint(const Vec3& p) const;
+	Vec3 TransformDirection(const Vec3& d) const;
+
+	// out[i] = a[i] * b[i] for every i < n. out may alias a or b.
+	// For composing a whole bunch of model-view-projection matrices at once.
+	static void MultiplyBatch(const Matrix* a, const Matrix* b, Matrix* out, std::size_t n);
+
+	// out[i] = m.TransformPoint(in[i]) for every i < n. out may alias in.
+	static void TransformPoints(const Matrix& m, const Vec3* in, Vec3* out, std::size_t n);
+
 public:
 	static const Matrix Identity;
+
+private:
+	// Skips zeroing out all 16 floats for results that are about to be overwritten anyways
+	struct NoInit {};
+	explicit Matrix(NoInit) noexcept {}
 };
 
-};
\ No newline at end of file
+inline constexpr Matrix Matrix::Identity = { 1.f, 0.f, 0.f, 0.f,  0.f, 1.f, 0.f, 0.f,  0.f, 0.f, 1.f, 0.f,  0.f, 0.f, 0.f, 1.f };
+
+};
@@ -0,0 +1,274 @@
+#include <MeshCache.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+namespace sess
+{
+
+namespace
+{
+
+const char MAGIC[8] = { 'S', 'E', 'S', 'S', 'M', 'E', 'S', 'H' };
+
+struct FileHeader
+{
+	char Magic[8];
+	std::uint32_t Version;
+	std::uint32_t VertexSize;
+	std::uint64_t SourceHash;
+	std::uint32_t MeshCount;
+	std::uint32_t __pad;
+};
+
+struct FileMeshEntry
+{
+	std::uint64_t VertexOffset;
+	std::uint64_t IndexOffset;
+	std::uint32_t VertexCount;
+	std::uint32_t IndexCount;
+	std::uint32_t LodCount;
+	std::uint32_t __pad[3];
+	CookedLod Lods[MAX_LODS];
+	float Specular[4];
+	float Diffuse[4];
+	float Ambient[4];
+	AABB Box;
+	BoundingSphere Sphere;
+};
+
+// If either of these trip, the layout changed - bump MeshCache::Version
+static_assert(sizeof(FileHeader) == 32u, "Cache header layout changed");
+static_assert(sizeof(CookedLod) == 12u, "Cache LOD layout changed");
+static_assert(sizeof(FileMeshEntry) == 176u, "Cache mesh entry layout changed");
+
+// FNV-1a, 64 bit. Not a cryptographic hash, but the only thing it has to catch is
+//  somebody re-exporting a model from Blender.
+const std::uint64_t FNV_OFFSET = 14695981039346656037ull;
+const std::uint64_t FNV_PRIME = 1099511628211ull;
+
+std::uint64_t Fnv1a(const void* data, std::size_t size, std::uint64_t hash)
+{
+	const std::uint8_t* bytes = static_cast<const std::uint8_t*>(data);
+	for (std::size_t i = 0u; i < size; i++)
+	{
+		hash = (hash ^ bytes[i]) * FNV_PRIME;
+	}
+	return hash;
+}
+
+std::uint64_t HashSource(const AssetData& source, const char* vertexFormat, const ImportProfile& profile)
+{
+	if (source.GetSize() == 0u)
+	{
+		return 0u;
+	}
+
+	std::uint64_t hash = Fnv1a(source.GetData(), source.GetSize(), FNV_OFFSET);
+	hash = Fnv1a(vertexFormat, strlen(vertexFormat), hash);
+	hash = Fnv1a(&profile.Flags, sizeof(profile.Flags), hash);
+	hash = Fnv1a(&profile.RemoveDegenerates, sizeof(profile.RemoveDegenerates), hash);
+	hash = Fnv1a(&profile.OverdrawThreshold, sizeof(profile.OverdrawThreshold), hash);
+	hash = Fnv1a(&profile.LodCount, sizeof(profile.LodCount), hash);
+	hash = Fnv1a(profile.LodRatios, profile.LodCount * sizeof(float), hash);
+	hash = Fnv1a(&MeshCache::Version, sizeof(MeshCache::Version), hash);
+
+	// 0 is reserved for "nothing to cache"
+	return (hash == 0u) ? 1u : hash;
+}
+
+constexpr std::uint64_t AlignTo16(std::uint64_t offset)
+{
+	return (offset + 15u) & ~std::uint64_t(15u);
+}
+
+// Is [offset, offset + size) inside a file of fileSize bytes, without overflowing?
+bool InFile(std::uint64_t offset, std::uint64_t size, std::uint64_t fileSize)
+{
+	return offset <= fileSize && size <= fileSize - offset;
+}
+
+// Every LOD has to be a range of the mesh's own indices
+bool LodsInRange(const FileMeshEntry& entry)
+{
+	for (std::uint32_t lod = 0u; lod < entry.LodCount; lod++)
+	{
+		if (!InFile(entry.Lods[lod].FirstIndex, entry.Lods[lod].IndexCount, entry.IndexCount))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+};
+
+MeshCache::MeshCache(const AssetPack& assets, const char* sourceFile, const AssetData& source, const char* vertexFormat, const ImportProfile& profile)
+	: assets_(&assets)
+	, path_(std::string(sourceFile) + ".smesh")
+	, sourceHash_(HashSource(source, vertexFormat, profile))
+{}
+
+const std::string& MeshCache::GetPath() const
+{
+	return path_;
+}
+
+bool MeshCache::Read(std::uint32_t vertexSize, AssetData& file, std::vector<MeshView>& meshes) const
+{
+	if (sourceHash_ == 0u)
+	{
+		return false;
+	}
+
+	// A cache that came in the asset pack first. If the model changed since the pack was
+	//  made, that one's out of date and the one Save() wrote to the disk is what we want.
+	if (assets_->Contains(path_.c_str()) && assets_->Load(path_.c_str(), file) && Parse(vertexSize, file, meshes))
+	{
+		return true;
+	}
+
+	// Mapped instead of read in, so the vertex and index data only gets copied once - from
+	//  the OS's file cache straight into the vectors that end up in the RenderCall
+	if (!AssetPack::LoadLoose(path_.c_str(), file))
+	{
+		return false; // Not cooked yet - not an error
+	}
+
+	return Parse(vertexSize, file, meshes);
+}
+
+bool MeshCache::Parse(std::uint32_t vertexSize, const AssetData& file, std::vector<MeshView>& meshes) const
+{
+	std::uint64_t fileSize = file.GetSize();
+	if (fileSize < sizeof(FileHeader))
+	{
+		std::cerr << "Mesh cache " << path_ << " is truncated, rebuilding it" << std::endl;
+		return false;
+	}
+
+	FileHeader header;
+	memcpy(&header, file.GetData(), sizeof(header));
+	if (memcmp(header.Magic, MAGIC, sizeof(MAGIC)) != 0)
+	{
+		std::cerr << path_ << " is not a mesh cache file, rebuilding it" << std::endl;
+		return false;
+	}
+
+	// Out of date - the model (or this code) changed since it was cooked. Expected, so no message.
+	if (header.Version != Version || header.VertexSize != vertexSize || header.SourceHash != sourceHash_)
+	{
+		return false;
+	}
+
+	if (!InFile(sizeof(FileHeader), std::uint64_t(header.MeshCount) * sizeof(FileMeshEntry), fileSize))
+	{
+		std::cerr << "Mesh cache " << path_ << " is truncated, rebuilding it" << std::endl;
+		return false;
+	}
+
+	meshes.clear();
+	meshes.reserve(header.MeshCount);
+	for (std::uint32_t meshIdx = 0u; meshIdx < header.MeshCount; meshIdx++)
+	{
+		FileMeshEntry entry;
+		memcpy(&entry, file.GetData() + sizeof(FileHeader) + meshIdx * sizeof(FileMeshEntry), sizeof(entry));
+
+		if (!InFile(entry.VertexOffset, std::uint64_t(entry.VertexCount) * vertexSize, fileSize)
+			|| !InFile(entry.IndexOffset, std::uint64_t(entry.IndexCount) * sizeof(std::uint32_t), fileSize)
+			|| entry.VertexOffset % 16u != 0u || entry.IndexOffset % 16u != 0u
+			|| entry.LodCount > MAX_LODS || !LodsInRange(entry))
+		{
+			std::cerr << "Mesh cache " << path_ << " is corrupt, rebuilding it" << std::endl;
+			return false;
+		}
+
+		CookedMaterial material(
+			Color(entry.Specular[0], entry.Specular[1], entry.Specular[2], entry.Specular[3]),
+			Color(entry.Diffuse[0], entry.Diffuse[1], entry.Diffuse[2], entry.Diffuse[3]),
+			Color(entry.Ambient[0], entry.Ambient[1], entry.Ambient[2], entry.Ambient[3]));
+
+		meshes.push_back({
+			file.GetData() + entry.VertexOffset, entry.VertexCount,
+			reinterpret_cast<const std::uint32_t*>(file.GetData() + entry.IndexOffset), entry.IndexCount,
+			reinterpret_cast<const CookedLod*>(file.GetData() + sizeof(FileHeader) + meshIdx * sizeof(FileMeshEntry) + offsetof(FileMeshEntry, Lods)), entry.LodCount,
+			material, Bounds(entry.Box, entry.Sphere) });
+	}
+
+	return true;
+}
+
+bool MeshCache::Write(std::uint32_t vertexSize, const std::vector<MeshView>& meshes) const
+{
+	if (sourceHash_ == 0u)
+	{
+		return false;
+	}
+
+	// Lay everything out first...
+	std::vector<FileMeshEntry> entries(meshes.size());
+	std::uint64_t offset = sizeof(FileHeader) + meshes.size() * sizeof(FileMeshEntry);
+	for (std::size_t meshIdx = 0u; meshIdx < meshes.size(); meshIdx++)
+	{
+		const MeshView& mesh = meshes[meshIdx];
+		FileMeshEntry& entry = entries[meshIdx];
+
+		entry.VertexCount = mesh.VertexCount;
+		entry.IndexCount = mesh.IndexCount;
+		entry.LodCount = std::min(mesh.LodCount, MAX_LODS);
+		std::copy(mesh.Lods, mesh.Lods + entry.LodCount, entry.Lods);
+		mesh.Material.Specular.packAsFloatArray(entry.Specular);
+		mesh.Material.Diffuse.packAsFloatArray(entry.Diffuse);
+		mesh.Material.Ambient.packAsFloatArray(entry.Ambient);
+		entry.Box = mesh.LocalBounds.Box;
+		entry.Sphere = mesh.LocalBounds.Sphere;
+
+		offset = AlignTo16(offset);
+		entry.VertexOffset = offset;
+		offset += std::uint64_t(mesh.VertexCount) * vertexSize;
+
+		offset = AlignTo16(offset);
+		entry.IndexOffset = offset;
+		offset += std::uint64_t(mesh.IndexCount) * sizeof(std::uint32_t);
+	}
+
+	// ... then fill in one buffer and write it all in one go
+	std::vector<std::uint8_t> file(static_cast<std::size_t>(offset), 0u);
+
+	FileHeader header = {};
+	memcpy(header.Magic, MAGIC, sizeof(MAGIC));
+	header.Version = Version;
+	header.VertexSize = vertexSize;
+	header.SourceHash = sourceHash_;
+	header.MeshCount = static_cast<std::uint32_t>(meshes.size());
+	memcpy(file.data(), &header, sizeof(header));
+
+	for (std::size_t meshIdx = 0u; meshIdx < meshes.size(); meshIdx++)
+	{
+		const FileMeshEntry& entry = entries[meshIdx];
+		memcpy(file.data() + sizeof(FileHeader) + meshIdx * sizeof(FileMeshEntry), &entry, sizeof(entry));
+		if (entry.VertexCount > 0u)
+		{
+			memcpy(file.data() + entry.VertexOffset, meshes[meshIdx].Vertices, std::size_t(entry.VertexCount) * vertexSize);
+		}
+		if (entry.IndexCount > 0u)
+		{
+			memcpy(file.data() + entry.IndexOffset, meshes[meshIdx].Indices, entry.IndexCount * sizeof(std::uint32_t));
+		}
+	}
+
+	std::ofstream out(path_, std::ios::binary | std::ios::trunc);
+	if (!out || !out.write(reinterpret_cast<const char*>(file.data()), file.size()))
+	{
+		// Not fatal, the model still loaded - it'll just be slow again next time
+		std::cerr << "Could not write mesh cache " << path_ << std::endl;
+		return false;
+	}
+
+	return true;
+}
+
+};
@@ -0,0 +1,178 @@
+#pragma once
+
+// Cooked mesh cache - the finished vertex/index arrays for a model, saved next to the
+//  model file so the next launch doesn't have to go through Assimp again.
+// Importing an FBX with aiProcessPreset_TargetRealtime_MaxQuality means parsing the whole
+//  file and then running a dozen post-processing steps over it (tangents, vertex cache
+//  optimization, duplicate vertex removal...). The output of all that never changes
+//  unless the file does, so it only really needs to happen once.
+//
+// Usage, roughly:
+//  MeshCache cache(assets, "road.fbx", roadFileData, "MaterialOnlyShader::Vertex", ImportProfile::RuntimeQuality);
+//  std::vector<CookedMesh<MaterialOnlyShader::Vertex>> meshes;
+//  if (!cache.Load(meshes))
+//  {
+//      ... import with Assimp, fill in meshes ...
+//      cache.Save(meshes);
+//  }
+//
+// The cache file is "<model file>.smesh". It's only used if it was made from a model file
+//  with exactly the same contents, the same import profile and the same vertex format -
+//  all three go into a hash stored in the file. Change any of them and the cache is
+//  just quietly rebuilt.
+// A cache file can also be put in the asset pack (see AssetPack.h), so a fresh checkout
+//  doesn't have to import anything either. If the packed one is out of date, the one on
+//  disk gets used instead - Save() always writes to the disk.
+//
+// File layout - every offset is from the start of the file, every block starts on a
+//  16 byte boundary, so the whole thing can be mapped straight into memory and used
+//  in place:
+//  Header               magic, version, vertex size, mesh count, source hash
+//  MeshEntry[count]     per mesh: where its vertices/indices are, LODs, material, bounds
+//  vertex and index data
+
+#include <AssetPack.h>
+#include <Bounds.h>
+#include <Color.h>
+#include <ImportProfile.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace sess
+{
+
+// Both shaders use the same three colors for a material, so the cache stores those and
+//  each model turns them into whatever its shader's Material is
+struct CookedMaterial
+{
+	CookedMaterial()
+		: Specular(Color::Palette::Black), Diffuse(Color::Palette::Black), Ambient(Color::Palette::Black)
+	{}
+	CookedMaterial(const Color& specular, const Color& diffuse, const Color& ambient)
+		: Specular(specular), Diffuse(diffuse), Ambient(ambient)
+	{}
+
+	Color Specular;
+	Color Diffuse;
+	Color Ambient;
+};
+
+// One level of detail - a range of a CookedMesh's Indices. Every level uses the same
+//  vertices, just fewer of them (see MeshSimplifier.h).
+struct CookedLod
+{
+	std::uint32_t FirstIndex;
+	std::uint32_t IndexCount;
+	float Error; // How far off this level is from full detail, in model space units
+};
+
+// One mesh, ready to go into a RenderCall
+template <typename VertexT>
+struct CookedMesh
+{
+	std::vector<VertexT> Vertices;
+	std::vector<std::uint32_t> Indices; // Every LOD's, one after the other
+	std::vector<CookedLod> Lods; // Full detail first, then coarser and coarser
+	CookedMaterial Material;
+	Bounds LocalBounds;
+};
+
+class MeshCache
+{
+public:
+	// source is the contents of sourceFile, which is what the cache has to match.
+	// vertexFormat names the vertex type the meshes get cooked into. Any name works, as
+	//  long as it's different for different vertex layouts.
+	MeshCache(const AssetPack& assets, const char* sourceFile, const AssetData& source, const char* vertexFormat, const ImportProfile& profile);
+	MeshCache(const MeshCache&) = default;
+	~MeshCache() = default;
+
+	// False if there's no usable cache file yet (missing, out of date or broken) -
+	//  import the model the slow way and Save it.
+	template <typename VertexT>
+	bool Load(std::vector<CookedMesh<VertexT>>& meshes) const
+	{
+		static_assert(std::is_trivially_copyable<VertexT>::value, "Cached vertices are copied straight out of the file");
+
+		AssetData file;
+		std::vector<MeshView> views;
+		if (!Read(sizeof(VertexT), file, views))
+		{
+			return false;
+		}
+
+		meshes.clear();
+		meshes.reserve(views.size());
+		for (auto&& view : views)
+		{
+			const VertexT* vertices = reinterpret_cast<const VertexT*>(view.Vertices);
+
+			CookedMesh<VertexT> mesh;
+			mesh.Vertices.assign(vertices, vertices + view.VertexCount);
+			mesh.Indices.assign(view.Indices, view.Indices + view.IndexCount);
+			mesh.Lods.assign(view.Lods, view.Lods + view.LodCount);
+			mesh.Material = view.Material;
+			mesh.LocalBounds = view.LocalBounds;
+			meshes.push_back(std::move(mesh));
+		}
+
+		return true;
+	}
+
+	template <typename VertexT>
+	bool Save(const std::vector<CookedMesh<VertexT>>& meshes) const
+	{
+		static_assert(std::is_trivially_copyable<VertexT>::value, "Cached vertices are copied straight into the file");
+
+		std::vector<MeshView> views;
+		views.reserve(meshes.size());
+		for (auto&& mesh : meshes)
+		{
+			views.push_back({
+				mesh.Vertices.data(), static_cast<std::uint32_t>(mesh.Vertices.size()),
+				mesh.Indices.data(), static_cast<std::uint32_t>(mesh.Indices.size()),
+				mesh.Lods.data(), static_cast<std::uint32_t>(mesh.Lods.size()),
+				mesh.Material, mesh.LocalBounds });
+		}
+
+		return Write(sizeof(VertexT), views);
+	}
+
+	const std::string& GetPath() const;
+
+public:
+	// Bump this whenever the file layout changes, or what ModelLoader puts in the meshes
+	//  does - old files are then ignored
+	static constexpr std::uint32_t Version = 5u;
+
+private:
+	// Vertex type agnostic view of one mesh, so all of the actual file handling can live
+	//  in MeshCache.cc instead of in this header
+	struct MeshView
+	{
+		const void* Vertices;
+		std::uint32_t VertexCount;
+		const std::uint32_t* Indices;
+		std::uint32_t IndexCount;
+		const CookedLod* Lods;
+		std::uint32_t LodCount; // Up to MAX_LODS
+		CookedMaterial Material;
+		Bounds LocalBounds;
+	};
+
+	// On success, the pointers in meshes point into file
+	bool Read(std::uint32_t vertexSize, AssetData& file, std::vector<MeshView>& meshes) const;
+	bool Parse(std::uint32_t vertexSize, const AssetData& file, std::vector<MeshView>& meshes) const;
+	bool Write(std::uint32_t vertexSize, const std::vector<MeshView>& meshes) const;
+
+private:
+	const AssetPack* assets_;
+	std::string path_;
+	std::uint64_t sourceHash_; // 0 if the source file is empty
+};
+
+};
@@ -0,0 +1,617 @@
+#include <MeshOptimizer.h>
+#include <Vec3.h>
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+namespace sess
+{
+
+namespace
+{
+
+// The cache Forsyth's scores are tuned for. Bigger than VERTEX_CACHE_SIZE on purpose -
+//  it keeps track of vertices that just fell out of a small cache but would still be a
+//  hit on a bigger one, so it does well no matter what the hardware actually does.
+constexpr std::uint32_t FORSYTH_CACHE_SIZE = 32u;
+
+// Past this many triangles left, a vertex's score stops changing in any way that matters
+constexpr std::uint32_t FORSYTH_MAX_VALENCE = 32u;
+
+// Scores for a vertex at each position in the cache, and for each number of triangles
+//  still left to draw that use it. Worked out once, since powf isn't cheap.
+struct ScoreTables
+{
+	float Cache[FORSYTH_CACHE_SIZE];
+	float Valence[FORSYTH_MAX_VALENCE + 1u];
+
+	ScoreTables()
+	{
+		for (std::uint32_t pos = 0u; pos < FORSYTH_CACHE_SIZE; pos++)
+		{
+			// The last triangle's three vertices get a fixed score that's a bit lower than
+			//  the next few - otherwise the same few vertices keep getting picked, and the
+			//  strip of triangles folds back on itself
+			Cache[pos] = (pos < 3u)
+				? 0.75f
+				: powf(1.f - (pos - 3u) / float(FORSYTH_CACHE_SIZE - 3u), 1.5f);
+		}
+
+		// Vertices with only a couple of triangles left get a boost, so they get finished
+		//  off and don't hang around forever
+		Valence[0u] = 0.f;
+		for (std::uint32_t valence = 1u; valence <= FORSYTH_MAX_VALENCE; valence++)
+		{
+			Valence[valence] = 2.f / sqrtf(float(valence));
+		}
+	}
+};
+
+const ScoreTables SCORES;
+
+// Size of the depth buffer AnalyzeOverdraw renders each view into
+constexpr std::uint32_t OVERDRAW_RESOLUTION = 256u;
+
+// A FIFO vertex cache, without actually moving vertices through a FIFO: every vertex
+//  remembers when it went in, and anything that went in more than size misses ago has
+//  been pushed out since
+class FifoCache
+{
+public:
+	FifoCache(std::size_t vertexCount, std::uint32_t size)
+		: insertedAt_(vertexCount, 0u), clock_(size + 1u), size_(size) // So nothing starts out in the cache
+	{}
+
+	// 1 if vertex had to be shaded
+	std::uint32_t Touch(std::uint32_t vertex)
+	{
+		if (clock_ - insertedAt_[vertex] > size_)
+		{
+			insertedAt_[vertex] = clock_++;
+			return 1u;
+		}
+		return 0u;
+	}
+
+	std::uint32_t TouchTriangle(const std::uint32_t* triangle)
+	{
+		return Touch(triangle[0u]) + Touch(triangle[1u]) + Touch(triangle[2u]);
+	}
+
+	// Everything that's in there now is old enough to have been pushed out
+	void Flush()
+	{
+		clock_ += size_;
+	}
+
+private:
+	std::vector<std::uint32_t> insertedAt_;
+	std::uint32_t clock_;
+	std::uint32_t size_;
+};
+
+Vec3 PositionAt(const float* positions, std::size_t positionStride, std::uint32_t vertex)
+{
+	const float* p = reinterpret_cast<const float*>(reinterpret_cast<const std::uint8_t*>(positions) + vertex * positionStride);
+	return Vec3(p[0u], p[1u], p[2u]);
+}
+
+float Axis(const Vec3& v, std::uint32_t axis)
+{
+	return (axis == 0u) ? v.x : ((axis == 1u) ? v.y : v.z);
+}
+
+// One triangle into the depth buffer, with the depth test on - returns how many pixels passed.
+//  x and y are already in pixels.
+std::uint32_t RasterizeDepth(const float* x, const float* y, const float* z, std::vector<float>& depth)
+{
+	float area = (x[1u] - x[0u]) * (y[2u] - y[0u]) - (y[1u] - y[0u]) * (x[2u] - x[0u]);
+	if (fabsf(area) < 1e-12f)
+	{
+		return 0u; // Edge on to this view, so it can't cover anything
+	}
+	float invArea = 1.f / area;
+
+	const float last = float(OVERDRAW_RESOLUTION - 1u);
+	int minX = int(std::max(0.f, floorf(std::min({ x[0u], x[1u], x[2u] }))));
+	int maxX = int(std::min(last, ceilf(std::max({ x[0u], x[1u], x[2u] }))));
+	int minY = int(std::max(0.f, floorf(std::min({ y[0u], y[1u], y[2u] }))));
+	int maxY = int(std::min(last, ceilf(std::max({ y[0u], y[1u], y[2u] }))));
+
+	std::uint32_t shaded = 0u;
+	for (int py = minY; py <= maxY; py++)
+	{
+		for (int px = minX; px <= maxX; px++)
+		{
+			// Sample at the pixel center, like the GPU does
+			float sx = px + 0.5f;
+			float sy = py + 0.5f;
+
+			// How much of each corner this point is - all three are between 0 and 1 inside
+			//  the triangle, no matter which way it winds
+			float w0 = ((x[2u] - x[1u]) * (sy - y[1u]) - (y[2u] - y[1u]) * (sx - x[1u])) * invArea;
+			float w1 = ((x[0u] - x[2u]) * (sy - y[2u]) - (y[0u] - y[2u]) * (sx - x[2u])) * invArea;
+			float w2 = 1.f - w0 - w1;
+			if (w0 < 0.f || w1 < 0.f || w2 < 0.f)
+			{
+				continue;
+			}
+
+			float d = w0 * z[0u] + w1 * z[1u] + w2 * z[2u];
+			float& stored = depth[py * OVERDRAW_RESOLUTION + px];
+			if (d < stored)
+			{
+				stored = d;
+				shaded++;
+			}
+		}
+	}
+	return shaded;
+}
+
+float VertexScore(int cachePosition, std::uint32_t liveTriangles)
+{
+	if (liveTriangles == 0u)
+	{
+		return -1.f; // Nothing left to draw with it, so it shouldn't pull anything along
+	}
+
+	float score = (cachePosition >= 0) ? SCORES.Cache[cachePosition] : 0.f;
+	return score + SCORES.Valence[(liveTriangles < FORSYTH_MAX_VALENCE) ? liveTriangles : FORSYTH_MAX_VALENCE];
+}
+
+};
+
+VertexCacheStats AnalyzeVertexCache(const std::uint32_t* indices, std::size_t indexCount, std::size_t vertexCount, std::uint32_t cacheSize)
+{
+	VertexCacheStats stats = { 0.f, 0.f };
+	if (indexCount < 3u)
+	{
+		return stats;
+	}
+
+	FifoCache cache(vertexCount, cacheSize);
+	std::vector<bool> used(vertexCount, false);
+	std::uint32_t misses = 0u;
+	std::uint32_t uniqueVertices = 0u;
+
+	for (std::size_t i = 0u; i < indexCount; i++)
+	{
+		std::uint32_t vertex = indices[i];
+		misses += cache.Touch(vertex);
+		if (!used[vertex])
+		{
+			used[vertex] = true;
+			uniqueVertices++;
+		}
+	}
+
+	stats.Acmr = float(misses) / float(indexCount / 3u);
+	stats.Atvr = float(misses) / float(uniqueVertices);
+	return stats;
+}
+
+void OptimizeVertexCache(std::uint32_t* out, const std::uint32_t* indices, std::size_t indexCount, std::size_t vertexCount)
+{
+	const std::size_t triangleCount = indexCount / 3u;
+	if (triangleCount == 0u)
+	{
+		return;
+	}
+
+	// out is written while indices is still being read, and they might be the same array
+	std::vector<std::uint32_t> source(indices, indices + triangleCount * 3u);
+
+	// Which triangles use each vertex, all in one array: vertex v's triangles are
+	//  adjacency[firstTriangle[v]] onwards. The ones that are still to be drawn are kept at
+	//  the front, so there's liveTriangles[v] of them.
+	std::vector<std::uint32_t> liveTriangles(vertexCount, 0u);
+	for (std::uint32_t vertex : source)
+	{
+		liveTriangles[vertex]++;
+	}
+
+	std::vector<std::uint32_t> firstTriangle(vertexCount, 0u);
+	std::uint32_t offset = 0u;
+	for (std::size_t vertex = 0u; vertex < vertexCount; vertex++)
+	{
+		firstTriangle[vertex] = offset;
+		offset += liveTriangles[vertex];
+	}
+
+	std::vector<std::uint32_t> adjacency(triangleCount * 3u);
+	std::vector<std::uint32_t> filled(vertexCount, 0u);
+	for (std::size_t i = 0u; i < source.size(); i++)
+	{
+		std::uint32_t vertex = source[i];
+		adjacency[firstTriangle[vertex] + filled[vertex]++] = static_cast<std::uint32_t>(i / 3u);
+	}
+
+	std::vector<int> cachePosition(vertexCount, -1);
+	std::vector<float> vertexScore(vertexCount);
+	for (std::size_t vertex = 0u; vertex < vertexCount; vertex++)
+	{
+		vertexScore[vertex] = VertexScore(-1, liveTriangles[vertex]);
+	}
+
+	// Nothing is cached yet, so the first triangle is whichever one has the fewest
+	//  neighbours - a corner or an edge is a better place to start than the middle
+	std::vector<bool> emitted(triangleCount, false);
+	std::uint32_t bestTriangle = 0u;
+	float bestScore = -FLT_MAX;
+	for (std::size_t tri = 0u; tri < triangleCount; tri++)
+	{
+		float score = vertexScore[source[tri * 3u + 0u]] + vertexScore[source[tri * 3u + 1u]] + vertexScore[source[tri * 3u + 2u]];
+		if (score > bestScore)
+		{
+			bestScore = score;
+			bestTriangle = static_cast<std::uint32_t>(tri);
+		}
+	}
+
+	// Room for the whole cache plus the three vertices that push the oldest ones out
+	std::uint32_t cache[FORSYTH_CACHE_SIZE + 3u];
+	std::uint32_t cacheCount = 0u;
+	std::size_t nextUnemitted = 0u; // Where to look for a fresh start when the cache dries up
+
+	for (std::size_t outTri = 0u; outTri < triangleCount; outTri++)
+	{
+		if (bestTriangle == UINT32_MAX)
+		{
+			// Nothing in the cache touches a triangle that's left - this part of the mesh is
+			//  done, so just start over somewhere else
+			while (emitted[nextUnemitted])
+			{
+				nextUnemitted++;
+			}
+			bestTriangle = static_cast<std::uint32_t>(nextUnemitted);
+		}
+
+		const std::uint32_t* triVertices = &source[bestTriangle * 3u];
+		out[outTri * 3u + 0u] = triVertices[0u];
+		out[outTri * 3u + 1u] = triVertices[1u];
+		out[outTri * 3u + 2u] = triVertices[2u];
+		emitted[bestTriangle] = true;
+
+		// Take the triangle out of its vertices' live lists (swap it to the back of them)
+		for (std::uint32_t corner = 0u; corner < 3u; corner++)
+		{
+			std::uint32_t vertex = triVertices[corner];
+			std::uint32_t* live = &adjacency[firstTriangle[vertex]];
+			std::uint32_t last = --liveTriangles[vertex];
+			for (std::uint32_t i = 0u; i <= last; i++)
+			{
+				if (live[i] == bestTriangle)
+				{
+					live[i] = live[last];
+					live[last] = bestTriangle;
+					break;
+				}
+			}
+		}
+
+		// The triangle's vertices go to the front of the cache, everything else moves back
+		std::uint32_t newCache[FORSYTH_CACHE_SIZE + 3u];
+		std::uint32_t newCount = 0u;
+		for (std::uint32_t corner = 0u; corner < 3u; corner++)
+		{
+			// Degenerate triangles can have the same vertex twice, it still only goes in once
+			std::uint32_t vertex = triVertices[corner];
+			bool seen = false;
+			for (std::uint32_t i = 0u; i < newCount; i++)
+			{
+				seen |= (newCache[i] == vertex);
+			}
+			if (!seen)
+			{
+				newCache[newCount++] = vertex;
+			}
+		}
+		for (std::uint32_t i = 0u; i < cacheCount; i++)
+		{
+			std::uint32_t vertex = cache[i];
+			if (vertex != triVertices[0u] && vertex != triVertices[1u] && vertex != triVertices[2u])
+			{
+				newCache[newCount++] = vertex;
+			}
+		}
+
+		// Only vertices that were in the cache, or just got into it, have new scores - so
+		//  only their triangles need a look when picking the next one
+		for (std::uint32_t i = 0u; i < newCount; i++)
+		{
+			std::uint32_t vertex = newCache[i];
+			cachePosition[vertex] = (i < FORSYTH_CACHE_SIZE) ? static_cast<int>(i) : -1;
+			vertexScore[vertex] = VertexScore(cachePosition[vertex], liveTriangles[vertex]);
+		}
+
+		bestTriangle = UINT32_MAX;
+		bestScore = -FLT_MAX;
+		for (std::uint32_t i = 0u; i < newCount; i++)
+		{
+			std::uint32_t vertex = newCache[i];
+			const std::uint32_t* live = &adjacency[firstTriangle[vertex]];
+			for (std::uint32_t j = 0u; j < liveTriangles[vertex]; j++)
+			{
+				std::uint32_t tri = live[j];
+				float score = vertexScore[source[tri * 3u + 0u]] + vertexScore[source[tri * 3u + 1u]] + vertexScore[source[tri * 3u + 2u]];
+				if (score > bestScore)
+				{
+					bestScore = score;
+					bestTriangle = tri;
+				}
+			}
+		}
+
+		cacheCount = (newCount < FORSYTH_CACHE_SIZE) ? newCount : FORSYTH_CACHE_SIZE;
+		for (std::uint32_t i = 0u; i < cacheCount; i++)
+		{
+			cache[i] = newCache[i];
+		}
+	}
+}
+
+OverdrawStats AnalyzeOverdraw(const std::uint32_t* indices, std::size_t indexCount, const float* positions, std::size_t positionStride, std::size_t vertexCount)
+{
+	OverdrawStats stats = { 0.f, 0u, 0u };
+	if (indexCount < 3u || vertexCount == 0u)
+	{
+		return stats;
+	}
+
+	Vec3 min = PositionAt(positions, positionStride, 0u);
+	Vec3 max = min;
+	for (std::uint32_t vertex = 1u; vertex < vertexCount; vertex++)
+	{
+		Vec3 p = PositionAt(positions, positionStride, vertex);
+		min = Vec3(std::min(min.x, p.x), std::min(min.y, p.y), std::min(min.z, p.z));
+		max = Vec3(std::max(max.x, p.x), std::max(max.y, p.y), std::max(max.z, p.z));
+	}
+
+	std::vector<float> depth(OVERDRAW_RESOLUTION * OVERDRAW_RESOLUTION);
+	for (std::uint32_t view = 0u; view < 6u; view++)
+	{
+		// Looking down the x, y or z axis, from the + side or the - side. Orthographic, with
+		//  the same scale on both screen axes so nothing gets squashed.
+		std::uint32_t depthAxis = view / 2u;
+		std::uint32_t uAxis = (depthAxis + 1u) % 3u;
+		std::uint32_t vAxis = (depthAxis + 2u) % 3u;
+		float depthSign = (view % 2u == 0u) ? 1.f : -1.f;
+
+		float extent = std::max(Axis(max, uAxis) - Axis(min, uAxis), Axis(max, vAxis) - Axis(min, vAxis));
+		if (extent <= 0.f)
+		{
+			continue; // The mesh is a line from here
+		}
+		float scale = OVERDRAW_RESOLUTION / extent;
+
+		std::fill(depth.begin(), depth.end(), FLT_MAX);
+		for (std::size_t i = 0u; i + 2u < indexCount; i += 3u)
+		{
+			float x[3], y[3], z[3];
+			for (std::uint32_t corner = 0u; corner < 3u; corner++)
+			{
+				Vec3 p = PositionAt(positions, positionStride, indices[i + corner]);
+				x[corner] = (Axis(p, uAxis) - Axis(min, uAxis)) * scale;
+				y[corner] = (Axis(p, vAxis) - Axis(min, vAxis)) * scale;
+				z[corner] = Axis(p, depthAxis) * depthSign;
+			}
+			stats.PixelsShaded += RasterizeDepth(x, y, z, depth);
+		}
+
+		stats.PixelsCovered += static_cast<std::uint32_t>(std::count_if(depth.begin(), depth.end(), [](float d) { return d != FLT_MAX; }));
+	}
+
+	stats.Overdraw = (stats.PixelsCovered > 0u) ? float(stats.PixelsShaded) / float(stats.PixelsCovered) : 0.f;
+	return stats;
+}
+
+void OptimizeOverdraw(std::uint32_t* out, const std::uint32_t* indices, std::size_t indexCount, const float* positions, std::size_t positionStride, std::size_t vertexCount, float threshold)
+{
+	const std::size_t triangleCount = indexCount / 3u;
+	if (triangleCount == 0u)
+	{
+		return;
+	}
+
+	// out is written while indices is still being read, and they might be the same array
+	std::vector<std::uint32_t> source(indices, indices + triangleCount * 3u);
+
+	// Hard boundaries: a triangle where all three vertices miss is where the cache order
+	//  jumped somewhere else entirely. Moving things around at those points costs nothing.
+	FifoCache cache(vertexCount, VERTEX_CACHE_SIZE);
+	std::vector<std::size_t> hardStarts;
+	for (std::size_t tri = 0u; tri < triangleCount; tri++)
+	{
+		if (cache.TouchTriangle(&source[tri * 3u]) == 3u)
+		{
+			hardStarts.push_back(tri);
+		}
+	}
+	hardStarts.push_back(triangleCount); // So every cluster ends where the next one starts
+
+	// Soft boundaries: inside each hard cluster, cut wherever the piece so far (starting
+	//  from an empty cache) is no worse than threshold times the whole cluster's ACMR.
+	//  Each piece then starts with an empty cache too, so the total stays under that.
+	std::vector<std::size_t> clusterStarts;
+	for (std::size_t hard = 0u; hard + 1u < hardStarts.size(); hard++)
+	{
+		std::size_t start = hardStarts[hard];
+		std::size_t end = hardStarts[hard + 1u];
+		clusterStarts.push_back(start);
+		if (threshold < 1.f)
+		{
+			continue;
+		}
+
+		cache.Flush();
+		std::uint32_t hardMisses = 0u;
+		for (std::size_t tri = start; tri < end; tri++)
+		{
+			hardMisses += cache.TouchTriangle(&source[tri * 3u]);
+		}
+		float limit = threshold * hardMisses / float(end - start);
+
+		cache.Flush();
+		std::size_t softStart = start;
+		std::uint32_t softMisses = 0u;
+		for (std::size_t tri = start; tri + 1u < end; tri++)
+		{
+			softMisses += cache.TouchTriangle(&source[tri * 3u]);
+			if (softMisses <= limit * (tri + 1u - softStart))
+			{
+				softStart = tri + 1u;
+				softMisses = 0u;
+				clusterStarts.push_back(softStart);
+				cache.Flush();
+			}
+		}
+	}
+	clusterStarts.push_back(triangleCount);
+
+	Vec3 meshCenter = Vec3::Zero;
+	for (std::uint32_t vertex = 0u; vertex < vertexCount; vertex++)
+	{
+		meshCenter += PositionAt(positions, positionStride, vertex);
+	}
+	meshCenter *= 1.f / float(vertexCount);
+
+	// Which way is "out" depends on the winding convention, and that depends on who made the
+	//  mesh and how it got imported. Summed up over a closed mesh, each triangle's facing
+	//  times how far out it is comes out as (6x) the volume - positive if the faces point
+	//  out, negative if they point in. So the mesh itself says which way to look.
+	float signedVolume = 0.f;
+	for (std::size_t tri = 0u; tri < triangleCount; tri++)
+	{
+		Vec3 a = PositionAt(positions, positionStride, source[tri * 3u + 0u]) - meshCenter;
+		Vec3 b = PositionAt(positions, positionStride, source[tri * 3u + 1u]) - meshCenter;
+		Vec3 c = PositionAt(positions, positionStride, source[tri * 3u + 2u]) - meshCenter;
+		signedVolume += Vec3::Dot(a, Vec3::Cross(b, c));
+	}
+	const float outward = (signedVolume < 0.f) ? -1.f : 1.f;
+
+	// How far out from the middle each cluster sits, along the way it faces. Big means it's
+	//  on the outside facing out - the kind of thing that's in front of the rest of the mesh.
+	struct ClusterOrder
+	{
+		float Occlusion;
+		std::size_t Cluster;
+	};
+	std::vector<ClusterOrder> order(clusterStarts.size() - 1u);
+	for (std::size_t cluster = 0u; cluster < order.size(); cluster++)
+	{
+		Vec3 center = Vec3::Zero;
+		Vec3 normal = Vec3::Zero;
+		float area = 0.f;
+		for (std::size_t tri = clusterStarts[cluster]; tri < clusterStarts[cluster + 1u]; tri++)
+		{
+			Vec3 a = PositionAt(positions, positionStride, source[tri * 3u + 0u]);
+			Vec3 b = PositionAt(positions, positionStride, source[tri * 3u + 1u]);
+			Vec3 c = PositionAt(positions, positionStride, source[tri * 3u + 2u]);
+
+			// Cross product is twice the area, in the direction the triangle faces - so
+			//  summing them up weighs bigger triangles more
+			Vec3 cross = Vec3::Cross(b - a, c - a);
+			float triArea = cross.Magnitude();
+			center += (a + b + c) * (triArea / 3.f);
+			normal += cross;
+			area += triArea;
+		}
+
+		float normalLength = normal.Magnitude();
+		order[cluster].Cluster = cluster;
+		order[cluster].Occlusion = (area > 0.f && normalLength > 0.f)
+			? outward * Vec3::Dot(center * (1.f / area) - meshCenter, normal * (1.f / normalLength))
+			: -FLT_MAX; // Nothing but slivers, so it can't hide anything
+	}
+
+	std::stable_sort(order.begin(), order.end(), [](const ClusterOrder& l, const ClusterOrder& r) {
+		return l.Occlusion > r.Occlusion;
+	});
+
+	std::uint32_t* next = out;
+	for (auto&& cluster : order)
+	{
+		const std::uint32_t* first = &source[clusterStarts[cluster.Cluster] * 3u];
+		const std::uint32_t* last = &source[0] + clusterStarts[cluster.Cluster + 1u] * 3u;
+		next = std::copy(first, last, next);
+	}
+}
+
+VertexFetchStats AnalyzeVertexFetch(const std::uint32_t* indices, std::size_t indexCount, std::size_t vertexCount, std::size_t vertexSize)
+{
+	VertexFetchStats stats = { 0.f, 0u, 0u };
+	if (indexCount == 0u || vertexCount == 0u)
+	{
+		return stats;
+	}
+
+	FifoCache vertexCache(vertexCount, VERTEX_CACHE_SIZE);
+	FifoCache lineCache((vertexCount * vertexSize + FETCH_CACHE_LINE_SIZE - 1u) / FETCH_CACHE_LINE_SIZE, FETCH_CACHE_LINES);
+	std::vector<bool> used(vertexCount, false);
+	std::uint32_t linesFetched = 0u;
+	std::uint32_t verticesUsed = 0u;
+
+	for (std::size_t i = 0u; i < indexCount; i++)
+	{
+		std::uint32_t vertex = indices[i];
+		if (!used[vertex])
+		{
+			used[vertex] = true;
+			verticesUsed++;
+		}
+
+		// Already shaded vertices don't get fetched again
+		if (vertexCache.Touch(vertex) == 0u)
+		{
+			continue;
+		}
+
+		// A vertex can straddle two (or more, if it's big) lines
+		std::size_t firstLine = (vertex * vertexSize) / FETCH_CACHE_LINE_SIZE;
+		std::size_t lastLine = (vertex * vertexSize + vertexSize - 1u) / FETCH_CACHE_LINE_SIZE;
+		for (std::size_t line = firstLine; line <= lastLine; line++)
+		{
+			linesFetched += lineCache.Touch(static_cast<std::uint32_t>(line));
+		}
+	}
+
+	stats.BytesUsed = static_cast<std::uint32_t>(verticesUsed * vertexSize);
+	stats.BytesFetched = linesFetched * FETCH_CACHE_LINE_SIZE;
+	stats.Efficiency = float(stats.BytesUsed) / float(stats.BytesFetched);
+	return stats;
+}
+
+std::size_t OptimizeVertexFetch(void* vertices, std::size_t vertexSize, std::size_t vertexCount, std::uint32_t* indices, std::size_t indexCount)
+{
+	// Where every old vertex ends up - handed out in the order the indices get to them
+	std::vector<std::uint32_t> remap(vertexCount, UINT32_MAX);
+	std::uint32_t nextVertex = 0u;
+	for (std::size_t i = 0u; i < indexCount; i++)
+	{
+		std::uint32_t& newIndex = remap[indices[i]];
+		if (newIndex == UINT32_MAX)
+		{
+			newIndex = nextVertex++;
+		}
+		indices[i] = newIndex;
+	}
+
+	// Bytes only, so it works for any vertex type (they're all trivially copyable)
+	std::vector<std::uint8_t> original(static_cast<const std::uint8_t*>(vertices), static_cast<const std::uint8_t*>(vertices) + vertexCount * vertexSize);
+	std::uint8_t* out = static_cast<std::uint8_t*>(vertices);
+	for (std::size_t vertex = 0u; vertex < vertexCount; vertex++)
+	{
+		if (remap[vertex] != UINT32_MAX)
+		{
+			memcpy(out + remap[vertex] * vertexSize, &original[vertex * vertexSize], vertexSize);
+		}
+	}
+
+	return nextVertex;
+}
+
+};
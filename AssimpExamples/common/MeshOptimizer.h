@@ -0,0 +1,108 @@
+#pragma once
+
+// Mesh optimization passes that run on cooked index arrays, after Assimp is done with them.
+// Assimp's aiProcess_ImproveCacheLocality does some of this already, but what exactly it
+//  does depends on the Assimp version, and it doesn't say how well it worked. These do the
+//  same kind of job in a way we control, and come with numbers to check them against.
+//
+// Vertex cache: after the vertex shader runs on a vertex, the GPU keeps the result around
+//  for a little while in case the next few triangles use it too. Triangles that share
+//  vertices should be drawn close together, so that happens as often as possible.
+//  - ACMR (average cache miss ratio): vertex shader runs per triangle. 3 is the worst it
+//    can be (every vertex of every triangle is shaded), ~0.5 is about the best a regular
+//    grid can get.
+//  - ATVR (average transformed vertex ratio): vertex shader runs per vertex. 1 means every
+//    vertex only gets shaded once, which is as good as it gets.
+// ACMR depends on how much vertex sharing a mesh has to begin with, ATVR doesn't - so ATVR
+//  is the one to compare between meshes.
+//
+// Overdraw: with the depth test on, a pixel only gets shaded again if the new triangle is
+//  in front of what's already there. Drawing the parts of a mesh that hide other parts
+//  first means fewer pixels get shaded just to be covered up again. Which parts those are
+//  depends on where the camera is, but the outside of a mesh (facing away from its middle)
+//  is a good bet from pretty much anywhere.
+//  - Overdraw ratio: pixels shaded per pixel covered. 1 means nothing was ever shaded twice.
+//
+// Vertex fetch: before the vertex shader can run, the vertex has to be read from memory,
+//  and memory comes in cache lines. If the vertices are in the same order the triangles
+//  use them in, every line that gets read is used all the way through.
+//  - Fetch efficiency: bytes of vertices needed / bytes of cache lines read. 1 is perfect.
+
+#include <cstddef>
+#include <cstdint>
+
+namespace sess
+{
+
+// Vertices the post-transform cache is simulated with when measuring. Real hardware
+//  doesn't really have a fixed size FIFO anymore, but 16 is the usual stand-in and the
+//  numbers still go up and down with the real thing.
+constexpr std::uint32_t VERTEX_CACHE_SIZE = 16u;
+
+// The memory cache vertex fetches are simulated with - 64 byte lines, 16KB all together,
+//  roughly what a GPU has close to its vertex fetch units
+constexpr std::uint32_t FETCH_CACHE_LINE_SIZE = 64u;
+constexpr std::uint32_t FETCH_CACHE_LINES = 256u;
+
+struct VertexCacheStats
+{
+	float Acmr;
+	float Atvr;
+};
+
+// Simulates drawing the triangles with a FIFO cache of cacheSize vertices. Every index has
+//  to be less than vertexCount.
+VertexCacheStats AnalyzeVertexCache(const std::uint32_t* indices, std::size_t indexCount, std::size_t vertexCount, std::uint32_t cacheSize = VERTEX_CACHE_SIZE);
+
+// Reorders triangles (not vertices - the vertex buffer doesn't change) so neighbours are
+//  drawn close together. Tom Forsyth's "Linear-Speed Vertex Cache Optimisation": every
+//  vertex gets a score for how recently it was used and how many triangles still need it,
+//  and the triangle with the best total goes next.
+// out may be the same array as indices.
+void OptimizeVertexCache(std::uint32_t* out, const std::uint32_t* indices, std::size_t indexCount, std::size_t vertexCount);
+
+struct OverdrawStats
+{
+	float Overdraw; // Pixels shaded / pixels covered, over every view
+	std::uint32_t PixelsCovered;
+	std::uint32_t PixelsShaded;
+};
+
+// Renders the depth of the mesh from the six sides of its bounding box (no GPU involved),
+//  in the order the triangles are in, and counts how many pixels pass the depth test.
+//  Triangles aren't backface culled, since which side is the front depends on the shader.
+// Positions are 3 floats each, positionStride bytes apart - so a vertex buffer can be
+//  passed in as is, with the stride being the size of its vertex type.
+OverdrawStats AnalyzeOverdraw(const std::uint32_t* indices, std::size_t indexCount, const float* positions, std::size_t positionStride, std::size_t vertexCount);
+
+// Reorders triangles so the ones most likely to hide others get drawn first. Indices
+//  should already be through OptimizeVertexCache - the triangles are cut into clusters
+//  where the vertex cache would have to start over anyway, and then (as long as the ACMR
+//  stays under threshold times what it was) into smaller clusters still. The clusters
+//  then get sorted by how much they face out from the middle of the mesh.
+//  (Sander, Nehab and Barczak, "Fast Triangle Reordering for Vertex Locality and Reduced
+//  Overdraw")
+// threshold 1.05 lets the ACMR get 5% worse, which gives most of the overdraw win.
+//  Anything below 1 keeps only the clusters the cache order already had.
+// Only for opaque meshes - anything that's blended needs back to front instead.
+// out may be the same array as indices.
+void OptimizeOverdraw(std::uint32_t* out, const std::uint32_t* indices, std::size_t indexCount, const float* positions, std::size_t positionStride, std::size_t vertexCount, float threshold);
+
+struct VertexFetchStats
+{
+	float Efficiency; // BytesUsed / BytesFetched
+	std::uint32_t BytesUsed; // Every vertex the triangles use, once
+	std::uint32_t BytesFetched; // Every cache line read, every time it's read
+};
+
+// Simulates reading the vertices (vertexSize bytes each) for every vertex cache miss,
+//  through a FIFO cache of FETCH_CACHE_LINES lines
+VertexFetchStats AnalyzeVertexFetch(const std::uint32_t* indices, std::size_t indexCount, std::size_t vertexCount, std::size_t vertexSize);
+
+// Moves vertices (vertexSize bytes each, any layout) into the order the indices first use
+//  them in, and rewrites the indices to match. Vertices nothing uses get dropped - returns
+//  how many are left, which is how many to keep. Run this last, after anything else that
+//  reorders triangles, since it's the triangle order it follows.
+std::size_t OptimizeVertexFetch(void* vertices, std::size_t vertexSize, std::size_t vertexCount, std::uint32_t* indices, std::size_t indexCount);
+
+};
@@ -0,0 +1,347 @@
+#include <MeshSimplifier.h>
+#include <Vec3.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace sess
+{
+
+namespace
+{
+
+// The sum of a bunch of (weighted) planes, as a symmetric 4x4 matrix. For a point p, (p, 1)
+//  times the matrix times (p, 1) is the sum of the squared distances from p to every plane.
+struct Quadric
+{
+	double a2, ab, ac, ad;
+	double b2, bc, bd;
+	double c2, cd;
+	double d2;
+	double Weight;
+
+	// Plane ax + by + cz + d = 0, with (a, b, c) unit length
+	void AddPlane(double a, double b, double c, double d, double weight)
+	{
+		a2 += weight * a * a; ab += weight * a * b; ac += weight * a * c; ad += weight * a * d;
+		b2 += weight * b * b; bc += weight * b * c; bd += weight * b * d;
+		c2 += weight * c * c; cd += weight * c * d;
+		d2 += weight * d * d;
+		Weight += weight;
+	}
+
+	void Add(const Quadric& o)
+	{
+		a2 += o.a2; ab += o.ab; ac += o.ac; ad += o.ad;
+		b2 += o.b2; bc += o.bc; bd += o.bd;
+		c2 += o.c2; cd += o.cd;
+		d2 += o.d2;
+		Weight += o.Weight;
+	}
+
+	// Squared distance from p to the planes, averaged by weight - so it's in the same units
+	//  as the positions (squared) no matter how big the triangles were
+	double Error(const Vec3& p) const
+	{
+		double x = p.x, y = p.y, z = p.z;
+		double e = a2 * x * x + 2.0 * ab * x * y + 2.0 * ac * x * z + 2.0 * ad * x
+			+ b2 * y * y + 2.0 * bc * y * z + 2.0 * bd * y
+			+ c2 * z * z + 2.0 * cd * z
+			+ d2;
+
+		// Rounding can take it a hair below 0
+		return (Weight > 0.0) ? std::max(e, 0.0) / Weight : 0.0;
+	}
+};
+
+// Collapses that turn a triangle by more than about 75 degrees are off the table - and so
+//  are ones that squash it flat without getting rid of it, like moving a vertex onto the
+//  other side of a seam
+constexpr float FLIP_COS = 0.25f;
+
+// Moving From onto To (and removing every triangle that had both)
+struct Collapse
+{
+	std::uint32_t From;
+	std::uint32_t To;
+	double Error;
+};
+
+Vec3 PositionAt(const float* positions, std::size_t positionStride, std::uint32_t vertex)
+{
+	const float* p = reinterpret_cast<const float*>(reinterpret_cast<const std::uint8_t*>(positions) + vertex * positionStride);
+	return Vec3(p[0u], p[1u], p[2u]);
+}
+
+// Works out which vertices can't move (see MeshSimplifier.h)
+std::vector<bool> FindLockedVertices(const std::uint32_t* indices, std::size_t indexCount, const float* positions, std::size_t positionStride, std::size_t vertexCount)
+{
+	// Vertices at the same position get the same id - the lowest vertex index among them.
+	//  Sorted instead of hashed, so exactly equal floats are all that counts.
+	std::vector<std::uint32_t> byPosition(vertexCount);
+	for (std::uint32_t vertex = 0u; vertex < vertexCount; vertex++)
+	{
+		byPosition[vertex] = vertex;
+	}
+	std::sort(byPosition.begin(), byPosition.end(), [positions, positionStride](std::uint32_t l, std::uint32_t r) {
+		Vec3 pl = PositionAt(positions, positionStride, l);
+		Vec3 pr = PositionAt(positions, positionStride, r);
+		if (pl.x != pr.x) return pl.x < pr.x;
+		if (pl.y != pr.y) return pl.y < pr.y;
+		if (pl.z != pr.z) return pl.z < pr.z;
+		return l < r;
+	});
+	auto samePosition = [positions, positionStride](std::uint32_t l, std::uint32_t r) {
+		Vec3 pl = PositionAt(positions, positionStride, l);
+		Vec3 pr = PositionAt(positions, positionStride, r);
+		return pl.x == pr.x && pl.y == pr.y && pl.z == pr.z;
+	};
+
+	std::vector<std::uint32_t> positionId(vertexCount);
+	std::vector<bool> locked(vertexCount, false);
+	for (std::size_t i = 0u; i < vertexCount;)
+	{
+		std::size_t end = i + 1u;
+		while (end < vertexCount && samePosition(byPosition[i], byPosition[end]))
+		{
+			end++;
+		}
+		for (std::size_t j = i; j < end; j++)
+		{
+			positionId[byPosition[j]] = byPosition[i];
+			locked[byPosition[j]] = (end - i > 1u); // A seam
+		}
+		i = end;
+	}
+
+	// Every edge, by position, with the smaller id first. An edge that isn't there exactly
+	//  twice is a border (once) or something stranger (three or more) - either way, hands off.
+	std::vector<std::uint64_t> edges;
+	edges.reserve(indexCount);
+	for (std::size_t tri = 0u; tri + 2u < indexCount; tri += 3u)
+	{
+		for (std::uint32_t corner = 0u; corner < 3u; corner++)
+		{
+			std::uint32_t a = positionId[indices[tri + corner]];
+			std::uint32_t b = positionId[indices[tri + (corner + 1u) % 3u]];
+			if (a != b)
+			{
+				edges.push_back((std::uint64_t(std::min(a, b)) << 32u) | std::max(a, b));
+			}
+		}
+	}
+	std::sort(edges.begin(), edges.end());
+
+	std::vector<bool> lockedPosition(vertexCount, false);
+	for (std::size_t i = 0u; i < edges.size();)
+	{
+		std::size_t end = i + 1u;
+		while (end < edges.size() && edges[end] == edges[i])
+		{
+			end++;
+		}
+		if (end - i != 2u)
+		{
+			lockedPosition[edges[i] >> 32u] = true;
+			lockedPosition[edges[i] & 0xFFFFFFFFu] = true;
+		}
+		i = end;
+	}
+
+	for (std::uint32_t vertex = 0u; vertex < vertexCount; vertex++)
+	{
+		if (lockedPosition[positionId[vertex]])
+		{
+			locked[vertex] = true;
+		}
+	}
+
+	return locked;
+}
+
+};
+
+std::size_t SimplifyMesh(std::uint32_t* out, const std::uint32_t* indices, std::size_t indexCount, const float* positions, std::size_t positionStride, std::size_t vertexCount, std::size_t targetIndexCount, float* error)
+{
+	std::vector<std::uint32_t> current(indices, indices + (indexCount / 3u) * 3u);
+	double maxError = 0.0;
+
+	if (current.size() > targetIndexCount && vertexCount > 0u)
+	{
+		std::vector<bool> locked = FindLockedVertices(current.data(), current.size(), positions, positionStride, vertexCount);
+
+		// Every vertex starts with the planes of the triangles around it, weighted by area so
+		//  a sliver doesn't count as much as a big flat face
+		std::vector<Quadric> quadrics(vertexCount, Quadric());
+		for (std::size_t tri = 0u; tri < current.size(); tri += 3u)
+		{
+			Vec3 a = PositionAt(positions, positionStride, current[tri + 0u]);
+			Vec3 b = PositionAt(positions, positionStride, current[tri + 1u]);
+			Vec3 c = PositionAt(positions, positionStride, current[tri + 2u]);
+			Vec3 normal = Vec3::Cross(b - a, c - a);
+			float doubleArea = normal.Magnitude();
+			if (doubleArea <= 0.f)
+			{
+				continue;
+			}
+			normal = normal * (1.f / doubleArea);
+
+			for (std::uint32_t corner = 0u; corner < 3u; corner++)
+			{
+				quadrics[current[tri + corner]].AddPlane(normal.x, normal.y, normal.z, -Vec3::Dot(normal, a), doubleArea * 0.5f);
+			}
+		}
+
+		std::vector<std::uint32_t> firstTriangle(vertexCount + 1u);
+		std::vector<std::uint32_t> adjacency;
+		std::vector<Collapse> collapses;
+		std::vector<bool> touched(vertexCount);
+		std::vector<std::uint32_t> remap(vertexCount);
+
+		// Each pass collapses as many edges as it can without two collapses touching the same
+		//  triangles, cheapest first. Anything that did touch has to wait for the next pass,
+		//  when its cost has been worked out again with the new neighbours.
+		while (current.size() > targetIndexCount)
+		{
+			// Which triangles use each vertex - vertex v's are adjacency[firstTriangle[v]]
+			//  up to adjacency[firstTriangle[v + 1]]
+			std::fill(firstTriangle.begin(), firstTriangle.end(), 0u);
+			for (std::uint32_t vertex : current)
+			{
+				firstTriangle[vertex + 1u]++;
+			}
+			for (std::size_t vertex = 0u; vertex < vertexCount; vertex++)
+			{
+				firstTriangle[vertex + 1u] += firstTriangle[vertex];
+			}
+			adjacency.resize(current.size());
+			std::vector<std::uint32_t> filled(firstTriangle.begin(), firstTriangle.end() - 1);
+			for (std::size_t i = 0u; i < current.size(); i++)
+			{
+				adjacency[filled[current[i]]++] = static_cast<std::uint32_t>(i / 3u);
+			}
+
+			// Both directions of every edge, unless the vertex that would move is locked.
+			//  Edges inside the mesh show up twice (once per triangle), that's fine - the
+			//  second one just finds its vertices already touched.
+			collapses.clear();
+			for (std::size_t tri = 0u; tri < current.size(); tri += 3u)
+			{
+				for (std::uint32_t corner = 0u; corner < 3u; corner++)
+				{
+					std::uint32_t a = current[tri + corner];
+					std::uint32_t b = current[tri + (corner + 1u) % 3u];
+					if (!locked[a])
+					{
+						collapses.push_back({ a, b, quadrics[a].Error(PositionAt(positions, positionStride, b)) });
+					}
+					if (!locked[b])
+					{
+						collapses.push_back({ b, a, quadrics[b].Error(PositionAt(positions, positionStride, a)) });
+					}
+				}
+			}
+			std::sort(collapses.begin(), collapses.end(), [](const Collapse& l, const Collapse& r) { return l.Error < r.Error; });
+
+			// Every collapse gets rid of about two triangles
+			std::size_t wanted = (current.size() - targetIndexCount) / 6u + 1u;
+			std::size_t done = 0u;
+			std::fill(touched.begin(), touched.end(), false);
+			for (std::uint32_t vertex = 0u; vertex < vertexCount; vertex++)
+			{
+				remap[vertex] = vertex;
+			}
+
+			for (auto&& collapse : collapses)
+			{
+				if (done >= wanted)
+				{
+					break;
+				}
+				if (touched[collapse.From] || touched[collapse.To])
+				{
+					continue;
+				}
+
+				// Moving From onto To can't turn any of From's other triangles inside out - or
+				//  even most of the way there, since a few collapses in a row that each turn a
+				//  triangle a bit add up
+				Vec3 to = PositionAt(positions, positionStride, collapse.To);
+				bool flips = false;
+				for (std::uint32_t i = firstTriangle[collapse.From]; i < firstTriangle[collapse.From + 1u] && !flips; i++)
+				{
+					const std::uint32_t* tri = &current[adjacency[i] * 3u];
+					if (tri[0u] == collapse.To || tri[1u] == collapse.To || tri[2u] == collapse.To)
+					{
+						continue; // Goes away entirely
+					}
+
+					Vec3 corners[3];
+					for (std::uint32_t corner = 0u; corner < 3u; corner++)
+					{
+						corners[corner] = PositionAt(positions, positionStride, tri[corner]);
+					}
+					Vec3 before = Vec3::Cross(corners[1u] - corners[0u], corners[2u] - corners[0u]);
+					for (std::uint32_t corner = 0u; corner < 3u; corner++)
+					{
+						if (tri[corner] == collapse.From)
+						{
+							corners[corner] = to;
+						}
+					}
+					Vec3 after = Vec3::Cross(corners[1u] - corners[0u], corners[2u] - corners[0u]);
+					flips = Vec3::Dot(before, after) <= FLIP_COS * before.Magnitude() * after.Magnitude();
+				}
+				if (flips)
+				{
+					continue;
+				}
+
+				// From's whole neighbourhood changes shape, so nothing around it gets to
+				//  collapse again until the next pass
+				for (std::uint32_t i = firstTriangle[collapse.From]; i < firstTriangle[collapse.From + 1u]; i++)
+				{
+					const std::uint32_t* tri = &current[adjacency[i] * 3u];
+					touched[tri[0u]] = touched[tri[1u]] = touched[tri[2u]] = true;
+				}
+
+				remap[collapse.From] = collapse.To;
+				quadrics[collapse.To].Add(quadrics[collapse.From]);
+				maxError = std::max(maxError, collapse.Error);
+				done++;
+			}
+
+			if (done == 0u)
+			{
+				break; // Everything left is locked or would fold over
+			}
+
+			// Apply the collapses, and drop the triangles that got squashed flat
+			std::size_t kept = 0u;
+			for (std::size_t tri = 0u; tri < current.size(); tri += 3u)
+			{
+				std::uint32_t a = remap[current[tri + 0u]];
+				std::uint32_t b = remap[current[tri + 1u]];
+				std::uint32_t c = remap[current[tri + 2u]];
+				if (a != b && b != c && c != a)
+				{
+					current[kept++] = a;
+					current[kept++] = b;
+					current[kept++] = c;
+				}
+			}
+			current.resize(kept);
+		}
+	}
+
+	if (error != nullptr)
+	{
+		*error = static_cast<float>(sqrt(maxError));
+	}
+
+	std::copy(current.begin(), current.end(), out);
+	return current.size();
+}
+
+};
@@ -0,0 +1,35 @@
+#pragma once
+
+// Mesh simplification - fewer triangles that still look like the same mesh, for drawing
+//  things that are far enough away that the extra detail would all land in the same few
+//  pixels anyways.
+// Garland and Heckbert's quadric error metric ("Surface Simplification Using Quadric Error
+//  Metrics"): every vertex keeps track of the planes of the triangles around it, and the
+//  cost of moving it somewhere is how far that is from all of those planes. The cheapest
+//  edges get collapsed first, until there are few enough triangles left.
+//
+// Edges collapse onto one of their own vertices instead of somewhere in between, so every
+//  simplified mesh only uses vertices the full detail mesh already has. That way all of a
+//  mesh's LODs can share one vertex buffer, and only the index buffer changes.
+//
+// Some vertices never move:
+//  - Border vertices (on an edge with only one triangle) - that's where one aiMesh ends and
+//    the next one starts, usually because the material changes. Moving them opens cracks.
+//  - Seam vertices (same position as another vertex) - that's where the UVs or normals
+//    jump, and moving one side of the seam without the other tears the texture.
+
+#include <cstddef>
+#include <cstdint>
+
+namespace sess
+{
+
+// Simplifies the triangles in indices down to about targetIndexCount indices, and writes
+//  them to out (which needs room for indexCount indices, and may be the same array).
+//  Returns how many indices it wrote - more than targetIndexCount if the locked vertices
+//  didn't leave enough to collapse.
+// Positions are 3 floats each, positionStride bytes apart. error (if not null) gets how far
+//  the simplified mesh is from the original, in the same units as the positions.
+std::size_t SimplifyMesh(std::uint32_t* out, const std::uint32_t* indices, std::size_t indexCount, const float* positions, std::size_t positionStride, std::size_t vertexCount, std::size_t targetIndexCount, float* error);
+
+};
@@ -0,0 +1,278 @@
+#include <Meshlets.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace sess
+{
+
+namespace
+{
+
+// Widest cone (cosine between its axis and its widest triangle) still worth testing.
+//  Anything wider than about 84 degrees only gets culled from so few places that it's not
+//  worth the test.
+constexpr float MIN_CONE_COS = 0.1f;
+
+Vec3 PositionAt(const float* positions, std::size_t positionStride, std::uint32_t vertex)
+{
+	const float* p = reinterpret_cast<const float*>(reinterpret_cast<const std::uint8_t*>(positions) + vertex * positionStride);
+	return Vec3(p[0u], p[1u], p[2u]);
+}
+
+// Bounds and cone for a meshlet made of the given triangles (still in their original
+//  places in indices). triangleNormals has the unit normal of every triangle in the mesh,
+//  or zero for degenerate ones.
+void ComputeMeshletBounds(Meshlet& meshlet, const std::vector<std::uint32_t>& triangles, const std::uint32_t* indices, const float* positions, std::size_t positionStride, const std::vector<Vec3>& triangleNormals)
+{
+	// Never happens for a meshlet that gets kept, but there'd be nothing to bound
+	if (triangles.empty())
+	{
+		meshlet.Sphere = BoundingSphere::Empty();
+		meshlet.ConeAxis = Vec3::Zero;
+		meshlet.ConeCutoff = 1.f;
+		return;
+	}
+
+	// Every corner of every triangle - duplicates don't change the sphere, and it's at most
+	//  3 * MAX_MESHLET_TRIANGLES points
+	float xyz[MAX_MESHLET_TRIANGLES * 3u * 3u];
+	Vec3 axis = Vec3::Zero;
+	for (std::size_t triIdx = 0u; triIdx < triangles.size(); triIdx++)
+	{
+		for (std::uint32_t corner = 0u; corner < 3u; corner++)
+		{
+			Vec3 p = PositionAt(positions, positionStride, indices[triangles[triIdx] * 3u + corner]);
+			xyz[(triIdx * 3u + corner) * 3u + 0u] = p.x;
+			xyz[(triIdx * 3u + corner) * 3u + 1u] = p.y;
+			xyz[(triIdx * 3u + corner) * 3u + 2u] = p.z;
+		}
+		axis += triangleNormals[triangles[triIdx]];
+	}
+	meshlet.Sphere = BoundingSphere::FromPoints(xyz, triangles.size() * 3u);
+
+	// Widest angle between the average facing and any one triangle. Degenerate triangles
+	//  have no facing, and never get drawn anyways.
+	float axisLength = axis.Magnitude();
+	float minCos = 1.f;
+	if (axisLength > 0.f)
+	{
+		axis = axis * (1.f / axisLength);
+		for (std::uint32_t tri : triangles)
+		{
+			const Vec3& normal = triangleNormals[tri];
+			if (normal.x != 0.f || normal.y != 0.f || normal.z != 0.f)
+			{
+				minCos = std::min(minCos, Vec3::Dot(normal, axis));
+			}
+		}
+	}
+
+	meshlet.ConeAxis = axis;
+	meshlet.ConeCutoff = (axisLength > 0.f && minCos > MIN_CONE_COS) ? sqrtf(1.f - minCos * minCos) : 1.f;
+}
+
+}
+
+std::vector<Meshlet> BuildMeshlets(std::uint32_t* indices, std::size_t indexCount, const float* positions, std::size_t positionStride, std::size_t vertexCount)
+{
+	const std::uint32_t triangleCount = static_cast<std::uint32_t>(indexCount / 3u);
+
+	// Which triangles use each vertex - offsets into one big list, same as OptimizeVertexCache
+	std::vector<std::uint32_t> adjacencyOffsets(vertexCount + 1u, 0u);
+	for (std::size_t i = 0u; i < triangleCount * 3u; i++)
+	{
+		adjacencyOffsets[indices[i] + 1u]++;
+	}
+	for (std::size_t v = 0u; v < vertexCount; v++)
+	{
+		adjacencyOffsets[v + 1u] += adjacencyOffsets[v];
+	}
+	std::vector<std::uint32_t> adjacency(triangleCount * 3u);
+	std::vector<std::uint32_t> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1u);
+	for (std::uint32_t tri = 0u; tri < triangleCount; tri++)
+	{
+		for (std::uint32_t corner = 0u; corner < 3u; corner++)
+		{
+			adjacency[fill[indices[tri * 3u + corner]]++] = tri;
+		}
+	}
+
+	// Cross product of the edges points towards the camera for triangles that are clockwise
+	//  on screen (left handed, looking down +z)
+	std::vector<Vec3> triangleNormals(triangleCount, Vec3::Zero);
+	for (std::uint32_t tri = 0u; tri < triangleCount; tri++)
+	{
+		Vec3 a = PositionAt(positions, positionStride, indices[tri * 3u + 0u]);
+		Vec3 b = PositionAt(positions, positionStride, indices[tri * 3u + 1u]);
+		Vec3 c = PositionAt(positions, positionStride, indices[tri * 3u + 2u]);
+		Vec3 normal = Vec3::Cross(b - a, c - a);
+		float length = normal.Magnitude();
+		if (length > 0.f)
+		{
+			triangleNormals[tri] = normal * (1.f / length);
+		}
+	}
+
+	std::vector<Meshlet> meshlets;
+	std::vector<std::uint32_t> reordered;
+	reordered.reserve(triangleCount * 3u);
+	std::vector<bool> emitted(triangleCount, false);
+
+	// Where each vertex is in the meshlet being built, or -1 if it isn't in it
+	std::vector<std::int8_t> meshletSlot(vertexCount, -1);
+	std::uint32_t meshletVertices[MAX_MESHLET_VERTICES];
+	std::vector<std::uint32_t> meshletTriangles;
+	meshletTriangles.reserve(MAX_MESHLET_TRIANGLES);
+
+	Meshlet current = {};
+	current.Sphere = BoundingSphere::Empty();
+	Vec3 normalSum = Vec3::Zero;
+	std::uint32_t nextSeed = 0u; // Everything before this has been emitted
+
+	auto newVertices = [&](std::uint32_t tri) {
+		std::uint32_t count = 0u;
+		for (std::uint32_t corner = 0u; corner < 3u; corner++)
+		{
+			count += (meshletSlot[indices[tri * 3u + corner]] < 0) ? 1u : 0u;
+		}
+		return count;
+	};
+
+	auto finishMeshlet = [&]() {
+		current.FirstIndex = static_cast<std::uint32_t>(reordered.size());
+		ComputeMeshletBounds(current, meshletTriangles, indices, positions, positionStride, triangleNormals);
+		for (std::uint32_t tri : meshletTriangles)
+		{
+			reordered.insert(reordered.end(), indices + tri * 3u, indices + tri * 3u + 3u);
+		}
+		meshlets.push_back(current);
+
+		for (std::uint32_t v = 0u; v < current.VertexCount; v++)
+		{
+			meshletSlot[meshletVertices[v]] = -1;
+		}
+		current = {};
+		current.Sphere = BoundingSphere::Empty();
+		normalSum = Vec3::Zero;
+		meshletTriangles.clear();
+	};
+
+	for (std::uint32_t emittedCount = 0u; emittedCount < triangleCount; emittedCount++)
+	{
+		// Best neighbour of what's in the meshlet already: fewest new vertices first (so the
+		//  64 go as far as possible), then facing the same way as the rest
+		std::uint32_t best = triangleCount;
+		std::uint32_t bestNew = 4u;
+		float bestFacing = -2.f;
+		for (std::uint32_t slot = 0u; slot < current.VertexCount; slot++)
+		{
+			std::uint32_t v = meshletVertices[slot];
+			for (std::uint32_t a = adjacencyOffsets[v]; a < adjacencyOffsets[v + 1u]; a++)
+			{
+				std::uint32_t tri = adjacency[a];
+				if (emitted[tri])
+				{
+					continue;
+				}
+				std::uint32_t added = newVertices(tri);
+				float facing = Vec3::Dot(triangleNormals[tri], normalSum);
+				if (current.VertexCount + added <= MAX_MESHLET_VERTICES && (added < bestNew || (added == bestNew && facing > bestFacing)))
+				{
+					best = tri;
+					bestNew = added;
+					bestFacing = facing;
+				}
+			}
+		}
+
+		// Nothing left next to it (or nothing that fits) - the meshlet is done, and the next
+		//  one starts at the first triangle that's left, which keeps the triangles roughly in
+		//  the order the vertex cache pass put them in
+		if (best == triangleCount)
+		{
+			if (current.TriangleCount > 0u)
+			{
+				finishMeshlet();
+			}
+			while (emitted[nextSeed])
+			{
+				nextSeed++;
+			}
+			best = nextSeed;
+		}
+
+		emitted[best] = true;
+		meshletTriangles.push_back(best);
+		current.TriangleCount++;
+		normalSum += triangleNormals[best];
+		for (std::uint32_t corner = 0u; corner < 3u; corner++)
+		{
+			std::uint32_t v = indices[best * 3u + corner];
+			if (meshletSlot[v] < 0)
+			{
+				meshletSlot[v] = static_cast<std::int8_t>(current.VertexCount);
+				meshletVertices[current.VertexCount++] = v;
+			}
+		}
+
+		if (current.TriangleCount == MAX_MESHLET_TRIANGLES)
+		{
+			finishMeshlet();
+		}
+	}
+	if (current.TriangleCount > 0u)
+	{
+		finishMeshlet();
+	}
+
+	// Indices were only read from until now, so the meshlets can go over them in one go
+	std::copy(reordered.begin(), reordered.end(), indices);
+	return meshlets;
+}
+
+std::size_t CullMeshlets(const Meshlet* meshlets, std::size_t meshletCount, const Frustum& frustum, const Vec3* cameraPosition, VisibilitySet& out)
+{
+	out.Reset(meshletCount);
+	std::size_t visibleCount = 0u;
+	for (std::size_t meshletIdx = 0u; meshletIdx < meshletCount; meshletIdx++)
+	{
+		// The cone test is cheaper, and off to the sides of the camera most meshlets are
+		//  inside the frustum anyways
+		const Meshlet& meshlet = meshlets[meshletIdx];
+		if (cameraPosition && IsMeshletBackfacing(meshlet, *cameraPosition))
+		{
+			continue;
+		}
+		if (frustum.Intersects(meshlet.Sphere))
+		{
+			out.SetVisible(meshletIdx, true);
+			visibleCount++;
+		}
+	}
+	return visibleCount;
+}
+
+void GatherVisibleRanges(const Meshlet* meshlets, std::size_t meshletCount, const VisibilitySet& visible, std::vector<IndexRange>& out)
+{
+	out.clear();
+	for (std::size_t meshletIdx = 0u; meshletIdx < meshletCount; meshletIdx++)
+	{
+		if (!visible.IsVisible(meshletIdx))
+		{
+			continue;
+		}
+
+		const Meshlet& meshlet = meshlets[meshletIdx];
+		if (!out.empty() && out.back().FirstIndex + out.back().IndexCount == meshlet.FirstIndex)
+		{
+			out.back().IndexCount += meshlet.TriangleCount * 3u;
+		}
+		else
+		{
+			out.push_back({ meshlet.FirstIndex, meshlet.TriangleCount * 3u });
+		}
+	}
+}
+
+};
@@ -0,0 +1,79 @@
+#pragma once
+
+// Meshlets - a mesh cut up into small clusters of neighbouring triangles, each with bounds
+//  of its own. Culling a whole mesh is all or nothing: the road is on screen somewhere
+//  pretty much always, so all of it gets drawn, including the parts behind the camera.
+//  Culling meshlets skips most of that.
+//
+// Every meshlet gets two things to cull with:
+//  - A bounding sphere, tested against the view frustum like any other bounds
+//  - A normal cone - every triangle in the meshlet faces within some angle of its axis. If
+//    the camera is behind all of them (see IsMeshletBackfacing), every triangle would get
+//    backface culled anyways, so the GPU doesn't have to even look at them.
+// Neighbouring triangles mostly face about the same way, which is what makes the cones
+//  narrow enough to be useful - so triangles get picked by who they share vertices with,
+//  and then by how close their normal is to the rest of the meshlet's.
+//
+// Meshlets here are just runs of triangles in the mesh's own index buffer - no mesh shaders
+//  in D3D11 - so drawing the ones that survive is a DrawIndexed per run of them (see
+//  GatherVisibleRanges, which merges runs that are next to each other).
+// Based on the clusterization in Arseny Kapoulkine's meshoptimizer, with the sizes it
+//  recommends for NVIDIA's mesh shaders (64 vertices, 124 triangles).
+
+#include <Frustum.h>
+#include <VisibilitySet.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace sess
+{
+
+constexpr std::uint32_t MAX_MESHLET_VERTICES = 64u;
+constexpr std::uint32_t MAX_MESHLET_TRIANGLES = 124u;
+
+struct Meshlet
+{
+	std::uint32_t FirstIndex; // Where its triangles start in the mesh's index buffer
+	std::uint32_t TriangleCount;
+	std::uint32_t VertexCount; // Distinct vertices its triangles use
+	BoundingSphere Sphere; // Model space, like the positions it was built from
+	Vec3 ConeAxis; // Average facing of the triangles
+	float ConeCutoff; // Sine of the angle between the axis and the widest triangle - 1 if it can't be culled
+};
+
+// Cuts the triangles up into meshlets, and reorders indices (in place) so each meshlet's
+//  triangles are next to each other. Vertices don't move - OptimizeVertexFetch can be run
+//  again afterwards to put them back in the order the triangles now use them in.
+// Positions are 3 floats each, positionStride bytes apart, same as MeshOptimizer.h.
+// Triangles are front facing when they're clockwise on screen, same as the demos' rasterizer.
+std::vector<Meshlet> BuildMeshlets(std::uint32_t* indices, std::size_t indexCount, const float* positions, std::size_t positionStride, std::size_t vertexCount);
+
+// True if every triangle in the meshlet faces away from the camera, from anywhere in its
+//  bounding sphere. Camera position is in model space.
+inline bool IsMeshletBackfacing(const Meshlet& meshlet, const Vec3& cameraPosition)
+{
+	Vec3 toCenter = meshlet.Sphere.Center - cameraPosition;
+	return Vec3::Dot(toCenter, meshlet.ConeAxis) >= meshlet.ConeCutoff * toCenter.Magnitude() + meshlet.Sphere.Radius;
+}
+
+// Sets a bit in out for every meshlet that's inside the frustum and not backfacing.
+//  Everything is in model space - the frustum should be built from model * view * projection.
+//  cameraPosition can be null to skip the backface test (two sided materials, or a model
+//  transform that mirrors and so flips which side is the front).
+// Returns how many are visible.
+std::size_t CullMeshlets(const Meshlet* meshlets, std::size_t meshletCount, const Frustum& frustum, const Vec3* cameraPosition, VisibilitySet& out);
+
+// A run of indices to draw in one go
+struct IndexRange
+{
+	std::uint32_t FirstIndex;
+	std::uint32_t IndexCount;
+};
+
+// Turns the visible meshlets into as few index ranges as possible - visible meshlets that
+//  are next to each other in the index buffer become one range. out is cleared first.
+void GatherVisibleRanges(const Meshlet* meshlets, std::size_t meshletCount, const VisibilitySet& visible, std::vector<IndexRange>& out);
+
+};
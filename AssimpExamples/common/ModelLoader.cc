@@ -0,0 +1,224 @@
+#include <ModelLoader.h>
+
+#include <assimp/material.h>
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+namespace sess
+{
+
+bool ModelLoaderBase::LoadSource(const AssetPack& assets, const char* fName, AssetData& source)
+{
+	// Out of the asset pack if it's in there, the loose file otherwise
+	if (!assets.Load(fName, source))
+	{
+		std::cerr << "Could not load file " << fName << std::endl;
+		return false;
+	}
+	return true;
+}
+
+const aiScene* ModelLoaderBase::ImportScene(Assimp::Importer& importer, const AssetData& source, const char* fName, const ImportProfile& profile)
+{
+	// The bytes are already in memory (mapped from the pack or the loose file), so Assimp
+	//  doesn't have to touch the file system at all - FBX keeps everything in one file, so
+	//  nothing else has to be found
+	const aiScene* scene = profile.Import(importer, source, fName);
+	if (!scene)
+	{
+		std::cerr << "Could not load file " << fName << ": " << importer.GetErrorString() << std::endl;
+	}
+	return scene;
+}
+
+CookedMaterial ModelLoaderBase::ReadMaterial(const aiScene* scene, const aiMesh* mesh)
+{
+	const aiMaterial* material = scene->mMaterials[mesh->mMaterialIndex];
+	aiColor4D specularColor;
+	aiColor4D diffuseColor;
+	aiColor4D ambientColor;
+	float shininess;
+
+	aiGetMaterialColor(material, AI_MATKEY_COLOR_SPECULAR, &specularColor);
+	aiGetMaterialColor(material, AI_MATKEY_COLOR_DIFFUSE, &diffuseColor);
+	aiGetMaterialColor(material, AI_MATKEY_COLOR_AMBIENT, &ambientColor);
+	aiGetMaterialFloat(material, AI_MATKEY_SHININESS, &shininess);
+
+	return CookedMaterial
+	(
+		Color(specularColor.r, specularColor.g, specularColor.b, shininess), // Specular
+		Color(diffuseColor.r, diffuseColor.g, diffuseColor.b, diffuseColor.a), // Diffuse
+		Color(ambientColor.r, ambientColor.g, ambientColor.b, ambientColor.a) // Ambient
+	);
+}
+
+void ModelLoaderBase::ReadIndices(const aiMesh* mesh, std::vector<std::uint32_t>& indices)
+{
+	// Every profile triangulates and drops lines and points, so it's always 3 per face
+	indices.resize(mesh->mNumFaces * 3u);
+	std::uint32_t* out = indices.data();
+	for (std::uint32_t faceIdx = 0u; faceIdx < mesh->mNumFaces; faceIdx++)
+	{
+		const unsigned int* faceIndices = mesh->mFaces[faceIdx].mIndices;
+		out[faceIdx * 3u + 0u] = faceIndices[0u];
+		out[faceIdx * 3u + 1u] = faceIndices[1u];
+		out[faceIdx * 3u + 2u] = faceIndices[2u];
+	}
+}
+
+Bounds ModelLoaderBase::ReadBounds(const aiMesh* mesh)
+{
+	// aiVector3D is three floats, same as the packed layout FromPoints wants
+	return Bounds::FromPoints(&mesh->mVertices[0].x, mesh->mNumVertices);
+}
+
+void ModelLoaderBase::OptimizeIndices(const aiMesh* mesh, const CookedMaterial& material, const ImportProfile& profile, std::vector<std::uint32_t>& indices, MeshReport& report)
+{
+	const std::uint32_t vertexCount = mesh->mNumVertices;
+	const float* positions = &mesh->mVertices[0].x;
+	report = MeshReport();
+	report.VertexCount = vertexCount;
+	report.TriangleCount = static_cast<std::uint32_t>(indices.size() / 3u);
+
+	report.CacheBefore = AnalyzeVertexCache(indices.data(), indices.size(), vertexCount);
+	if (profile.MeshStats)
+	{
+		report.OverdrawBefore = AnalyzeOverdraw(indices.data(), indices.size(), positions, sizeof(aiVector3D), vertexCount);
+	}
+
+	OptimizeVertexCache(indices.data(), indices.data(), indices.size(), vertexCount);
+
+	// Blended meshes have to be drawn back to front from wherever the camera is, so a fixed
+	//  "outside first" order would be wrong for them
+	float diffuse[4];
+	material.Diffuse.packAsFloatArray(diffuse);
+	if (profile.OverdrawThreshold > 0.f && diffuse[3] >= 1.f)
+	{
+		OptimizeOverdraw(indices.data(), indices.data(), indices.size(), positions, sizeof(aiVector3D), vertexCount, profile.OverdrawThreshold);
+	}
+
+	report.CacheAfter = AnalyzeVertexCache(indices.data(), indices.size(), vertexCount);
+	if (profile.MeshStats)
+	{
+		report.OverdrawAfter = AnalyzeOverdraw(indices.data(), indices.size(), positions, sizeof(aiVector3D), vertexCount);
+	}
+}
+
+void ModelLoaderBase::BuildLods(const aiMesh* mesh, const ImportProfile& profile, std::vector<std::uint32_t>& indices, std::vector<CookedLod>& lods, MeshReport& report)
+{
+	const std::uint32_t fullCount = static_cast<std::uint32_t>(indices.size());
+	lods.assign(1u, CookedLod{ 0u, fullCount, 0.f });
+
+	std::vector<std::uint32_t> simplified(fullCount);
+	for (std::uint32_t lodIdx = 0u; lodIdx < profile.LodCount; lodIdx++)
+	{
+		// Each level starts over from full detail instead of from the level before it, so
+		//  every level's error is measured against what the model is actually supposed to be
+		std::size_t target = std::size_t(fullCount / 3u * profile.LodRatios[lodIdx]) * 3u;
+		float error = 0.f;
+		std::size_t count = SimplifyMesh(simplified.data(), indices.data(), fullCount, &mesh->mVertices[0].x, sizeof(aiVector3D), mesh->mNumVertices, target, &error);
+
+		// Mostly locked vertices (lots of seams, or a small mesh that's all border) can stop
+		//  the simplifier early. A level that isn't at least a bit smaller than the one before
+		//  it isn't worth a draw call of its own.
+		if (count == 0u || count * 10u > lods.back().IndexCount * 9u)
+		{
+			continue;
+		}
+
+		// The vertex cache order got lost along the way - the overdraw order isn't worth
+		//  redoing, from far enough away for this level there isn't much overdraw to save
+		OptimizeVertexCache(simplified.data(), simplified.data(), count, mesh->mNumVertices);
+
+		lods.push_back({ static_cast<std::uint32_t>(indices.size()), static_cast<std::uint32_t>(count), std::max(error, lods.back().Error) });
+		indices.insert(indices.end(), simplified.begin(), simplified.begin() + count);
+	}
+
+	report.Lods = lods;
+}
+
+std::size_t ModelLoaderBase::OptimizeVertices(void* vertices, std::size_t vertexSize, std::size_t vertexCount, std::vector<std::uint32_t>& indices, std::uint32_t fullDetailIndexCount, MeshReport& report)
+{
+	// Has to be last - it follows whatever order the triangles ended up in. Full detail uses
+	//  every vertex any of the LODs do, so that's the order everything gets - and the one
+	//  that gets measured.
+	report.FetchBefore = AnalyzeVertexFetch(indices.data(), fullDetailIndexCount, vertexCount, vertexSize);
+	std::size_t usedVertices = OptimizeVertexFetch(vertices, vertexSize, vertexCount, indices.data(), indices.size());
+	report.FetchAfter = AnalyzeVertexFetch(indices.data(), fullDetailIndexCount, usedVertices, vertexSize);
+	return usedVertices;
+}
+
+void ModelLoaderBase::PrintReport(const char* fName, const std::vector<MeshReport>& reports)
+{
+	// Built up and printed in one go, same as ImportProfile's step timing
+	std::ostringstream report;
+	report << std::fixed << std::setprecision(3);
+	report << "Mesh stats for " << fName << " (vertex cache of " << VERTEX_CACHE_SIZE << "):" << std::endl;
+	report << "  mesh     verts      tris   ACMR before/after   ATVR before/after   overdraw before/after   fetch before/after   LOD tris" << std::endl;
+
+	// Totals are weighted by how many triangles/vertices each mesh has, so they're what
+	//  the whole model would get if it were one big mesh
+	double missesBefore = 0.0;
+	double missesAfter = 0.0;
+	std::uint64_t coveredBefore = 0u, shadedBefore = 0u;
+	std::uint64_t coveredAfter = 0u, shadedAfter = 0u;
+	std::uint64_t usedBefore = 0u, fetchedBefore = 0u;
+	std::uint64_t usedAfter = 0u, fetchedAfter = 0u;
+	std::uint64_t totalVertices = 0u;
+	std::uint64_t totalTriangles = 0u;
+	for (std::size_t meshIdx = 0u; meshIdx < reports.size(); meshIdx++)
+	{
+		const MeshReport& mesh = reports[meshIdx];
+		report << "  " << std::setw(4) << meshIdx
+			<< std::setw(10) << mesh.VertexCount
+			<< std::setw(10) << mesh.TriangleCount
+			<< std::setw(10) << mesh.CacheBefore.Acmr << std::setw(10) << mesh.CacheAfter.Acmr
+			<< std::setw(10) << mesh.CacheBefore.Atvr << std::setw(10) << mesh.CacheAfter.Atvr
+			<< std::setw(12) << mesh.OverdrawBefore.Overdraw << std::setw(10) << mesh.OverdrawAfter.Overdraw
+			<< std::setw(12) << mesh.FetchBefore.Efficiency << std::setw(10) << mesh.FetchAfter.Efficiency
+			<< "   ";
+		for (auto&& lod : mesh.Lods)
+		{
+			report << ((&lod == &mesh.Lods[0u]) ? "" : " / ") << lod.IndexCount / 3u;
+		}
+		report << std::endl;
+
+		missesBefore += double(mesh.CacheBefore.Acmr) * mesh.TriangleCount;
+		missesAfter += double(mesh.CacheAfter.Acmr) * mesh.TriangleCount;
+		totalVertices += mesh.VertexCount;
+		totalTriangles += mesh.TriangleCount;
+		coveredBefore += mesh.OverdrawBefore.PixelsCovered;
+		shadedBefore += mesh.OverdrawBefore.PixelsShaded;
+		coveredAfter += mesh.OverdrawAfter.PixelsCovered;
+		shadedAfter += mesh.OverdrawAfter.PixelsShaded;
+		usedBefore += mesh.FetchBefore.BytesUsed;
+		fetchedBefore += mesh.FetchBefore.BytesFetched;
+		usedAfter += mesh.FetchAfter.BytesUsed;
+		fetchedAfter += mesh.FetchAfter.BytesFetched;
+	}
+
+	if (totalTriangles > 0u)
+	{
+		report << "   all"
+			<< std::setw(10) << totalVertices
+			<< std::setw(10) << totalTriangles
+			<< std::setw(10) << missesBefore / totalTriangles << std::setw(10) << missesAfter / totalTriangles
+			<< std::setw(10) << missesBefore / totalVertices << std::setw(10) << missesAfter / totalVertices
+			<< std::setw(12) << (coveredBefore > 0u ? double(shadedBefore) / coveredBefore : 0.0)
+			<< std::setw(10) << (coveredAfter > 0u ? double(shadedAfter) / coveredAfter : 0.0)
+			<< std::setw(12) << (fetchedBefore > 0u ? double(usedBefore) / fetchedBefore : 0.0)
+			<< std::setw(10) << (fetchedAfter > 0u ? double(usedAfter) / fetchedAfter : 0.0) << std::endl;
+	}
+	std::cout << report.str();
+}
+
+void ModelLoaderBase::PrintLoaded(const char* fName, bool fromCache, const ImportProfile& profile, std::chrono::high_resolution_clock::time_point startTime)
+{
+	float msElapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now() - startTime).count() / 1000.f;
+	std::cout << "Loaded " << fName << (fromCache ? " from mesh cache" : " with Assimp") << " (" << profile.Name << ") in " << msElapsed << "ms" << std::endl;
+}
+
+};
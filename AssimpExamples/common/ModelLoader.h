@@ -0,0 +1,265 @@
+#pragma once
+
+// Model loader - turns a model file into CookedMeshes of any vertex type that has
+//  VertexTraits (see VertexTraits.h). Checks the mesh cache first, imports with Assimp
+//  if that's out of date, and converts every aiMesh on the thread pool.
+//
+// Usage:
+//  std::vector<CookedMesh<MaterialOnlyShader::Vertex>> meshes;
+//  if (ModelLoader<MaterialOnlyShader::Vertex>::Load(assets, "../assets/road.fbx", ImportProfile::OfflineMax, meshes))
+//  {
+//      ... make RenderCalls out of meshes ...
+//  }
+//
+// Every mesh gets its vertex and index arrays sized once, up front, and then each
+//  attribute is copied over the whole mesh in one tight loop - no push_back, no per-vertex
+//  temporaries, no checking which attributes the vertex type has for every vertex.
+//  Compact attributes (see VertexQuantization.h) get encoded in that same loop, with
+//  positions quantized in a cube around the mesh's LocalBounds box.
+//
+// After that, the meshes go through our own optimization passes (see MeshOptimizer.h):
+//  - Triangles get reordered for the vertex cache
+//  - Then in clusters, outside of the mesh first, so less gets drawn over (opaque meshes
+//    only, and only if the import profile has an OverdrawThreshold)
+//  - Simplified LODs get made, if the import profile asks for them (see MeshSimplifier.h)
+//  - Vertices get reordered to match, so they're read from memory front to back
+// Import with ImportProfile::WithMeshStats() to see how much each pass helped.
+
+#include <AssetPack.h>
+#include <ImportProfile.h>
+#include <MeshCache.h>
+#include <MeshOptimizer.h>
+#include <MeshSimplifier.h>
+#include <ThreadPool.h>
+#include <VertexQuantization.h>
+#include <VertexTraits.h>
+
+#include <assimp/Importer.hpp>
+#include <assimp/scene.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+namespace sess
+{
+
+// Everything that doesn't depend on the vertex type, so it only has to be compiled once
+class ModelLoaderBase
+{
+protected:
+	// What the optimization passes did to one mesh
+	struct MeshReport
+	{
+		std::uint32_t VertexCount;
+		std::uint32_t TriangleCount;
+		VertexCacheStats CacheBefore;
+		VertexCacheStats CacheAfter;
+
+		// Only measured for ImportProfile::MeshStats, since it takes a while
+		OverdrawStats OverdrawBefore;
+		OverdrawStats OverdrawAfter;
+
+		VertexFetchStats FetchBefore;
+		VertexFetchStats FetchAfter;
+
+		std::vector<CookedLod> Lods;
+	};
+
+	// Prints what went wrong
+	static bool LoadSource(const AssetPack& assets, const char* fName, AssetData& source);
+	static const aiScene* ImportScene(Assimp::Importer& importer, const AssetData& source, const char* fName, const ImportProfile& profile);
+
+	static CookedMaterial ReadMaterial(const aiScene* scene, const aiMesh* mesh);
+	static void ReadIndices(const aiMesh* mesh, std::vector<std::uint32_t>& indices);
+	static Bounds ReadBounds(const aiMesh* mesh);
+
+	static void OptimizeIndices(const aiMesh* mesh, const CookedMaterial& material, const ImportProfile& profile, std::vector<std::uint32_t>& indices, MeshReport& report);
+	// Adds every LOD after the full detail indices that are already there
+	static void BuildLods(const aiMesh* mesh, const ImportProfile& profile, std::vector<std::uint32_t>& indices, std::vector<CookedLod>& lods, MeshReport& report);
+	// Returns how many vertices are left
+	static std::size_t OptimizeVertices(void* vertices, std::size_t vertexSize, std::size_t vertexCount, std::vector<std::uint32_t>& indices, std::uint32_t fullDetailIndexCount, MeshReport& report);
+
+	static void PrintReport(const char* fName, const std::vector<MeshReport>& reports);
+	static void PrintLoaded(const char* fName, bool fromCache, const ImportProfile& profile, std::chrono::high_resolution_clock::time_point startTime);
+};
+
+template <typename VertexT>
+class ModelLoader : private ModelLoaderBase
+{
+	static_assert(std::is_trivially_copyable<VertexT>::value, "Vertices go into the mesh cache as plain bytes");
+	static_assert(std::is_standard_layout<VertexT>::value, "Attribute offsets come from offsetof");
+
+public:
+	using Traits = VertexTraits<VertexT>;
+	using MeshReport = ModelLoaderBase::MeshReport;
+
+	// From the mesh cache if it's up to date, otherwise with Assimp (and the cache gets
+	//  updated). Safe to call from several threads at once.
+	static bool Load(const AssetPack& assets, const char* fName, const ImportProfile& profile, std::vector<CookedMesh<VertexT>>& meshes)
+	{
+		auto startTime = std::chrono::high_resolution_clock::now();
+
+		// Needed even if the mesh cache is good, since that's how the cache knows it was
+		//  made from this exact file
+		AssetData source;
+		if (!LoadSource(assets, fName, source))
+		{
+			return false;
+		}
+
+		MeshCache cache(assets, fName, source, Traits::Name, profile);
+		bool fromCache = cache.Load(meshes);
+		if (!fromCache)
+		{
+			if (!Import(fName, source, profile, meshes))
+			{
+				return false;
+			}
+			cache.Save(meshes);
+		}
+
+		PrintLoaded(fName, fromCache, profile, startTime);
+		return true;
+	}
+
+	// The slow path: run the model through Assimp and convert what comes out
+	static bool Import(const char* fName, const AssetData& source, const ImportProfile& profile, std::vector<CookedMesh<VertexT>>& meshes)
+	{
+		Assimp::Importer importer;
+		const aiScene* scene = ImportScene(importer, source, fName, profile);
+		if (!scene)
+		{
+			return false;
+		}
+
+		// Every mesh is converted on its own, so they're spread out over the thread pool.
+		//  Each one writes straight into its own slot of meshes, so the order comes out
+		//  the same as in the file no matter which thread finishes first.
+		meshes.clear();
+		meshes.resize(scene->mNumMeshes);
+		std::vector<MeshReport> reports(scene->mNumMeshes);
+		ThreadPool::Shared().ParallelFor(scene->mNumMeshes, [scene, &profile, &meshes, &reports](std::size_t meshIdx) {
+			ConvertMesh(scene, scene->mMeshes[meshIdx], profile, meshes[meshIdx], reports[meshIdx]);
+		});
+
+		// Meshes with nothing to draw (see ConvertMesh) don't get a RenderCall at all
+		meshes.erase(std::remove_if(meshes.begin(), meshes.end(), [](const CookedMesh<VertexT>& mesh) { return mesh.Vertices.empty(); }), meshes.end());
+
+		if (profile.MeshStats)
+		{
+			PrintReport(fName, reports);
+		}
+
+		return true; // scene gets cleaned up along with importer
+	}
+
+	// Only reads from the scene and only writes to cooked, so any number of these can run
+	//  at the same time
+	static void ConvertMesh(const aiScene* scene, const aiMesh* mesh, const ImportProfile& profile, CookedMesh<VertexT>& cooked, MeshReport& report)
+	{
+		// FindDegenerates and SortByPType can leave a mesh with no triangles, or no vertices
+		//  at all - there's nothing to draw, and everything below starts from the first
+		//  vertex. It stays empty, and Import drops it.
+		if (mesh->mNumVertices == 0u || mesh->mNumFaces == 0u)
+		{
+			cooked = CookedMesh<VertexT>();
+			report = MeshReport();
+			return;
+		}
+
+		// Bounds first - compact positions are stored relative to them
+		cooked.LocalBounds = ReadBounds(mesh);
+		cooked.Vertices.resize(mesh->mNumVertices);
+		WriteLayout(mesh, PositionQuantization::FromBox(cooked.LocalBounds.Box), cooked.Vertices.data(), typename Traits::Layout());
+
+		cooked.Material = ReadMaterial(scene, mesh);
+		ReadIndices(mesh, cooked.Indices);
+		OptimizeIndices(mesh, cooked.Material, profile, cooked.Indices, report);
+		BuildLods(mesh, profile, cooked.Indices, cooked.Lods, report);
+		cooked.Vertices.resize(OptimizeVertices(cooked.Vertices.data(), sizeof(VertexT), cooked.Vertices.size(), cooked.Indices, cooked.Lods[0u].IndexCount, report));
+	}
+
+private:
+	template <typename... AttributeTs>
+	static void WriteLayout(const aiMesh* mesh, const PositionQuantization& quantization, VertexT* vertices, VertexLayout<AttributeTs...>)
+	{
+		(WriteAttribute<AttributeTs>(mesh, quantization, vertices), ...);
+	}
+
+	template <typename AttributeT>
+	static void WriteAttribute(const aiMesh* mesh, const PositionQuantization& quantization, VertexT* vertices)
+	{
+		constexpr std::size_t offset = AttributeT::Offset;
+		const std::uint32_t count = mesh->mNumVertices;
+		std::uint8_t* bytes = reinterpret_cast<std::uint8_t*>(vertices);
+
+		// Copied with memcpy so the compiler doesn't have to care how the vertex struct is
+		//  laid out - 8 or 12 byte memcpys compile down to a couple of plain moves anyways
+		if constexpr (AttributeT::Stream == VertexStream::Position)
+		{
+			static_assert(sizeof(aiVector3D) == 3u * sizeof(float), "aiVector3D should be three floats");
+			for (std::uint32_t i = 0u; i < count; i++)
+			{
+				memcpy(bytes + i * sizeof(VertexT) + offset, &mesh->mVertices[i], 3u * sizeof(float));
+			}
+		}
+		else if constexpr (AttributeT::Stream == VertexStream::Normal)
+		{
+			// Every import profile generates normals, but better zeros than a crash
+			if (mesh->mNormals == nullptr)
+			{
+				return;
+			}
+			for (std::uint32_t i = 0u; i < count; i++)
+			{
+				memcpy(bytes + i * sizeof(VertexT) + offset, &mesh->mNormals[i], 3u * sizeof(float));
+			}
+		}
+		else if constexpr (AttributeT::Stream == VertexStream::TexCoord0)
+		{
+			// No UVs means (0, 0) everywhere - the vertices start out zeroed
+			if (mesh->mTextureCoords[0] == nullptr)
+			{
+				return;
+			}
+			for (std::uint32_t i = 0u; i < count; i++)
+			{
+				memcpy(bytes + i * sizeof(VertexT) + offset, &mesh->mTextureCoords[0][i], 2u * sizeof(float));
+			}
+		}
+		else if constexpr (AttributeT::Stream == VertexStream::PositionUnorm16)
+		{
+			QuantizePositions(&mesh->mVertices[0].x, sizeof(aiVector3D), count, quantization, bytes + offset, sizeof(VertexT));
+		}
+		else if constexpr (AttributeT::Stream == VertexStream::NormalOct16)
+		{
+			if (mesh->mNormals == nullptr)
+			{
+				return;
+			}
+			EncodeOctahedralNormals(&mesh->mNormals[0].x, sizeof(aiVector3D), count, bytes + offset, sizeof(VertexT));
+		}
+		else if constexpr (AttributeT::Stream == VertexStream::TexCoord0Half)
+		{
+			// Zeroed vertices are (0, 0) as halfs too
+			if (mesh->mTextureCoords[0] == nullptr)
+			{
+				return;
+			}
+			EncodeHalf2(&mesh->mTextureCoords[0][0].x, sizeof(aiVector3D), count, bytes + offset, sizeof(VertexT));
+		}
+		else
+		{
+			const float value = (AttributeT::Stream == VertexStream::One) ? 1.f : 0.f;
+			for (std::uint32_t i = 0u; i < count; i++)
+			{
+				memcpy(bytes + i * sizeof(VertexT) + offset, &value, sizeof(float));
+			}
+		}
+	}
+};
+
+};
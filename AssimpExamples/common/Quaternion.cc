@@ -1,77 +1,184 @@
+// Batch quaternion kernels. Everything for working with a single quaternion lives in
+//  the header - this file is only for chewing through whole arrays of them at once.
+
 #include <Quaternion.h>
-#include <algorithm>
-#include <math.h>
+#include <Simd.h>
 
 namespace sess
 {
 
-const Quaternion Quaternion::Identity = Quaternion(0.f, 0.f, 0.f, 1.f);
-
-// Unit quaternion: Arbitrary axis, angle of 0
-Quaternion::Quaternion() : x(0.f), y(0.f), z(0.f), w(1.f)
-{}
+namespace
+{
 
-Quaternion::Quaternion(Vec3 axis, float angle)
-	: w(cosf(angle / 2.f))
-	, x(sinf(angle / 2.f) * axis.x)
-	, y(sinf(angle / 2.f) * axis.y)
-	, z(sinf(angle / 2.f) * axis.z)
+#if defined(SESS_SSE)
+// Loads four quaternions and transposes them, so each register holds one component
+//  (all four x's, all four y's, ...). Quaternion is laid out x, y, z, w.
+inline void Load4(const Quaternion* q, __m128& x, __m128& y, __m128& z, __m128& w)
 {
-	Normalize();
+	x = _mm_loadu_ps(&q[0].x);
+	y = _mm_loadu_ps(&q[1].x);
+	z = _mm_loadu_ps(&q[2].x);
+	w = _mm_loadu_ps(&q[3].x);
+	_MM_TRANSPOSE4_PS(x, y, z, w);
 }
 
-Quaternion::Quaternion(float W, float X, float Y, float Z)
-	: w(W)
-	, x(X)
-	, y(Y)
-	, z(Z)
+inline void Store4(Quaternion* q, __m128 x, __m128 y, __m128 z, __m128 w)
 {
-	Normalize();
+	_MM_TRANSPOSE4_PS(x, y, z, w);
+	_mm_storeu_ps(&q[0].x, x);
+	_mm_storeu_ps(&q[1].x, y);
+	_mm_storeu_ps(&q[2].x, z);
+	_mm_storeu_ps(&q[3].x, w);
 }
 
-Quaternion Quaternion::Inverse() const
+inline __m128 Dot4(__m128 ax, __m128 ay, __m128 az, __m128 aw, __m128 bx, __m128 by, __m128 bz, __m128 bw)
 {
-	return Quaternion(-w, x, y, z);
+	__m128 d = _mm_mul_ps(ax, bx);
+	d = _mm_add_ps(d, _mm_mul_ps(ay, by));
+	d = _mm_add_ps(d, _mm_mul_ps(az, bz));
+	return _mm_add_ps(d, _mm_mul_ps(aw, bw));
 }
 
-Quaternion Quaternion::operator*(const Quaternion& o) const
+// Full precision sqrt and divide rather than _mm_rsqrt_ps - the approximate one is only
+//  good to about 12 bits, which is visible after a few frames of accumulated blending
+inline void Normalize4(__m128& x, __m128& y, __m128& z, __m128& w)
 {
-	// Multiplying two quaternions together has the effect of performing the
-	//  first rotation, and then performing the second.
-	return Quaternion(
-		o.w * w - o.x * x - o.y * y - o.z * z,
-		o.w * x + o.x * w - o.y * z + o.z * y,
-		o.w * y + o.x * z + o.y * w - o.z * x,
-		o.w * z - o.x * y + o.y * x + o.z * w);
+	__m128 len = _mm_sqrt_ps(Dot4(x, y, z, w, x, y, z, w));
+	x = _mm_div_ps(x, len);
+	y = _mm_div_ps(y, len);
+	z = _mm_div_ps(z, len);
+	w = _mm_div_ps(w, len);
 }
+#endif
 
-Quaternion& Quaternion::operator*=(const Quaternion& o)
+};
+
+void Quaternion::NlerpBatch(const Quaternion* a, const Quaternion* b, float ratio, Quaternion* out, std::size_t n, bool normalize)
 {
-	return *this = *this * o;
+	std::size_t i = 0u;
+
+#if defined(SESS_SSE)
+	const __m128 signBit = _mm_set1_ps(-0.f);
+	const __m128 ra = _mm_set1_ps(1.f - ratio);
+	const __m128 ratio4 = _mm_set1_ps(ratio);
+
+	for (; i + 4u <= n; i += 4u)
+	{
+		__m128 ax, ay, az, aw, bx, by, bz, bw;
+		Load4(a + i, ax, ay, az, aw);
+		Load4(b + i, bx, by, bz, bw);
+
+		// Shortest path: wherever the dot product is negative, negate b's weight
+		__m128 rb = _mm_xor_ps(ratio4, _mm_and_ps(Dot4(ax, ay, az, aw, bx, by, bz, bw), signBit));
+
+		__m128 x = _mm_add_ps(_mm_mul_ps(ax, ra), _mm_mul_ps(bx, rb));
+		__m128 y = _mm_add_ps(_mm_mul_ps(ay, ra), _mm_mul_ps(by, rb));
+		__m128 z = _mm_add_ps(_mm_mul_ps(az, ra), _mm_mul_ps(bz, rb));
+		__m128 w = _mm_add_ps(_mm_mul_ps(aw, ra), _mm_mul_ps(bw, rb));
+
+		if (normalize)
+		{
+			Normalize4(x, y, z, w);
+		}
+
+		Store4(out + i, x, y, z, w);
+	}
+#endif
+
+	for (; i < n; i++)
+	{
+		if (normalize)
+		{
+			out[i] = Nlerp(a[i], b[i], ratio);
+		}
+		else
+		{
+			float rb = Dot(a[i], b[i]) < 0.f ? -ratio : ratio;
+			float ra = 1.f - ratio;
+			out[i] = FromComponents(
+				a[i].w * ra + b[i].w * rb,
+				a[i].x * ra + b[i].x * rb,
+				a[i].y * ra + b[i].y * rb,
+				a[i].z * ra + b[i].z * rb);
+		}
+	}
 }
 
-// http://www.euclideanspace.com/maths/geometry/rotations/conversions/matrixToQuaternion/
-Quaternion Quaternion::FromMatrix(const Matrix & m)
+void Quaternion::SlerpBatch(const Quaternion* a, const Quaternion* b, float ratio, Quaternion* out, std::size_t n)
 {
-	float sx = Vec3(m._11, m._21, m._31).Magnitude();
-	float sy = Vec3(m._12, m._22, m._32).Magnitude();
-	float sz = Vec3(m._13, m._23, m._33).Magnitude();
+	std::size_t i = 0u;
+
+#if defined(SESS_SSE)
+	for (; i + 4u <= n; i += 4u)
+	{
+		__m128 ax, ay, az, aw, bx, by, bz, bw;
+		Load4(a + i, ax, ay, az, aw);
+		Load4(b + i, bx, by, bz, bw);
+
+		// SSE has no acos/sin, so the blend weights are worked out one lane at a time.
+		//  The loads, blend and normalize around them are still four-wide.
+		alignas(16) float d[4];
+		alignas(16) float wa[4];
+		alignas(16) float wb[4];
+		_mm_store_ps(d, Dot4(ax, ay, az, aw, bx, by, bz, bw));
+		for (int lane = 0; lane < 4; lane++)
+		{
+			float sign = d[lane] < 0.f ? -1.f : 1.f;
+			float cosTheta = d[lane] * sign;
+			if (cosTheta > 0.9995f)
+			{
+				wa[lane] = 1.f - ratio;
+				wb[lane] = ratio * sign;
+			}
+			else
+			{
+				float theta = acosf(cosTheta);
+				float invSinTheta = 1.f / sinf(theta);
+				wa[lane] = sinf((1.f - ratio) * theta) * invSinTheta;
+				wb[lane] = sinf(ratio * theta) * invSinTheta * sign;
+			}
+		}
+
+		__m128 ra = _mm_load_ps(wa);
+		__m128 rb = _mm_load_ps(wb);
 
-	float w = sqrtf(std::max(0.f, 1.f + m._11 / sx + m._22 / sy + m._33 / sz)) / 2.f;
-	float x = copysignf(sqrtf(std::max(0.f, 1.f + m._11 / sx - m._22 / sy - m._33 / sz)) / 2.f, m._32 - m._23);
-	float y = copysignf(sqrtf(std::max(0.f, 1.f - m._11 / sx + m._22 / sy - m._33 / sz)) / 2.f, m._13 - m._31);
-	float z = copysignf(sqrtf(std::max(0.f, 1.f - m._11 / sx - m._22 / sy + m._33 / sz)) / 2.f, m._21 - m._12);
+		__m128 x = _mm_add_ps(_mm_mul_ps(ax, ra), _mm_mul_ps(bx, rb));
+		__m128 y = _mm_add_ps(_mm_mul_ps(ay, ra), _mm_mul_ps(by, rb));
+		__m128 z = _mm_add_ps(_mm_mul_ps(az, ra), _mm_mul_ps(bz, rb));
+		__m128 w = _mm_add_ps(_mm_mul_ps(aw, ra), _mm_mul_ps(bw, rb));
 
-	return Quaternion(w, x, y, z);
+		// Only the nlerp fallback lanes really need this, but it's cheaper to do all
+		//  four than to pick them out
+		Normalize4(x, y, z, w);
+
+		Store4(out + i, x, y, z, w);
+	}
+#endif
+
+	for (; i < n; i++)
+	{
+		out[i] = Slerp(a[i], b[i], ratio);
+	}
 }
 
-void Quaternion::Normalize()
+void Quaternion::NormalizeAll(Quaternion* q, std::size_t n)
 {
-	float mag = sqrt(x * x + w * w + y * y + z * z);
-	x /= mag;
-	y /= mag;
-	z /= mag;
-	w /= mag;
+	std::size_t i = 0u;
+
+#if defined(SESS_SSE)
+	for (; i + 4u <= n; i += 4u)
+	{
+		__m128 x, y, z, w;
+		Load4(q + i, x, y, z, w);
+		Normalize4(x, y, z, w);
+		Store4(q + i, x, y, z, w);
+	}
+#endif
+
+	for (; i < n; i++)
+	{
+		q[i].Normalize();
+	}
 }
 
-};
\ No newline at end of file
+};
@@ -8,6 +8,10 @@
 #include <Vec3.h>
 #include <Matrix.h>
 
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
 namespace sess
 {
 
@@ -17,23 +21,149 @@ public:
 	float x, y, z, w;
 
 public:
-	Quaternion();
-	Quaternion(Vec3 axis, float angle);
-	Quaternion(float w, float x, float y, float z);
+	// Unit quaternion: Arbitrary axis, angle of 0
+	constexpr Quaternion() noexcept : x(0.f), y(0.f), z(0.f), w(1.f) {}
+
+	Quaternion(Vec3 axis, float angle) noexcept
+		: x(sinf(angle / 2.f) * axis.x)
+		, y(sinf(angle / 2.f) * axis.y)
+		, z(sinf(angle / 2.f) * axis.z)
+		, w(cosf(angle / 2.f))
+	{
+		Normalize();
+	}
+
+	Quaternion(float W, float X, float Y, float Z) noexcept
+		: x(X)
+		, y(Y)
+		, z(Z)
+		, w(W)
+	{
+		Normalize();
+	}
+
 	Quaternion(const Quaternion&) = default;
 	~Quaternion() = default;
 
-	Quaternion Inverse() const;
+	// Builds a quaternion straight from its components, without normalizing. Only use this
+	//  when they're already unit length, or when they'll be normalized later anyways -
+	//  blending a bunch of rotations together and normalizing once at the end, for example.
+	static constexpr Quaternion FromComponents(float w, float x, float y, float z) noexcept
+	{
+		return Quaternion(RawTag(), w, x, y, z);
+	}
+
+	static constexpr float Dot(const Quaternion& a, const Quaternion& b) noexcept
+	{
+		return a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w;
+	}
+
+	Quaternion Inverse() const noexcept
+	{
+		// Flipping a unit quaternion around doesn't change its length, no need to normalize
+		return FromComponents(-w, x, y, z);
+	}
+
+	Quaternion operator*(const Quaternion& o) const noexcept
+	{
+		// Multiplying two quaternions together has the effect of performing the
+		//  first rotation, and then performing the second.
+		return Quaternion(
+			o.w * w - o.x * x - o.y * y - o.z * z,
+			o.w * x + o.x * w - o.y * z + o.z * y,
+			o.w * y + o.x * z + o.y * w - o.z * x,
+			o.w * z - o.x * y + o.y * x + o.z * w);
+	}
+
+	Quaternion& operator*=(const Quaternion& o) noexcept
+	{
+		return *this = *this * o;
+	}
+
+	// http://www.euclideanspace.com/maths/geometry/rotations/conversions/matrixToQuaternion/
+	static Quaternion FromMatrix(const Matrix& m) noexcept
+	{
+		float sx = Vec3(m._11, m._21, m._31).Magnitude();
+		float sy = Vec3(m._12, m._22, m._32).Magnitude();
+		float sz = Vec3(m._13, m._23, m._33).Magnitude();
+
+		float w = sqrtf(std::max(0.f, 1.f + m._11 / sx + m._22 / sy + m._33 / sz)) / 2.f;
+		float x = copysignf(sqrtf(std::max(0.f, 1.f + m._11 / sx - m._22 / sy - m._33 / sz)) / 2.f, m._32 - m._23);
+		float y = copysignf(sqrtf(std::max(0.f, 1.f - m._11 / sx + m._22 / sy - m._33 / sz)) / 2.f, m._13 - m._31);
+		float z = copysignf(sqrtf(std::max(0.f, 1.f - m._11 / sx - m._22 / sy + m._33 / sz)) / 2.f, m._21 - m._12);
 
-	Quaternion operator*(const Quaternion&) const;
-	Quaternion& operator*=(const Quaternion&);
+		return Quaternion(w, x, y, z);
+	}
 
-	static Quaternion FromMatrix(const Matrix& m);
+	// Normalized linear interpolation - blend the components, then normalize once.
+	//  A ratio of 0 gives a, 1 gives b. Not constant speed like Slerp, but close enough
+	//  for small angles (animation keyframes, pose blending) and way cheaper.
+	// Both versions take the short way around: q and -q are the same rotation, so if the
+	//  two are more than 180 degrees apart on the 4D sphere, b gets flipped first.
+	static Quaternion Nlerp(const Quaternion& a, const Quaternion& b, float ratio) noexcept
+	{
+		float rb = Dot(a, b) < 0.f ? -ratio : ratio;
+		float ra = 1.f - ratio;
+
+		return Quaternion(
+			a.w * ra + b.w * rb,
+			a.x * ra + b.x * rb,
+			a.y * ra + b.y * rb,
+			a.z * ra + b.z * rb);
+	}
+
+	// Spherical linear interpolation - constant angular speed from a to b
+	static Quaternion Slerp(const Quaternion& a, const Quaternion& b, float ratio) noexcept
+	{
+		float d = Dot(a, b);
+		float sign = d < 0.f ? -1.f : 1.f;
+		d *= sign;
+
+		// Nearly the same rotation - sin(theta) is about zero, so fall back to nlerp
+		if (d > 0.9995f)
+		{
+			return Nlerp(a, b, ratio);
+		}
+
+		float theta = acosf(d);
+		float invSinTheta = 1.f / sinf(theta);
+		float ra = sinf((1.f - ratio) * theta) * invSinTheta;
+		float rb = sinf(ratio * theta) * invSinTheta * sign;
+
+		return FromComponents(
+			a.w * ra + b.w * rb,
+			a.x * ra + b.x * rb,
+			a.y * ra + b.y * rb,
+			a.z * ra + b.z * rb);
+	}
+
+	// Batch versions of the above, out[i] = Nlerp(a[i], b[i], ratio) etc. - four
+	//  quaternions at a time with SSE. out may alias a or b.
+	// NlerpBatch can skip the normalize (normalize = false) if the results are going to be
+	//  blended again; call NormalizeAll once on the final result instead.
+	static void NlerpBatch(const Quaternion* a, const Quaternion* b, float ratio, Quaternion* out, std::size_t n, bool normalize = true);
+	static void SlerpBatch(const Quaternion* a, const Quaternion* b, float ratio, Quaternion* out, std::size_t n);
+	static void NormalizeAll(Quaternion* q, std::size_t n);
 
 	static const Quaternion Identity;
 
 protected:
-	void Normalize();
+	void Normalize() noexcept
+	{
+		float mag = sqrtf(x * x + w * w + y * y + z * z);
+		x /= mag;
+		y /= mag;
+		z /= mag;
+		w /= mag;
+	}
+
+private:
+	struct RawTag {};
+	constexpr Quaternion(RawTag, float W, float X, float Y, float Z) noexcept
+		: x(X), y(Y), z(Z), w(W)
+	{}
 };
 
-};
\ No newline at end of file
+inline constexpr Quaternion Quaternion::Identity = Quaternion();
+
+};
@@ -0,0 +1,21 @@
+#pragma once
+
+// Decides which vector instruction sets the math code is allowed to use.
+// SSE2 is guaranteed on every x64 processor, so it's on by default there. AVX is
+//  only used if the compiler was told it can use it (/arch:AVX or -mavx).
+// Define SESS_NO_SIMD to force the plain C++ versions of everything - handy for
+//  checking the vectorized code against, or for building somewhere that isn't x86.
+
+#if !defined(SESS_NO_SIMD) && (defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__))
+#define SESS_SSE 1
+#endif
+
+#if defined(SESS_SSE) && defined(__AVX__)
+#define SESS_AVX 1
+#endif
+
+#if defined(SESS_AVX)
+#include <immintrin.h>
+#elif defined(SESS_SSE)
+#include <emmintrin.h>
+#endif
@@ -0,0 +1,155 @@
+#include <ThreadPool.h>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+namespace sess
+{
+
+namespace
+{
+
+// Everything one ParallelFor call shares with the workers helping it out. It's reference
+//  counted because a worker can pick up its task after the caller already finished every
+//  index by itself and returned.
+struct ParallelJob
+{
+	ParallelJob(std::size_t count, const std::function<void(std::size_t)>& fn)
+		: Count(count), Fn(fn), NextIndex(0u), Finished(0u)
+	{}
+
+	const std::size_t Count;
+	const std::function<void(std::size_t)>& Fn; // Only touched while Finished < Count, so the caller is still waiting
+	std::atomic<std::size_t> NextIndex;
+	std::atomic<std::size_t> Finished;
+
+	std::mutex DoneMutex;
+	std::condition_variable Done;
+
+	// Grab indices one at a time until there are none left. One at a time keeps things
+	//  balanced when some indices are much more work than others (one huge mesh and a
+	//  hundred small ones, say).
+	void Work()
+	{
+		std::size_t idx;
+		while ((idx = NextIndex.fetch_add(1u)) < Count)
+		{
+			Fn(idx);
+			if (Finished.fetch_add(1u) + 1u == Count)
+			{
+				std::lock_guard<std::mutex> lock(DoneMutex);
+				Done.notify_all();
+			}
+		}
+	}
+};
+
+};
+
+ThreadPool::ThreadPool(unsigned int threadCount)
+	: stopping_(false)
+{
+	if (threadCount == 0u)
+	{
+		unsigned int cores = std::thread::hardware_concurrency();
+		threadCount = (cores > 1u) ? cores - 1u : 0u;
+	}
+
+	threads_.reserve(threadCount);
+	for (unsigned int i = 0u; i < threadCount; i++)
+	{
+		threads_.emplace_back([this] { WorkerLoop(); });
+	}
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		stopping_ = true;
+	}
+	wake_.notify_all();
+
+	for (auto&& thread : threads_)
+	{
+		thread.join();
+	}
+}
+
+void ThreadPool::ParallelFor(std::size_t count, const std::function<void(std::size_t)>& fn)
+{
+	if (count == 0u)
+	{
+		return;
+	}
+
+	// Not worth waking anybody up for
+	if (count == 1u || threads_.empty())
+	{
+		for (std::size_t i = 0u; i < count; i++)
+		{
+			fn(i);
+		}
+		return;
+	}
+
+	auto job = std::make_shared<ParallelJob>(count, fn);
+
+	std::size_t helpers = std::min<std::size_t>(threads_.size(), count - 1u);
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		for (std::size_t i = 0u; i < helpers; i++)
+		{
+			tasks_.push_back([job] { job->Work(); });
+		}
+	}
+	if (helpers == 1u)
+	{
+		wake_.notify_one();
+	}
+	else
+	{
+		wake_.notify_all();
+	}
+
+	// Pitch in instead of just waiting around. This is also what makes nested calls safe -
+	//  even if every worker is busy, the caller can always finish the job by itself.
+	job->Work();
+
+	std::unique_lock<std::mutex> lock(job->DoneMutex);
+	job->Done.wait(lock, [&job] { return job->Finished.load() == job->Count; });
+}
+
+unsigned int ThreadPool::GetThreadCount() const
+{
+	return static_cast<unsigned int>(threads_.size());
+}
+
+ThreadPool& ThreadPool::Shared()
+{
+	static ThreadPool pool;
+	return pool;
+}
+
+void ThreadPool::WorkerLoop()
+{
+	for (;;)
+	{
+		std::function<void()> task;
+		{
+			std::unique_lock<std::mutex> lock(mutex_);
+			wake_.wait(lock, [this] { return stopping_ || !tasks_.empty(); });
+			if (tasks_.empty())
+			{
+				return; // Stopping, and nothing left to do
+			}
+			task = std::move(tasks_.front());
+			tasks_.pop_front();
+		}
+
+		task();
+	}
+}
+
+};
@@ -0,0 +1,53 @@
+#pragma once
+
+// A handful of worker threads that stick around, so that splitting a job up doesn't mean
+//  starting (and stopping) a bunch of threads every single time.
+// std::async is great for "go do this one big thing in the background" (the shaders use it
+//  to load their bytecode), but for "do these 300 small things as fast as possible" the
+//  cost of a new thread per thing adds up quickly.
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace sess
+{
+
+class ThreadPool
+{
+public:
+	// 0 threads means one less than the number of cores - the thread calling ParallelFor
+	//  does work too, so that keeps every core busy without oversubscribing
+	explicit ThreadPool(unsigned int threadCount = 0u);
+	ThreadPool(const ThreadPool&) = delete;
+	~ThreadPool();
+
+	// Calls fn(i) once for every i < count and returns when all of them are done. Calls can
+	//  happen in any order and on any thread (including this one), so fn should only ever
+	//  write to things that belong to index i - then the results come out in the same
+	//  order no matter how the work got split up.
+	// Safe to call from several threads at once, and from inside another ParallelFor.
+	void ParallelFor(std::size_t count, const std::function<void(std::size_t)>& fn);
+
+	unsigned int GetThreadCount() const;
+
+	// One pool for the whole program, made the first time it's asked for
+	static ThreadPool& Shared();
+
+private:
+	void WorkerLoop();
+
+private:
+	std::vector<std::thread> threads_;
+
+	std::mutex mutex_;
+	std::condition_variable wake_;
+	std::deque<std::function<void()>> tasks_;
+	bool stopping_;
+};
+
+};
@@ -7,6 +7,7 @@
 //  and reason about code in this format.
 // Is it faster or slower? No clue. I actually haven't profiled it.
 
+#include <Affine3x4.h>
 #include <MathExtras.h>
 
 namespace sess
@@ -20,26 +21,107 @@ public:
 	Vec3 Scale;
 
 public:
-	Transform();
-	Transform(const Vec3& pos, const Quaternion& rot, const Vec3& scale);
+	constexpr Transform() noexcept
+		: Position(0.f, 0.f, 0.f)
+		, Rotation()
+		, Scale(1.f, 1.f, 1.f)
+	{}
+
+	constexpr Transform(const Vec3& pos, const Quaternion& rotation, const Vec3& scale) noexcept
+		: Position(pos)
+		, Rotation(rotation)
+		, Scale(scale)
+	{}
+
 	Transform(const Transform&) = default;
 	~Transform() = default;
 
 	// Combine two transformations together
-	Transform operator*(const Transform& rhs) const;
+	Transform operator*(const Transform& o) const noexcept
+	{
+		// Apply first this transformation, and then the next transformation.
+		return Transform(
+			Position + Vec3::ComponentProduct(o.Position * Rotation, Scale),
+			Rotation * o.Rotation,
+			Vec3::ComponentProduct(Scale, o.Scale)
+			);
+	}
+
+	Matrix GetTransformMatrix() const noexcept
+	{
+		return GetAffineMatrix().ToMatrix();
+	}
+
+	// Same thing without the 0 0 0 1 bottom row - this is what the shaders take
+	Affine3x4 GetAffineMatrix() const noexcept
+	{
+		return Affine3x4(
+			Scale.x * (1.f - 2.f * Rotation.y * Rotation.y - 2.f * Rotation.z * Rotation.z),
+			Scale.y * (2.f * Rotation.x * Rotation.y - 2.f * Rotation.z * Rotation.w),
+			Scale.z * (2.f * Rotation.x * Rotation.z + 2.f * Rotation.y * Rotation.w),
+			Position.x,
+
+			Scale.x * (2.f * Rotation.x * Rotation.y + 2.f * Rotation.z * Rotation.w),
+			Scale.y * (1.f - 2.f * Rotation.x * Rotation.x - 2.f * Rotation.z * Rotation.z),
+			Scale.z * (2.f * Rotation.y * Rotation.z - 2.f * Rotation.x * Rotation.w),
+			Position.y,
+
+			Scale.x * (2.f * Rotation.x * Rotation.z - 2.f * Rotation.y * Rotation.w),
+			Scale.y * (2.f * Rotation.y * Rotation.z + 2.f * Rotation.x * Rotation.w),
+			Scale.z * (1.f - 2.f * Rotation.x * Rotation.x - 2.f * Rotation.y * Rotation.y),
+			Position.z);
+	}
+
+	Transform Inverse() const noexcept
+	{
+		return Transform({ -Position, Rotation.Inverse(), Vec3(1.f / Scale.x, 1.f / Scale.y, 1.f / Scale.z) });
+	}
 
-	Matrix GetTransformMatrix() const;
-	Transform Inverse() const;
-	static Transform FromTransformMatrix(const Matrix& m);
+	static Transform FromTransformMatrix(const Matrix& m) noexcept
+	{
+		Vec3 pos(m._14, m._24, m._34);
+
+		// To find rotation, perform a rotation on a special vector.
+		// Where M is the transformation matrix, R is the rotation
+		//  and S is the scale
+		// t = {1, 1, 1}
+		// t' = Mt = RSt
+		// t x t' = a (axis of rotation)
+		// norm(t) * norm(t') = cos(theta) (angle of rotation)
+		//  R can be composed from axis and angle of rotation
+		// RSt = t'
+		// St = R^(-1)t'
+
+		float sx = Vec3(m._11, m._21, m._31).Magnitude();
+		float sy = Vec3(m._12, m._22, m._32).Magnitude();
+		float sz = Vec3(m._13, m._23, m._33).Magnitude();
+
+		// http://stackoverflow.com/questions/1171849/finding-quaternion-representing-the-rotation-from-one-vector-to-another
+		Quaternion rotation = Quaternion::FromMatrix(m);
+
+		Vec3 scale = Vec3(sx, sy, sz);
+
+		return Transform(pos, rotation, scale);
+	}
 
 	// Interpolate between the two transformations. A ratio of 0 means use t1,
 	//  a ratio of 1 means t2, and something in the middle means mix the two.
 	// 0.25 means use 25% of t1, and 75% of t2, for example.
 	// Position and scale interpolated linearly, rotation interpolated spherically
-	static Transform Lerp(const Transform& t1, const Transform& t2, float ratio);
+	static Transform Lerp(const Transform& t1, const Transform& t2, float ratio) noexcept
+	{
+		// TODO SESS: Might not be accurate enough, use Slerp for quaternions
+		return Transform(
+			t1.Position * (1.f - ratio) + t2.Position * ratio,
+			Quaternion::Nlerp(t1.Rotation, t2.Rotation, ratio),
+			t1.Scale * (1.f - ratio) + t2.Scale * ratio
+			);
+	}
 
 public:
 	const static Transform Identity;
 };
 
-};
\ No newline at end of file
+inline constexpr Transform Transform::Identity = Transform();
+
+};
@@ -0,0 +1,227 @@
+#include <TransformSoA.h>
+#include <Simd.h>
+
+#include <algorithm>
+
+namespace sess
+{
+
+void TransformSoA::Reserve(std::size_t capacity)
+{
+	for (auto* lane : { &px_, &py_, &pz_, &rx_, &ry_, &rz_, &rw_, &sx_, &sy_, &sz_ })
+	{
+		lane->reserve(capacity);
+	}
+}
+
+void TransformSoA::Clear()
+{
+	for (auto* lane : { &px_, &py_, &pz_, &rx_, &ry_, &rz_, &rw_, &sx_, &sy_, &sz_ })
+	{
+		lane->clear();
+	}
+}
+
+std::size_t TransformSoA::Size() const
+{
+	return px_.size();
+}
+
+std::size_t TransformSoA::Add(const Transform& t)
+{
+	px_.push_back(t.Position.x);
+	py_.push_back(t.Position.y);
+	pz_.push_back(t.Position.z);
+	rx_.push_back(t.Rotation.x);
+	ry_.push_back(t.Rotation.y);
+	rz_.push_back(t.Rotation.z);
+	rw_.push_back(t.Rotation.w);
+	sx_.push_back(t.Scale.x);
+	sy_.push_back(t.Scale.y);
+	sz_.push_back(t.Scale.z);
+
+	return px_.size() - 1u;
+}
+
+void TransformSoA::Set(std::size_t idx, const Transform& t)
+{
+	px_[idx] = t.Position.x;
+	py_[idx] = t.Position.y;
+	pz_[idx] = t.Position.z;
+	rx_[idx] = t.Rotation.x;
+	ry_[idx] = t.Rotation.y;
+	rz_[idx] = t.Rotation.z;
+	rw_[idx] = t.Rotation.w;
+	sx_[idx] = t.Scale.x;
+	sy_[idx] = t.Scale.y;
+	sz_[idx] = t.Scale.z;
+}
+
+Transform TransformSoA::Get(std::size_t idx) const
+{
+	return Transform(
+		Vec3(px_[idx], py_[idx], pz_[idx]),
+		Quaternion::FromComponents(rw_[idx], rx_[idx], ry_[idx], rz_[idx]),
+		Vec3(sx_[idx], sy_[idx], sz_[idx]));
+}
+
+namespace
+{
+
+// The math from Transform::GetTransformMatrix, written once against a tiny set of
+//  operations so the same code works on a float, an SSE register or an AVX register.
+// Produces the top three rows of the matrix (the bottom one is always 0 0 0 1)
+template <typename Ops>
+inline void ComputeRows(
+	const float* px, const float* py, const float* pz,
+	const float* rx, const float* ry, const float* rz, const float* rw,
+	const float* sx, const float* sy, const float* sz,
+	typename Ops::V (&rows)[3][4])
+{
+	using V = typename Ops::V;
+
+	V x = Ops::Load(rx), y = Ops::Load(ry), z = Ops::Load(rz), w = Ops::Load(rw);
+	V scaleX = Ops::Load(sx), scaleY = Ops::Load(sy), scaleZ = Ops::Load(sz);
+	V one = Ops::Set1(1.f), two = Ops::Set1(2.f);
+
+	V x2 = Ops::Mul(two, x);
+	V y2 = Ops::Mul(two, y);
+	V z2 = Ops::Mul(two, z);
+
+	rows[0][0] = Ops::Mul(scaleX, Ops::Sub(Ops::Sub(one, Ops::Mul(y2, y)), Ops::Mul(z2, z)));
+	rows[0][1] = Ops::Mul(scaleY, Ops::Sub(Ops::Mul(x2, y), Ops::Mul(z2, w)));
+	rows[0][2] = Ops::Mul(scaleZ, Ops::Add(Ops::Mul(x2, z), Ops::Mul(y2, w)));
+	rows[0][3] = Ops::Load(px);
+
+	rows[1][0] = Ops::Mul(scaleX, Ops::Add(Ops::Mul(x2, y), Ops::Mul(z2, w)));
+	rows[1][1] = Ops::Mul(scaleY, Ops::Sub(Ops::Sub(one, Ops::Mul(x2, x)), Ops::Mul(z2, z)));
+	rows[1][2] = Ops::Mul(scaleZ, Ops::Sub(Ops::Mul(y2, z), Ops::Mul(x2, w)));
+	rows[1][3] = Ops::Load(py);
+
+	rows[2][0] = Ops::Mul(scaleX, Ops::Sub(Ops::Mul(x2, z), Ops::Mul(y2, w)));
+	rows[2][1] = Ops::Mul(scaleY, Ops::Add(Ops::Mul(y2, z), Ops::Mul(x2, w)));
+	rows[2][2] = Ops::Mul(scaleZ, Ops::Sub(Ops::Sub(one, Ops::Mul(x2, x)), Ops::Mul(y2, y)));
+	rows[2][3] = Ops::Load(pz);
+}
+
+struct ScalarOps
+{
+	using V = float;
+	static V Load(const float* p) { return *p; }
+	static V Set1(float f) { return f; }
+	static V Add(V a, V b) { return a + b; }
+	static V Sub(V a, V b) { return a - b; }
+	static V Mul(V a, V b) { return a * b; }
+};
+
+#if defined(SESS_SSE)
+struct SSEOps
+{
+	using V = __m128;
+	static V Load(const float* p) { return _mm_loadu_ps(p); }
+	static V Set1(float f) { return _mm_set1_ps(f); }
+	static V Add(V a, V b) { return _mm_add_ps(a, b); }
+	static V Sub(V a, V b) { return _mm_sub_ps(a, b); }
+	static V Mul(V a, V b) { return _mm_mul_ps(a, b); }
+};
+#endif
+
+#if defined(SESS_AVX)
+struct AVXOps
+{
+	using V = __m256;
+	static V Load(const float* p) { return _mm256_loadu_ps(p); }
+	static V Set1(float f) { return _mm256_set1_ps(f); }
+	static V Add(V a, V b) { return _mm256_add_ps(a, b); }
+	static V Sub(V a, V b) { return _mm256_sub_ps(a, b); }
+	static V Mul(V a, V b) { return _mm256_mul_ps(a, b); }
+};
+
+// _MM_TRANSPOSE4_PS, but on both 128-bit halves of the registers at once
+inline void Transpose4InLanes(__m256& r0, __m256& r1, __m256& r2, __m256& r3)
+{
+	__m256 t0 = _mm256_unpacklo_ps(r0, r1);
+	__m256 t1 = _mm256_unpacklo_ps(r2, r3);
+	__m256 t2 = _mm256_unpackhi_ps(r0, r1);
+	__m256 t3 = _mm256_unpackhi_ps(r2, r3);
+	r0 = _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(1, 0, 1, 0));
+	r1 = _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(3, 2, 3, 2));
+	r2 = _mm256_shuffle_ps(t2, t3, _MM_SHUFFLE(1, 0, 1, 0));
+	r3 = _mm256_shuffle_ps(t2, t3, _MM_SHUFFLE(3, 2, 3, 2));
+}
+#endif
+
+};
+
+void TransformSoA::ComputeMatrices(Matrix* out, std::size_t count) const
+{
+	count = std::min(count, Size());
+	std::size_t i = 0u;
+
+#if defined(SESS_SSE)
+	const __m128 lastRow = _mm_setr_ps(0.f, 0.f, 0.f, 1.f);
+#endif
+
+#if defined(SESS_AVX)
+	for (; i + 8u <= count; i += 8u)
+	{
+		__m256 rows[3][4];
+		ComputeRows<AVXOps>(&px_[i], &py_[i], &pz_[i], &rx_[i], &ry_[i], &rz_[i], &rw_[i], &sx_[i], &sy_[i], &sz_[i], rows);
+
+		// Each register holds one matrix element for 8 transforms. After transposing,
+		//  register k holds a matrix row for transform k (low half) and k + 4 (high half)
+		for (int row = 0; row < 3; row++)
+		{
+			Transpose4InLanes(rows[row][0], rows[row][1], rows[row][2], rows[row][3]);
+			for (int k = 0; k < 4; k++)
+			{
+				_mm_store_ps(out[i + k].m[row], _mm256_castps256_ps128(rows[row][k]));
+				_mm_store_ps(out[i + k + 4u].m[row], _mm256_extractf128_ps(rows[row][k], 1));
+			}
+		}
+
+		for (int k = 0; k < 4; k++)
+		{
+			_mm_store_ps(out[i + k].m[3], lastRow);
+			_mm_store_ps(out[i + k + 4u].m[3], lastRow);
+		}
+	}
+#endif
+
+#if defined(SESS_SSE)
+	for (; i + 4u <= count; i += 4u)
+	{
+		__m128 rows[3][4];
+		ComputeRows<SSEOps>(&px_[i], &py_[i], &pz_[i], &rx_[i], &ry_[i], &rz_[i], &rw_[i], &sx_[i], &sy_[i], &sz_[i], rows);
+
+		for (int row = 0; row < 3; row++)
+		{
+			_MM_TRANSPOSE4_PS(rows[row][0], rows[row][1], rows[row][2], rows[row][3]);
+			for (int k = 0; k < 4; k++)
+			{
+				_mm_store_ps(out[i + k].m[row], rows[row][k]);
+			}
+		}
+
+		for (int k = 0; k < 4; k++)
+		{
+			_mm_store_ps(out[i + k].m[3], lastRow);
+		}
+	}
+#endif
+
+	// Whatever is left over (or everything, without SIMD)
+	for (; i < count; i++)
+	{
+		float rows[3][4];
+		ComputeRows<ScalarOps>(&px_[i], &py_[i], &pz_[i], &rx_[i], &ry_[i], &rz_[i], &rw_[i], &sx_[i], &sy_[i], &sz_[i], rows);
+
+		out[i] = Matrix(
+			rows[0][0], rows[0][1], rows[0][2], rows[0][3],
+			rows[1][0], rows[1][1], rows[1][2], rows[1][3],
+			rows[2][0], rows[2][1], rows[2][2], rows[2][3],
+			0.f, 0.f, 0.f, 1.f);
+	}
+}
+
+};
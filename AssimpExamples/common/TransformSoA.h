@@ -0,0 +1,46 @@
+#pragma once
+
+// A big pile of transforms, stored structure-of-arrays style: every component
+//  (position x, position y, ..., scale z) gets its own contiguous array.
+// A single Transform is nicer to work with, but converting tens of thousands of them
+//  to matrices one at a time is slow. Laid out like this, 4 (SSE) or 8 (AVX) of them
+//  can be converted at once, since lane N of every register is just transform N.
+
+#include <Transform.h>
+
+#include <cstddef>
+#include <vector>
+
+namespace sess
+{
+
+class TransformSoA
+{
+public:
+	TransformSoA() = default;
+	TransformSoA(const TransformSoA&) = default;
+	~TransformSoA() = default;
+
+	void Reserve(std::size_t capacity);
+	void Clear();
+	std::size_t Size() const;
+
+	// Returns the index of the newly added transform
+	std::size_t Add(const Transform& t);
+	void Set(std::size_t idx, const Transform& t);
+	Transform Get(std::size_t idx) const;
+
+	// Same result as calling GetTransformMatrix on each of the first count transforms,
+	//  written to out[0..count). The arithmetic is done in the same order, so it's bit for
+	//  bit the same unless the compiler fuses the scalar version's multiply-adds into FMAs
+	//  (same as Matrix.h) - then expect up to 1 ulp of difference per element.
+	// A count past Size() only gets Size() matrices.
+	void ComputeMatrices(Matrix* out, std::size_t count) const;
+
+private:
+	std::vector<float> px_, py_, pz_;
+	std::vector<float> rx_, ry_, rz_, rw_;
+	std::vector<float> sx_, sy_, sz_;
+};
+
+};
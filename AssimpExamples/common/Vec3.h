@@ -3,6 +3,10 @@
 // 3D vector class, does all the 3D vector things
 // May represent either a point or a direction
 // May be transformed by various other components
+// Everything is defined right here in the header so the compiler can inline it -
+//  these get called per-vertex, and an out-of-line call for a three float add is silly.
+
+#include <cmath>
 
 namespace sess
 {
@@ -13,26 +17,87 @@ public:
 	float x, y, z;
 
 public:
-	Vec3();
-	Vec3(float x, float y, float z);
+	constexpr Vec3() noexcept : x(0.f), y(0.f), z(0.f) {}
+	constexpr Vec3(float xx, float yy, float zz) noexcept : x(xx), y(yy), z(zz) {}
 	Vec3(const Vec3&) = default;
 	~Vec3() = default;
 
-	Vec3 operator+(const Vec3&) const;
-	Vec3 operator-(const Vec3&) const;
-	Vec3 operator-() const;
-	Vec3 operator*(float) const;
+	constexpr Vec3 operator+(const Vec3& o) const noexcept
+	{
+		return Vec3(x + o.x, y + o.y, z + o.z);
+	}
+
+	constexpr Vec3 operator-(const Vec3& o) const noexcept
+	{
+		return Vec3(x - o.x, y - o.y, z - o.z);
+	}
+
+	constexpr Vec3 operator-() const noexcept
+	{
+		return Vec3(-x, -y, -z);
+	}
+
+	constexpr Vec3 operator*(float s) const noexcept
+	{
+		return Vec3(x * s, y * s, z * s);
+	}
+
+	constexpr Vec3& operator+=(const Vec3& o) noexcept
+	{
+		x += o.x;
+		y += o.y;
+		z += o.z;
+		return *this;
+	}
+
+	constexpr Vec3& operator-=(const Vec3& o) noexcept
+	{
+		x -= o.x;
+		y -= o.y;
+		z -= o.z;
+		return *this;
+	}
 
-	Vec3& operator+=(const Vec3&);
-	Vec3& operator-=(const Vec3&);
-	Vec3& operator*=(float);
+	constexpr Vec3& operator*=(float s) noexcept
+	{
+		x *= s;
+		y *= s;
+		z *= s;
+		return *this;
+	}
 
-	static float Dot(const Vec3&, const Vec3&);
-	static Vec3 Cross(const Vec3&, const Vec3&);
-	static Vec3 ComponentProduct(const Vec3&, const Vec3&);
+	static constexpr float Dot(const Vec3& _1, const Vec3& _2) noexcept
+	{
+		return
+			_1.x * _2.x +
+			_1.y * _2.y +
+			_1.z * _2.z;
+	}
 
-	float Magnitude() const;
-	Vec3 Normal() const;
+	static constexpr Vec3 Cross(const Vec3& _1, const Vec3& _2) noexcept
+	{
+		return Vec3(
+			_1.y * _2.z - _1.z * _2.y,
+			_1.z * _2.x - _1.x * _2.z,
+			_1.x * _2.y - _1.y * _2.x
+			);
+	}
+
+	static constexpr Vec3 ComponentProduct(const Vec3& l, const Vec3& r) noexcept
+	{
+		return Vec3(l.x * r.x, l.y * r.y, l.z * r.z);
+	}
+
+	// Not constexpr - sqrtf isn't, at least not until C++26
+	float Magnitude() const noexcept
+	{
+		return sqrtf(x * x + y * y + z * z);
+	}
+
+	Vec3 Normal() const noexcept
+	{
+		return *this * (1.f / Magnitude());
+	}
 
 public:
 	const static Vec3 Zero;
@@ -42,4 +107,10 @@ public:
 	const static Vec3 UnitZ;
 };
 
-};
\ No newline at end of file
+inline constexpr Vec3 Vec3::Zero = Vec3(0.f, 0.f, 0.f);
+inline constexpr Vec3 Vec3::Ones = Vec3(1.f, 1.f, 1.f);
+inline constexpr Vec3 Vec3::UnitX = Vec3(1.f, 0.f, 0.f);
+inline constexpr Vec3 Vec3::UnitY = Vec3(0.f, 1.f, 0.f);
+inline constexpr Vec3 Vec3::UnitZ = Vec3(0.f, 0.f, 1.f);
+
+};
@@ -0,0 +1,137 @@
+#include <VectorStream.h>
+#include <Simd.h>
+
+namespace sess
+{
+
+namespace
+{
+
+// Rows of the 3x4 affine matrix every stream kernel boils down to:
+//  out = (m[0] . (in, 1), m[1] . (in, 1), m[2] . (in, 1))
+struct Affine
+{
+	float m[3][4];
+};
+
+// Same terms as Transform::GetTransformMatrix, with each column scaled by s
+Affine BuildAffine(const Quaternion& q, const Vec3& s, const Vec3& t)
+{
+	return Affine{ {
+		{ s.x * (1.f - 2.f * q.y * q.y - 2.f * q.z * q.z), s.y * (2.f * q.x * q.y - 2.f * q.z * q.w), s.z * (2.f * q.x * q.z + 2.f * q.y * q.w), t.x },
+		{ s.x * (2.f * q.x * q.y + 2.f * q.z * q.w), s.y * (1.f - 2.f * q.x * q.x - 2.f * q.z * q.z), s.z * (2.f * q.y * q.z - 2.f * q.x * q.w), t.y },
+		{ s.x * (2.f * q.x * q.z - 2.f * q.y * q.w), s.y * (2.f * q.y * q.z + 2.f * q.x * q.w), s.z * (1.f - 2.f * q.x * q.x - 2.f * q.y * q.y), t.z },
+	} };
+}
+
+#if defined(SESS_SSE)
+// Four Vec3s are exactly three registers worth of floats:
+//  a = x0 y0 z0 x1, b = y1 z1 x2 y2, c = z2 x3 y3 z3
+// These shuffle them into x0 x1 x2 x3 / y0 y1 y2 y3 / z0 z1 z2 z3 and back.
+inline void Deinterleave(__m128 a, __m128 b, __m128 c, __m128& x, __m128& y, __m128& z)
+{
+	__m128 bc = _mm_shuffle_ps(b, c, _MM_SHUFFLE(1, 1, 2, 2));
+	x = _mm_shuffle_ps(a, bc, _MM_SHUFFLE(2, 0, 3, 0));
+	y = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 1, 1)), _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 2, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+	z = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 2)), _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 3, 0, 0)), _MM_SHUFFLE(2, 0, 2, 0));
+}
+
+inline void Interleave(__m128 x, __m128 y, __m128 z, __m128& a, __m128& b, __m128& c)
+{
+	a = _mm_shuffle_ps(_mm_shuffle_ps(x, y, _MM_SHUFFLE(0, 0, 0, 0)), _mm_shuffle_ps(z, x, _MM_SHUFFLE(1, 1, 0, 0)), _MM_SHUFFLE(2, 0, 2, 0));
+	b = _mm_shuffle_ps(_mm_shuffle_ps(y, z, _MM_SHUFFLE(1, 1, 1, 1)), _mm_shuffle_ps(x, y, _MM_SHUFFLE(2, 2, 2, 2)), _MM_SHUFFLE(2, 0, 2, 0));
+	c = _mm_shuffle_ps(_mm_shuffle_ps(z, x, _MM_SHUFFLE(3, 3, 2, 2)), _mm_shuffle_ps(y, z, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+}
+#endif
+
+inline Vec3 Apply(const Affine& a, const Vec3& v, bool translate)
+{
+	Vec3 r(
+		a.m[0][0] * v.x + a.m[0][1] * v.y + a.m[0][2] * v.z,
+		a.m[1][0] * v.x + a.m[1][1] * v.y + a.m[1][2] * v.z,
+		a.m[2][0] * v.x + a.m[2][1] * v.y + a.m[2][2] * v.z);
+
+	if (translate)
+	{
+		r += Vec3(a.m[0][3], a.m[1][3], a.m[2][3]);
+	}
+
+	return r;
+}
+
+void ApplyStream(const Affine& a, const Vec3* in, Vec3* out, std::size_t n, bool translate, bool normalize)
+{
+	std::size_t i = 0u;
+
+#if defined(SESS_SSE)
+	__m128 m[3][4];
+	for (int r = 0; r < 3; r++)
+	{
+		for (int c = 0; c < 4; c++)
+		{
+			m[r][c] = _mm_set1_ps(a.m[r][c]);
+		}
+	}
+
+	for (; i + 4u <= n; i += 4u)
+	{
+		const float* src = &in[i].x;
+		__m128 x, y, z;
+		Deinterleave(_mm_loadu_ps(src), _mm_loadu_ps(src + 4), _mm_loadu_ps(src + 8), x, y, z);
+
+		__m128 res[3];
+		for (int r = 0; r < 3; r++)
+		{
+			res[r] = _mm_mul_ps(m[r][0], x);
+			res[r] = _mm_add_ps(res[r], _mm_mul_ps(m[r][1], y));
+			res[r] = _mm_add_ps(res[r], _mm_mul_ps(m[r][2], z));
+			if (translate)
+			{
+				res[r] = _mm_add_ps(res[r], m[r][3]);
+			}
+		}
+
+		if (normalize)
+		{
+			__m128 len = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(res[0], res[0]), _mm_mul_ps(res[1], res[1])), _mm_mul_ps(res[2], res[2])));
+			__m128 invLen = _mm_div_ps(_mm_set1_ps(1.f), len);
+			res[0] = _mm_mul_ps(res[0], invLen);
+			res[1] = _mm_mul_ps(res[1], invLen);
+			res[2] = _mm_mul_ps(res[2], invLen);
+		}
+
+		__m128 oa, ob, oc;
+		Interleave(res[0], res[1], res[2], oa, ob, oc);
+		float* dst = &out[i].x;
+		_mm_storeu_ps(dst, oa);
+		_mm_storeu_ps(dst + 4, ob);
+		_mm_storeu_ps(dst + 8, oc);
+	}
+#endif
+
+	for (; i < n; i++)
+	{
+		Vec3 r = Apply(a, in[i], translate);
+		out[i] = normalize ? r.Normal() : r;
+	}
+}
+
+};
+
+void RotateStream(const Quaternion& q, const Vec3* in, Vec3* out, std::size_t n)
+{
+	ApplyStream(BuildAffine(q, Vec3::Ones, Vec3::Zero), in, out, n, false, false);
+}
+
+void TransformStream(const Transform& t, const Vec3* in, Vec3* out, std::size_t n)
+{
+	ApplyStream(BuildAffine(t.Rotation, t.Scale, t.Position), in, out, n, true, false);
+}
+
+void TransformNormalStream(const Transform& t, const Vec3* in, Vec3* out, std::size_t n)
+{
+	Vec3 invScale(1.f / t.Scale.x, 1.f / t.Scale.y, 1.f / t.Scale.z);
+	ApplyStream(BuildAffine(t.Rotation, invScale, Vec3::Zero), in, out, n, false, true);
+}
+
+};
@@ -0,0 +1,28 @@
+#pragma once
+
+// Kernels for pushing whole arrays of vectors (vertex positions, normals) through
+//  the same rotation or transform. The rotation is turned into a 3x3 matrix once up
+//  front, then vectors go through four at a time with SSE - at that point the loop
+//  spends more time waiting on memory than doing math, which is the goal.
+// Results match the single-vector versions up to rounding (the matrix form of a
+//  quaternion rotation does its multiplies in a different order than Vec3 * Quaternion).
+// In all of these, out may be the same array as in.
+
+#include <Transform.h>
+
+#include <cstddef>
+
+namespace sess
+{
+
+// out[i] = in[i] * q
+void RotateStream(const Quaternion& q, const Vec3* in, Vec3* out, std::size_t n);
+
+// out[i] = t.GetTransformMatrix().TransformPoint(in[i]) - scale, then rotate, then translate
+void TransformStream(const Transform& t, const Vec3* in, Vec3* out, std::size_t n);
+
+// For normals: rotate, divide by scale instead of multiplying (the inverse transpose of
+//  the upper 3x3), skip the translation, and re-normalize. Only the direction survives.
+void TransformNormalStream(const Transform& t, const Vec3* in, Vec3* out, std::size_t n);
+
+};
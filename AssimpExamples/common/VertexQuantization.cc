@@ -0,0 +1,230 @@
+#include <VertexQuantization.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace sess
+{
+
+namespace
+{
+
+constexpr float UNORM16_MAX = 65535.f;
+constexpr float SNORM16_MAX = 32767.f;
+
+const float* FloatsAt(const float* base, std::size_t stride, std::size_t idx)
+{
+	return reinterpret_cast<const float*>(reinterpret_cast<const std::uint8_t*>(base) + idx * stride);
+}
+
+std::uint8_t* BytesAt(void* base, std::size_t stride, std::size_t idx)
+{
+	return reinterpret_cast<std::uint8_t*>(base) + idx * stride;
+}
+
+// Flat octahedron coordinates (-1..1 each) for a unit vector
+void ToOctahedron(const Vec3& n, float& x, float& y)
+{
+	float l1 = fabsf(n.x) + fabsf(n.y) + fabsf(n.z);
+	x = n.x / l1;
+	y = n.y / l1;
+
+	// The bottom half of the octahedron folds out over the corners of the square
+	if (n.z < 0.f)
+	{
+		float foldedX = (1.f - fabsf(y)) * (x >= 0.f ? 1.f : -1.f);
+		float foldedY = (1.f - fabsf(x)) * (y >= 0.f ? 1.f : -1.f);
+		x = foldedX;
+		y = foldedY;
+	}
+}
+
+}
+
+PositionQuantization PositionQuantization::FromBox(const AABB& box)
+{
+	Vec3 size = box.Max - box.Min;
+	float scale = std::max(size.x, std::max(size.y, size.z));
+
+	// A mesh that's a single point (or empty) still needs something to divide by
+	return PositionQuantization{ box.Min, scale > 0.f ? scale : 1.f };
+}
+
+void QuantizePosition(const Vec3& position, const PositionQuantization& quantization, std::uint16_t out[4])
+{
+	Vec3 local = (position - quantization.Offset) * (1.f / quantization.Scale);
+	out[0u] = static_cast<std::uint16_t>(std::clamp(local.x, 0.f, 1.f) * UNORM16_MAX + 0.5f);
+	out[1u] = static_cast<std::uint16_t>(std::clamp(local.y, 0.f, 1.f) * UNORM16_MAX + 0.5f);
+	out[2u] = static_cast<std::uint16_t>(std::clamp(local.z, 0.f, 1.f) * UNORM16_MAX + 0.5f);
+	out[3u] = 0xffffu;
+}
+
+Vec3 DecodePosition(const std::uint16_t in[4], const PositionQuantization& quantization)
+{
+	return quantization.Offset + Vec3(in[0u] / UNORM16_MAX, in[1u] / UNORM16_MAX, in[2u] / UNORM16_MAX) * quantization.Scale;
+}
+
+void EncodeOctahedral(const Vec3& normal, std::int16_t out[2])
+{
+	// No direction at all - any encoding is as good as any other
+	if (normal.x == 0.f && normal.y == 0.f && normal.z == 0.f)
+	{
+		out[0u] = 0;
+		out[1u] = static_cast<std::int16_t>(SNORM16_MAX);
+		return;
+	}
+
+	Vec3 unit = normal * (1.f / normal.Magnitude());
+	float x, y;
+	ToOctahedron(unit, x, y);
+
+	float baseX = floorf(x * SNORM16_MAX);
+	float baseY = floorf(y * SNORM16_MAX);
+	// Compared by distance rather than by dot product - the dot of two nearly equal unit
+	//  vectors is so close to 1 that floats can't tell the candidates apart
+	float bestDistance = 4.f;
+	for (std::uint32_t candidate = 0u; candidate < 4u; candidate++)
+	{
+		std::int16_t encoded[2] =
+		{
+			static_cast<std::int16_t>(std::clamp(baseX + (candidate & 1u), -SNORM16_MAX, SNORM16_MAX)),
+			static_cast<std::int16_t>(std::clamp(baseY + (candidate >> 1u), -SNORM16_MAX, SNORM16_MAX)),
+		};
+		Vec3 offBy = DecodeOctahedral(encoded) - unit;
+		float distance = Vec3::Dot(offBy, offBy);
+		if (distance < bestDistance)
+		{
+			bestDistance = distance;
+			out[0u] = encoded[0u];
+			out[1u] = encoded[1u];
+		}
+	}
+}
+
+Vec3 DecodeOctahedral(const std::int16_t in[2])
+{
+	// Same as the compact vertex shader - SNORM reads as value / 32767, with -32768 clamped
+	//  to -1. The fold is undone by pulling x and y back towards the middle by however far
+	//  under the square's diamond they were.
+	float x = std::max(in[0u] / SNORM16_MAX, -1.f);
+	float y = std::max(in[1u] / SNORM16_MAX, -1.f);
+	float z = 1.f - fabsf(x) - fabsf(y);
+	float t = std::max(-z, 0.f);
+	x += (x >= 0.f) ? -t : t;
+	y += (y >= 0.f) ? -t : t;
+
+	Vec3 n(x, y, z);
+	return n * (1.f / n.Magnitude());
+}
+
+std::uint16_t FloatToHalf(float value)
+{
+	std::uint32_t bits;
+	memcpy(&bits, &value, sizeof(bits));
+
+	std::uint32_t sign = (bits >> 16u) & 0x8000u;
+	std::uint32_t magnitude = bits & 0x7fffffffu;
+
+	// NaN stays NaN (quiet), infinity and anything too big for a half go to infinity
+	if (magnitude > 0x7f800000u)
+	{
+		return static_cast<std::uint16_t>(sign | 0x7e00u);
+	}
+	if (magnitude >= 0x477ff000u) // 65520 and up round to infinity
+	{
+		return static_cast<std::uint16_t>(sign | 0x7c00u);
+	}
+
+	// Too small even for a half denormal - rounds to 0. Half denormals are multiples of
+	//  2^-24, so the float gets lined up with that and rounded to an integer.
+	if (magnitude < 0x38800000u) // 2^-14, the smallest normal half
+	{
+		if (magnitude < 0x33000000u) // Under 2^-25, half of the smallest denormal
+		{
+			return static_cast<std::uint16_t>(sign);
+		}
+		std::uint32_t mantissa = (magnitude & 0x007fffffu) | 0x00800000u;
+		std::uint32_t shift = 126u - (magnitude >> 23u);
+		std::uint32_t halfMantissa = mantissa >> shift;
+		std::uint32_t remainder = mantissa & ((1u << shift) - 1u);
+		std::uint32_t halfway = 1u << (shift - 1u);
+		if (remainder > halfway || (remainder == halfway && (halfMantissa & 1u)))
+		{
+			halfMantissa++;
+		}
+		return static_cast<std::uint16_t>(sign | halfMantissa);
+	}
+
+	// Normal: rebias the exponent (127 -> 15) and round off the bottom 13 mantissa bits.
+	//  A carry out of the mantissa bumps the exponent, which is exactly right.
+	std::uint32_t half = (magnitude - 0x38000000u) >> 13u;
+	std::uint32_t remainder = magnitude & 0x1fffu;
+	if (remainder > 0x1000u || (remainder == 0x1000u && (half & 1u)))
+	{
+		half++;
+	}
+	return static_cast<std::uint16_t>(sign | half);
+}
+
+float HalfToFloat(std::uint16_t half)
+{
+	std::uint32_t sign = (half & 0x8000u) << 16u;
+	std::uint32_t exponent = (half >> 10u) & 0x1fu;
+	std::uint32_t mantissa = half & 0x3ffu;
+
+	std::uint32_t bits;
+	if (exponent == 0x1fu)
+	{
+		bits = sign | 0x7f800000u | (mantissa << 13u);
+	}
+	else if (exponent != 0u)
+	{
+		bits = sign | ((exponent + 112u) << 23u) | (mantissa << 13u);
+	}
+	else
+	{
+		// Denormal (or zero) - exactly mantissa * 2^-24, which a float holds without rounding
+		float value = mantissa * (1.f / 16777216.f);
+		memcpy(&bits, &value, sizeof(bits));
+		bits |= sign;
+	}
+
+	float value;
+	memcpy(&value, &bits, sizeof(value));
+	return value;
+}
+
+void QuantizePositions(const float* xyz, std::size_t inStride, std::size_t count, const PositionQuantization& quantization, void* out, std::size_t outStride)
+{
+	for (std::size_t i = 0u; i < count; i++)
+	{
+		const float* p = FloatsAt(xyz, inStride, i);
+		std::uint16_t encoded[4];
+		QuantizePosition(Vec3(p[0u], p[1u], p[2u]), quantization, encoded);
+		memcpy(BytesAt(out, outStride, i), encoded, sizeof(encoded));
+	}
+}
+
+void EncodeOctahedralNormals(const float* xyz, std::size_t inStride, std::size_t count, void* out, std::size_t outStride)
+{
+	for (std::size_t i = 0u; i < count; i++)
+	{
+		const float* n = FloatsAt(xyz, inStride, i);
+		std::int16_t encoded[2];
+		EncodeOctahedral(Vec3(n[0u], n[1u], n[2u]), encoded);
+		memcpy(BytesAt(out, outStride, i), encoded, sizeof(encoded));
+	}
+}
+
+void EncodeHalf2(const float* xy, std::size_t inStride, std::size_t count, void* out, std::size_t outStride)
+{
+	for (std::size_t i = 0u; i < count; i++)
+	{
+		const float* v = FloatsAt(xy, inStride, i);
+		std::uint16_t encoded[2] = { FloatToHalf(v[0u]), FloatToHalf(v[1u]) };
+		memcpy(BytesAt(out, outStride, i), encoded, sizeof(encoded));
+	}
+}
+
+};
@@ -0,0 +1,74 @@
+#pragma once
+
+// Compact vertex encodings - smaller vertices are fewer bytes to store, upload and fetch.
+//  A full precision position + normal + UV vertex is 40 bytes with the float4 padding the
+//  shaders want. With these it's 16:
+//  - Position: 4 x 16-bit UNORM (8 bytes). The mesh's bounding box gets stretched into a
+//    cube (so the scale is the same on every axis, and normals don't need fixing up) and
+//    every position is stored as where it is in the cube, 0 to 65535. w is always 65535,
+//    which the GPU reads as 1. Decoding back into model space is a translate and a uniform
+//    scale (PositionQuantization::ToAffine), which folds right into the model matrix.
+//  - Normal: octahedral, 2 x 16-bit SNORM (4 bytes). The unit sphere gets projected onto
+//    an octahedron, which unfolds flat into a square - so a direction is 2 numbers, and
+//    they're spread pretty evenly over the sphere (Cigolle et al., "A Survey of Efficient
+//    Representations for Independent Unit Vectors").
+//  - UV: 2 x 16-bit float (4 bytes)
+//
+// Error bounds (checked in checks/VertexQuantizationCheck.cc against the Decode* functions,
+//  which do the same math the GPU does reading these formats):
+//  - Position: half a step, Scale / 131070 on each axis (give or take float rounding) -
+//    7.6 micrometers per meter of model size. The road (the biggest model in the demos)
+//    is well under 100 units across.
+//  - Normal: under 0.005 degrees off the original direction
+//  - UV: 2^-11 relative (11 significant bits), so at most 1/4096 for UVs in 0..1 - a
+//    quarter of a texel on a 1024 texture. UVs that tile far outside 0..1 lose more.
+
+#include <Affine3x4.h>
+#include <Bounds.h>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace sess
+{
+
+// Cube positions get quantized in, from the mesh's bounding box
+struct PositionQuantization
+{
+	Vec3 Offset; // The min corner of the box
+	float Scale; // The largest side of the box - a position of 65535 on an axis is Offset + Scale
+
+	static PositionQuantization FromBox(const AABB& box);
+
+	// Takes quantized positions (as the 0..1 the GPU reads them as) back to model space
+	Affine3x4 ToAffine() const
+	{
+		return Affine3x4(
+			Scale, 0.f, 0.f, Offset.x,
+			0.f, Scale, 0.f, Offset.y,
+			0.f, 0.f, Scale, Offset.z);
+	}
+};
+
+// One at a time, for whoever needs them (and tests)
+void QuantizePosition(const Vec3& position, const PositionQuantization& quantization, std::uint16_t out[4]);
+Vec3 DecodePosition(const std::uint16_t in[4], const PositionQuantization& quantization);
+
+// Picks whichever of the (up to) four nearest encodings decodes closest to the original,
+//  instead of just rounding - rounding x and y separately isn't always the closest point
+//  once it's folded back onto the sphere. normal doesn't have to be unit length.
+void EncodeOctahedral(const Vec3& normal, std::int16_t out[2]);
+Vec3 DecodeOctahedral(const std::int16_t in[2]);
+
+// Round to nearest even, like the hardware - too big becomes infinity, too small becomes 0
+std::uint16_t FloatToHalf(float value);
+float HalfToFloat(std::uint16_t half);
+
+// Whole streams at once, for the loader. Reads 3 (or 2) floats every inStride bytes and
+//  writes the encoded value every outStride bytes - so a vertex buffer can be filled in
+//  straight from an aiMesh's arrays.
+void QuantizePositions(const float* xyz, std::size_t inStride, std::size_t count, const PositionQuantization& quantization, void* out, std::size_t outStride);
+void EncodeOctahedralNormals(const float* xyz, std::size_t inStride, std::size_t count, void* out, std::size_t outStride);
+void EncodeHalf2(const float* xy, std::size_t inStride, std::size_t count, void* out, std::size_t outStride);
+
+};
@@ -0,0 +1,53 @@
+#pragma once
+
+// Vertex traits - a description of a shader's Vertex struct that ModelLoader (see
+//  ModelLoader.h) uses to fill it in straight from an aiMesh.
+// Every attribute says where in the vertex it lives and which aiMesh stream it comes from.
+//  The loader copies one stream at a time over the whole mesh, so there's no per-vertex
+//  "does this vertex type have UVs?" - that's all decided at compile time.
+//
+// To give a new shader's Vertex a loader, specialize VertexTraits for it next to the shader:
+//  template <>
+//  struct VertexTraits<MyShader::Vertex>
+//  {
+//      static constexpr const char* Name = "MyShader::Vertex"; // Goes into the mesh cache hash
+//      using Layout = VertexLayout<
+//          VertexAttribute<VertexStream::Position, offsetof(MyShader::Vertex, Position)>,
+//          VertexAttribute<VertexStream::TexCoord0, offsetof(MyShader::Vertex, UV)>>;
+//  };
+
+#include <cstddef>
+
+namespace sess
+{
+
+enum class VertexStream
+{
+	Position, // 3 floats, aiMesh::mVertices
+	Normal, // 3 floats, aiMesh::mNormals
+	TexCoord0, // 2 floats, aiMesh::mTextureCoords[0] (u, v)
+	One, // 1 float, always 1 - padding that turns a position into a float4 with w = 1
+	Zero, // 1 float, always 0 - same, for directions
+
+	// Compact versions of the above (see VertexQuantization.h)
+	PositionUnorm16, // 4 uint16s, in the mesh's quantization cube - w is always 1 when read as UNORM
+	NormalOct16, // 2 int16s, octahedral
+	TexCoord0Half, // 2 half floats (u, v)
+};
+
+template <VertexStream StreamT, std::size_t OffsetT>
+struct VertexAttribute
+{
+	static constexpr VertexStream Stream = StreamT;
+	static constexpr std::size_t Offset = OffsetT; // Bytes from the start of the vertex
+};
+
+template <typename... AttributeTs>
+struct VertexLayout
+{};
+
+// No default - a vertex type without a specialization doesn't get a loader
+template <typename VertexT>
+struct VertexTraits;
+
+};
@@ -0,0 +1,74 @@
+#pragma once
+
+// One bit per object: set if the object should be drawn this frame.
+// Filled in by the culling code (see Frustum.h) and read by the render loop. Bits
+//  are packed 64 to a word, so even thousands of objects fit in a couple of cache lines.
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace sess
+{
+
+class VisibilitySet
+{
+public:
+	VisibilitySet() = default;
+	VisibilitySet(const VisibilitySet&) = default;
+	~VisibilitySet() = default;
+
+	// Changes the number of objects tracked, and marks all of them hidden
+	void Reset(std::size_t count)
+	{
+		count_ = count;
+		words_.assign((count + 63u) / 64u, 0ull);
+	}
+
+	std::size_t Size() const { return count_; }
+
+	bool IsVisible(std::size_t idx) const
+	{
+		return (words_[idx / 64u] >> (idx % 64u)) & 1ull;
+	}
+
+	void SetVisible(std::size_t idx, bool visible)
+	{
+		std::uint64_t bit = 1ull << (idx % 64u);
+		if (visible)
+		{
+			words_[idx / 64u] |= bit;
+		}
+		else
+		{
+			words_[idx / 64u] &= ~bit;
+		}
+	}
+
+	// ORs in up to 8 bits at once, starting at idx. The culling loops produce results
+	//  8 (or 4) objects at a time and always start on a multiple of that, so the bits
+	//  never straddle two words.
+	void SetBits(std::size_t idx, std::uint32_t bits)
+	{
+		words_[idx / 64u] |= (std::uint64_t)bits << (idx % 64u);
+	}
+
+	std::size_t CountVisible() const
+	{
+		std::size_t count = 0u;
+		for (std::uint64_t word : words_)
+		{
+			for (; word; word &= word - 1u)
+			{
+				count++;
+			}
+		}
+		return count;
+	}
+
+private:
+	std::vector<std::uint64_t> words_;
+	std::size_t count_ = 0u;
+};
+
+};
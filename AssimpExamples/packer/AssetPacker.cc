@@ -0,0 +1,120 @@
+// Asset packer - builds the pack file the demos load their assets from (see AssetPack.h).
+//  asset-packer [--compress .ext,.ext...] OUTPUT FILE...
+// Every FILE gets packed under its path with the leading ../ taken off, so run it from a
+//  folder next to assets/ and cso/ (like this one) and "../assets/road.fbx" ends up as
+//  "assets/road.fbx" - which is exactly what the demos ask for.
+// Files with one of the --compress extensions get zlib'd, if that makes them any smaller.
+// No Win32 or D3D needed - build with the Makefile in this folder.
+
+#include <AssetPack.h>
+#include <MappedFile.h>
+
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+using namespace sess;
+
+std::vector<std::string> SplitList(const char* list)
+{
+	std::vector<std::string> items;
+	std::string item;
+	for (const char* c = list; ; c++)
+	{
+		if (*c == ',' || *c == '\0')
+		{
+			if (!item.empty())
+			{
+				items.push_back(AssetPack::NormalizeName(item.c_str()));
+			}
+			item.clear();
+			if (*c == '\0')
+			{
+				break;
+			}
+		}
+		else
+		{
+			item.push_back(*c);
+		}
+	}
+	return items;
+}
+
+bool EndsWith(const std::string& str, const std::string& suffix)
+{
+	return str.size() >= suffix.size() && str.compare(str.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+int Usage()
+{
+	std::cerr << "Usage: asset-packer [--compress .ext,.ext...] OUTPUT FILE..." << std::endl;
+	return 1;
+}
+
+};
+
+int main(int argc, char** argv)
+{
+	std::vector<std::string> compressExtensions;
+	int arg = 1;
+	if (arg < argc && strcmp(argv[arg], "--compress") == 0)
+	{
+		if (arg + 1 >= argc)
+		{
+			return Usage();
+		}
+		compressExtensions = SplitList(argv[arg + 1]);
+		arg += 2;
+	}
+
+	if (arg + 1 >= argc)
+	{
+		return Usage();
+	}
+	const char* output = argv[arg++];
+
+	AssetPackWriter writer;
+	std::size_t totalSize = 0u;
+	for (; arg < argc; arg++)
+	{
+		const char* fName = argv[arg];
+		MappedFile file;
+		if (!file.Open(fName, MappedFile::Access::Sequential))
+		{
+			std::cerr << "Could not open " << fName << std::endl;
+			return 1;
+		}
+
+		std::string name = AssetPack::NormalizeName(fName);
+		AssetPack::Compression compression = AssetPack::Compression::None;
+		for (auto&& extension : compressExtensions)
+		{
+			if (EndsWith(name, extension))
+			{
+				compression = AssetPack::Compression::Zlib;
+			}
+		}
+
+		std::vector<std::uint8_t> data(file.GetData(), file.GetData() + file.GetSize());
+		if (!writer.Add(fName, std::move(data), compression))
+		{
+			return 1;
+		}
+
+		std::cout << "  " << name << " (" << file.GetSize() << " bytes)" << std::endl;
+		totalSize += file.GetSize();
+	}
+
+	if (!writer.Write(output))
+	{
+		return 1;
+	}
+
+	std::cout << "Packed " << totalSize << " bytes into " << output << std::endl;
+	return 0;
+}